@@ -0,0 +1,108 @@
+#define ALICE_NO_ENTRY_POINT 1
+#include "main.cpp"
+
+// Runs the simulation without a window, with every nation controlled by the AI, and reports how fast it went. The final
+// checksum can be compared between runs to check that an optimization has not changed the outcome of the simulation.
+
+static sys::state game_state; // too big for the stack
+
+static void discard_ui_queues(sys::state& state) {
+	// nothing is reading these without the ui, so they would eventually fill up
+	while(state.new_messages.front())
+		state.new_messages.pop();
+	while(state.new_requests.front())
+		state.new_requests.pop();
+	while(state.new_n_event.front())
+		state.new_n_event.pop();
+	while(state.new_f_n_event.front())
+		state.new_f_n_event.pop();
+	while(state.new_p_event.front())
+		state.new_p_event.pop();
+	while(state.new_f_p_event.front())
+		state.new_f_p_event.pop();
+	while(state.naval_battle_reports.front())
+		state.naval_battle_reports.pop();
+	while(state.land_battle_reports.front())
+		state.land_battle_reports.pop();
+}
+
+int main(int argc, char** argv) {
+	if(argc <= 1) {
+		std::printf("Usage: %s [scenario] [-save file] [-days count]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	native_string save_file;
+	int32_t days = 365;
+	for(int i = 2; i < argc; ++i) {
+		if(std::string_view(argv[i]) == "-save") {
+			if(i + 1 < argc) {
+				save_file = simple_fs::utf8_to_native(argv[i + 1]);
+				i++;
+			}
+		} else if(std::string_view(argv[i]) == "-days") {
+			if(i + 1 < argc) {
+				days = std::max(std::atoi(argv[i + 1]), 1);
+				i++;
+			}
+		}
+	}
+
+	add_root(game_state.common_fs, NATIVE("."));
+
+	auto load_start = std::chrono::steady_clock::now();
+	if(!sys::try_read_scenario_and_save_file(game_state, simple_fs::utf8_to_native(argv[1]))) {
+		std::printf("Scenario file %s could not be read\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+	if(!save_file.empty()) {
+		game_state.preload();
+		if(!sys::try_read_save_file(game_state, save_file)) {
+			std::printf("Save file %s could not be read\n", simple_fs::native_to_utf8(save_file).c_str());
+			return EXIT_FAILURE;
+		}
+	}
+	game_state.fill_unsaved_data();
+	auto load_end = std::chrono::steady_clock::now();
+
+	// observe as the rebels, like the spectate console command, so that every real nation is left to the ai
+	for(auto n : game_state.world.in_nation)
+		game_state.world.nation_set_is_player_controlled(n, false);
+	game_state.local_player_nation = game_state.national_definitions.rebel_id;
+	game_state.user_settings.autosaves = sys::autosave_frequency::none;
+	game_state.mode = sys::game_mode_type::in_game;
+
+	tick_profile::reset();
+	auto start = std::chrono::steady_clock::now();
+	for(int32_t i = 0; i < days; ++i) {
+		game_state.single_game_tick();
+		discard_ui_queues(game_state);
+		if(game_state.mode == sys::game_mode_type::end_screen) {
+			days = i;
+			break;
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	auto load_seconds = std::chrono::duration<double>(load_end - load_start).count();
+	auto seconds = std::chrono::duration<double>(end - start).count();
+	auto ymd = game_state.current_date.to_ymd(game_state.start_date);
+	std::printf("Loaded in %.3f s\n", load_seconds);
+	std::printf("Simulated %d days in %.3f s (%.2f days/s), ending on %d.%d.%d\n", int(days), seconds,
+		seconds > 0.0 ? double(days) / seconds : 0.0, int(ymd.year), int(ymd.month), int(ymd.day));
+
+	std::printf("%-40s %12s %8s %10s %10s %10s\n", "phase", "total (ms)", "calls", "p50 (us)", "p99 (us)", "max (us)");
+	auto summaries = tick_profile::summarize();
+	std::sort(summaries.begin(), summaries.end(), [](auto const& a, auto const& b) { return a.total > b.total; });
+	for(auto& s : summaries) {
+		std::printf("%-40s %12.3f %8u %10u %10u %10u\n", s.name, double(s.total) / 1000.0, s.calls, s.p50, s.p99, s.max);
+	}
+
+	auto key = game_state.get_save_checksum();
+	std::printf("Checksum: ");
+	for(uint32_t i = 0; i < sys::checksum_key::key_size; ++i)
+		std::printf("%02x", uint32_t(key.key[i]));
+	std::printf("\n");
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,110 @@
+#define ALICE_NO_ENTRY_POINT 1
+#include "main.cpp"
+#include "script_inspection.cpp" // only the tool and the tests carry the inspector, not the game
+#include "trigger_profiler.hpp"
+
+// Disassembles the triggers, effects and value modifiers of a scenario and estimates how much work one evaluation of each
+// does, given how many objects the iterating scopes visit in this scenario. Scripts over the limit are reported, and make the
+// tool exit with a failure, so that it can be used to check a mod before it is played.
+
+static sys::state game_state; // too big for the stack
+
+struct inspected_script {
+	char const* kind = "";
+	int32_t index = 0;
+	script_inspection::cost_estimate cost;
+	std::string const* owner = nullptr;
+};
+
+static std::string const no_owner = "(unused)";
+
+static std::string const& owner_of(std::vector<std::string> const& owners, int32_t index) {
+	if(size_t(index) < owners.size() && !owners[index].empty())
+		return owners[index];
+	return no_owner;
+}
+
+int main(int argc, char** argv) {
+	if(argc <= 1) {
+		std::printf("Usage: %s [scenario] [-limit evaluations] [-all]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	double limit = 100000.0;
+	bool list_all = false;
+	for(int i = 2; i < argc; ++i) {
+		if(std::string_view(argv[i]) == "-limit") {
+			if(i + 1 < argc) {
+				limit = std::max(std::atof(argv[i + 1]), 1.0);
+				i++;
+			}
+		} else if(std::string_view(argv[i]) == "-all") {
+			list_all = true;
+		}
+	}
+
+	add_root(game_state.common_fs, NATIVE("."));
+	if(!sys::try_read_scenario_and_save_file(game_state, simple_fs::utf8_to_native(argv[1]))) {
+		std::printf("Scenario file %s could not be read\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+	game_state.fill_unsaved_data();
+
+	auto sizes = script_inspection::measure_sizes(game_state);
+	std::printf("Average fan-out of the iterating scopes in this scenario:\n");
+	std::printf("  nations %.1f, great powers %.1f, provinces per nation %.1f, states per nation %.1f, provinces per state %.1f\n",
+		sizes.nations, sizes.great_powers, sizes.provinces_per_nation, sizes.states_per_nation, sizes.provinces_per_state);
+	std::printf("  province neighbors %.1f, nation neighbors %.1f, pops per province %.1f, pops per state %.1f, pops per nation %.1f\n",
+		sizes.province_neighbors, sizes.nation_neighbors, sizes.pops_per_province, sizes.pops_per_state, sizes.pops_per_nation);
+	std::printf("  cores per province %.1f, cores per nation %.1f, substates %.1f, sphere members %.1f, war participants %.1f\n",
+		sizes.cores_per_province, sizes.cores_per_nation, sizes.substates_per_nation, sizes.sphere_members, sizes.war_participants);
+	std::printf("  provinces per state definition %.1f, provinces per region %.1f\n\n", sizes.provinces_per_state_definition,
+		sizes.provinces_per_region);
+
+	auto trigger_owners = trigger_profile::trigger_owners(game_state);
+	auto effect_owners = script_inspection::effect_owners(game_state);
+	auto value_modifier_owners = script_inspection::value_modifier_owners(game_state);
+
+	std::vector<inspected_script> scripts;
+	auto const trigger_count = game_state.trigger_data_indices.empty() ? int32_t(0) : int32_t(game_state.trigger_data_indices.size() - 1);
+	for(int32_t i = 0; i < trigger_count; ++i) {
+		auto data = game_state.trigger_data.data() + game_state.trigger_data_indices[i + 1];
+		scripts.push_back(inspected_script{ "trigger", i, script_inspection::estimate_trigger_cost(game_state, sizes, data), &owner_of(trigger_owners, i) });
+	}
+	auto const effect_count = game_state.effect_data_indices.empty() ? int32_t(0) : int32_t(game_state.effect_data_indices.size() - 1);
+	for(int32_t i = 0; i < effect_count; ++i) {
+		auto data = game_state.effect_data.data() + game_state.effect_data_indices[i + 1];
+		scripts.push_back(inspected_script{ "effect", i, script_inspection::estimate_effect_cost(game_state, sizes, data), &owner_of(effect_owners, i) });
+	}
+	for(int32_t i = 0; i < int32_t(game_state.value_modifiers.size()); ++i) {
+		auto key = dcon::value_modifier_key{ dcon::value_modifier_key::value_base_t(i) };
+		scripts.push_back(inspected_script{ "value modifier", i, script_inspection::estimate_value_modifier_cost(game_state, sizes, key), &owner_of(value_modifier_owners, i) });
+	}
+	std::stable_sort(scripts.begin(), scripts.end(), [](auto const& a, auto const& b) { return a.cost.evaluations > b.cost.evaluations; });
+
+	int32_t flagged = 0;
+	for(auto& s : scripts) {
+		bool const over_limit = s.cost.evaluations > limit;
+		if(over_limit)
+			++flagged;
+		if(!over_limit && !list_all)
+			continue;
+
+		std::printf("%s %s %d: %.0f evaluations, %d iterating scopes, nested %d deep\n", over_limit ? "OVER LIMIT" : "ok", s.kind, int(s.index),
+			s.cost.evaluations, int(s.cost.iterating_scopes), int(s.cost.deepest_nesting));
+		std::printf("  used by: %s\n", s.owner->c_str());
+		std::string listing;
+		if(std::string_view(s.kind) == "trigger") {
+			listing = script_inspection::disassemble_trigger(game_state, game_state.trigger_data.data() + game_state.trigger_data_indices[s.index + 1]);
+		} else if(std::string_view(s.kind) == "effect") {
+			listing = script_inspection::disassemble_effect(game_state, game_state.effect_data.data() + game_state.effect_data_indices[s.index + 1]);
+		} else {
+			listing = script_inspection::disassemble_value_modifier(game_state, dcon::value_modifier_key{ dcon::value_modifier_key::value_base_t(s.index) });
+		}
+		std::printf("%s\n", listing.c_str());
+	}
+
+	std::printf("%d triggers, %d effects and %d value modifiers inspected; %d over the limit of %.0f evaluations\n", int(trigger_count),
+		int(effect_count), int(game_state.value_modifiers.size()), int(flagged), limit);
+	return flagged == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
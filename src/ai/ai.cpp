@@ -792,6 +792,7 @@ void update_focuses(sys::state& state) {
 }
 
 void take_ai_decisions(sys::state& state) {
+	trigger::memoization_window memo{ state };
 	for(auto d : state.world.in_decision) {
 		auto e = d.get_effect();
 		if(!e)
@@ -812,7 +813,7 @@ void take_ai_decisions(sys::state& state) {
 					? (trigger::evaluate(state, allow, trigger::to_generic(ids), trigger::to_generic(ids), 0) && (state.world.nation_get_owned_province_count(ids) != 0)) && filter_a
 					: ve::mask_vector{ filter_a } && (state.world.nation_get_owned_province_count(ids) != 0);
 				ve::mask_vector filter_b = ai_will_do
-					? filter_c && (trigger::evaluate_multiplicative_modifier(state, ai_will_do, trigger::to_generic(ids), trigger::to_generic(ids), 0) > 0.0f)
+					? filter_c && (trigger::evaluate_multiplicative_modifier(state, ai_will_do, trigger::to_generic(ids), trigger::to_generic(ids), 0, filter_c) > 0.0f)
 					: filter_c;
 
 				ve::apply([&](dcon::nation_id n, bool passed_filter) {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include "dcon_generated.hpp"
 
@@ -133,6 +134,33 @@ struct modifier_hash {
 	}
 };
 
+// a run of trigger or effect bytecode, as a key of the table used to intern it while the scenario is being built
+struct bytecode_span {
+	int32_t start = 0;
+	int32_t size = 0;
+};
+
+struct bytecode_span_hash {
+	using is_avalanching = void;
+
+	std::vector<uint16_t>& data;
+
+	bytecode_span_hash(std::vector<uint16_t>& data) : data(data) { }
+
+	auto operator()(bytecode_span s) const noexcept -> uint64_t {
+		return ankerl::unordered_dense::detail::wyhash::hash(data.data() + s.start, sizeof(uint16_t) * size_t(s.size));
+	}
+};
+struct bytecode_span_eq {
+	std::vector<uint16_t>& data;
+
+	bytecode_span_eq(std::vector<uint16_t>& data) : data(data) { }
+
+	bool operator()(bytecode_span l, bytecode_span r) const noexcept {
+		return l.size == r.size && std::equal(data.data() + l.start, data.data() + l.start + l.size, data.data() + r.start);
+	}
+};
+
 struct crisis_join_offer {
 	dcon::nation_id target;
 	dcon::state_definition_id wargoal_state;
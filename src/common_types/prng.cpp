@@ -43,6 +43,59 @@ random_pair get_random_pair(sys::state const& state, uint32_t value_in_hi, uint3
 
 	return random_pair{(uint64_t(r[0]) << 32) | uint64_t(r[1]), (uint64_t(r[2]) << 32) | uint64_t(r[3])};
 }
+namespace {
+
+constexpr uint32_t lane_group = 8;
+
+// Philox4x32 with the default number of rounds, as in get_random, for lane_group counters {date, value_in, 0, 0}
+void philox_lane_group(uint32_t date, uint32_t seed, uint32_t const* values_in, uint32_t* out) {
+	uint32_t c0[lane_group];
+	uint32_t c1[lane_group];
+	uint32_t c2[lane_group];
+	uint32_t c3[lane_group];
+	for(uint32_t j = 0; j < lane_group; ++j) {
+		c0[j] = date;
+		c1[j] = values_in[j];
+		c2[j] = 0;
+		c3[j] = 0;
+	}
+	uint32_t k0 = seed;
+	uint32_t k1 = 0x3918CA23;
+	for(int32_t round = 0; round < PHILOX4x32_DEFAULT_ROUNDS; ++round) {
+		for(uint32_t j = 0; j < lane_group; ++j) {
+			auto const p0 = uint64_t(PHILOX_M4x32_0) * uint64_t(c0[j]);
+			auto const p1 = uint64_t(PHILOX_M4x32_1) * uint64_t(c2[j]);
+			c0[j] = uint32_t(p1 >> 32) ^ c1[j] ^ k0;
+			c1[j] = uint32_t(p1);
+			c2[j] = uint32_t(p0 >> 32) ^ c3[j] ^ k1;
+			c3[j] = uint32_t(p0);
+		}
+		k0 += PHILOX_W32_0;
+		k1 += PHILOX_W32_1;
+	}
+	for(uint32_t j = 0; j < lane_group; ++j) {
+		out[j] = c1[j];
+	}
+}
+
+} // namespace
+
+void get_random_lanes(sys::state const& state, uint32_t const* values_in, uint32_t* out, uint32_t count) {
+	uint32_t i = 0;
+	for(; i + lane_group <= count; i += lane_group) {
+		philox_lane_group(state.current_date.value, state.game_seed, values_in + i, out + i);
+	}
+	if(i < count) {
+		uint32_t tail_in[lane_group] = { 0 };
+		uint32_t tail_out[lane_group];
+		for(uint32_t j = 0; i + j < count; ++j)
+			tail_in[j] = values_in[i + j];
+		philox_lane_group(state.current_date.value, state.game_seed, tail_in, tail_out);
+		for(uint32_t j = 0; i + j < count; ++j)
+			out[i + j] = tail_out[j];
+	}
+}
+
 uint32_t reduce(uint32_t value_in, uint32_t upper_bound) {
 	return uint32_t((uint64_t(value_in) * uint64_t(upper_bound)) >> 32);
 }
@@ -15,6 +15,9 @@ uint64_t get_random(sys::state const& state, uint32_t value_in);			 // try to po
 random_pair get_random_pair(sys::state const& state, uint32_t value_in);	// each call natively generates 128 random bits anyways
 uint64_t get_random(sys::state const& state, uint32_t value_in_hi, uint32_t value_in_lo);
 random_pair get_random_pair(sys::state const& state, uint32_t value_in_hi, uint32_t value_in_lo);
+// for each of count values, the low 32 bits of get_random(state, values_in[i]); the generator is run for a group of lanes
+// at a time, round by round, so that the rounds are vectorized rather than the values being generated one after another
+void get_random_lanes(sys::state const& state, uint32_t const* values_in, uint32_t* out, uint32_t count);
 uint32_t reduce(uint32_t value_in, uint32_t upper_bound);
 
 } // namespace rng
@@ -71,32 +71,6 @@ uint32_t common_size(sys::state const& state) {
 	return count_special_keys + uint32_t(2) * state.world.pop_type_size();
 }
 
-template<typename F>
-void sum_over_demographics(sys::state& state, dcon::demographics_key key, F const& source) {
-	// clear province
-	province::ve_for_each_land_province(state, [&](auto pi) { state.world.province_set_demographics(pi, key, ve::fp_vector()); });
-	// sum in province
-	state.world.for_each_pop([&](dcon::pop_id p) {
-		auto location = state.world.pop_get_province_from_pop_location(p);
-		state.world.province_get_demographics(location, key) += source(state, p);
-	});
-	// clear state
-	state.world.execute_serial_over_state_instance(
-			[&](auto si) { state.world.state_instance_set_demographics(si, key, ve::fp_vector()); });
-	// sum in state
-	province::for_each_land_province(state, [&](dcon::province_id p) {
-		auto location = state.world.province_get_state_membership(p);
-		state.world.state_instance_get_demographics(location, key) += state.world.province_get_demographics(p, key);
-	});
-	// clear nation
-	state.world.execute_serial_over_nation([&](auto ni) { state.world.nation_set_demographics(ni, key, ve::fp_vector()); });
-	// sum in nation
-	state.world.for_each_state_instance([&](dcon::state_instance_id s) {
-		auto location = state.world.state_instance_get_nation_from_state_ownership(s);
-		state.world.nation_get_demographics(location, key) += state.world.state_instance_get_demographics(s, key);
-	});
-}
-
 inline constexpr uint32_t extra_demo_grouping = 8;
 
 template<typename F>
@@ -133,230 +107,167 @@ void regenerate_jingoism_support(sys::state& state, dcon::nation_id n) {
 	}
 }
 
+namespace {
+
+// members grouped by their owner, each group in order of member id, stored as offsets into one array
+struct owner_grouping {
+	std::vector<uint32_t> starts; // the members of owner i are [starts[i], starts[i + 1])
+	std::vector<uint32_t> members;
+
+	template<typename F>
+	void build(uint32_t owner_count, uint32_t member_count, F const& owner_of) { // owner_of returns -1 for no owner
+		starts.assign(owner_count + 1, 0);
+		for(uint32_t i = 0; i < member_count; ++i) {
+			if(auto o = owner_of(i); o >= 0)
+				++starts[o + 1];
+		}
+		for(uint32_t i = 0; i < owner_count; ++i)
+			starts[i + 1] += starts[i];
+		members.resize(starts[owner_count]);
+		std::vector<uint32_t> cursor(starts.begin(), starts.end() - 1);
+		for(uint32_t i = 0; i < member_count; ++i) {
+			if(auto o = owner_of(i); o >= 0)
+				members[cursor[o]++] = i;
+		}
+	}
+};
+
+// adds what one pop contributes to every key into acc, which is indexed by key
+void accumulate_pop(sys::state const& state, dcon::pop_id p, bool colonial, std::vector<std::pair<dcon::pop_demographics_key, uint32_t>> const& weighted,
+		float* acc) {
+	auto const size = state.world.pop_get_size(p);
+	auto const type = state.world.pop_get_poptype(p);
+	auto const employment = state.world.pop_get_employment(p);
+	auto const has_unemployment = state.world.pop_type_get_has_unemployment(type);
+	auto const pop_militancy = state.world.pop_get_militancy(p);
+
+	acc[total.index()] += size;
+	acc[employable.index()] += has_unemployment ? size : 0.0f;
+	acc[employed.index()] += employment;
+	acc[consciousness.index()] += state.world.pop_get_consciousness(p) * size;
+	acc[militancy.index()] += pop_militancy * size;
+	acc[literacy.index()] += state.world.pop_get_literacy(p) * size;
+
+	if(!colonial) {
+		if(auto movement = state.world.pop_get_movement_from_pop_movement_membership(p); movement) {
+			auto opt = state.world.movement_get_associated_issue_option(movement);
+			if(opt) {
+				auto itype = state.world.issue_get_issue_type(state.world.issue_option_get_parent_issue(opt));
+				if(itype == uint8_t(culture::issue_type::political))
+					acc[political_reform_desire.index()] += size;
+				else if(itype == uint8_t(culture::issue_type::social))
+					acc[social_reform_desire.index()] += size;
+			}
+		}
+	}
+
+	// the poor, middle and rich variants of each key are consecutive
+	auto const strata = state.world.pop_type_get_strata(type);
+	if(strata <= uint8_t(culture::pop_strata::rich)) {
+		acc[poor_militancy.index() + strata] += pop_militancy * size;
+		acc[poor_life_needs.index() + strata] += state.world.pop_get_life_needs_satisfaction(p) * size;
+		acc[poor_everyday_needs.index() + strata] += state.world.pop_get_everyday_needs_satisfaction(p) * size;
+		acc[poor_luxury_needs.index() + strata] += state.world.pop_get_luxury_needs_satisfaction(p) * size;
+		acc[poor_total.index() + strata] += size;
+	}
+
+	if(type) {
+		acc[to_key(state, type).index()] += size;
+		acc[to_employment_key(state, type).index()] += has_unemployment ? employment : size;
+	}
+	if(auto c = state.world.pop_get_culture(p); c)
+		acc[to_key(state, c).index()] += size;
+	if(auto r = state.world.pop_get_religion(p); r)
+		acc[to_key(state, r).index()] += size;
+	for(auto& w : weighted)
+		acc[w.second] += state.world.pop_get_demographics(p, w.first) * size;
+}
+
+} // namespace
+
+/*
+All of the keys being regenerated are summed in a single sweep: each land province walks its own pops once, accumulating
+every key at the same time, and then each state sums its provinces and each nation its states, again for every key at the
+same time. A province, state or nation is summed by a single task, in a fixed order, so the results do not depend on how the
+work is scheduled.
+*/
 template<bool full>
 void regenerate_from_pop_data(sys::state& state) {
 	auto const sz = size(state);
 	auto const csz = common_size(state);
-	auto const extra_size = sz - csz;
-	auto const extra_group_size = (extra_size + extra_demo_grouping - 1) / extra_demo_grouping;
-
-	concurrency::parallel_for(uint32_t(0), full ?  sz : csz + extra_group_size, [&](uint32_t base_index) {
-		auto index = base_index;
-		if constexpr(!full) {
-			if(index >= csz) {
-				index += extra_group_size * (state.current_date.value % extra_demo_grouping);
-				if(index >= sz)
-					return;
-			}
+
+	// the common keys are always regenerated; on a daily update, only one of extra_demo_grouping groups of the others is
+	uint32_t extra_begin = csz;
+	uint32_t extra_end = sz;
+	if constexpr(!full) {
+		auto const extra_group_size = (sz - csz + extra_demo_grouping - 1) / extra_demo_grouping;
+		extra_begin = std::min(csz + extra_group_size * (state.current_date.value % extra_demo_grouping), sz);
+		extra_end = std::min(extra_begin + extra_group_size, sz);
+	}
+	std::vector<dcon::demographics_key> keys;
+	for(uint32_t i = 0; i < csz; ++i)
+		keys.push_back(dcon::demographics_key{ dcon::demographics_key::value_base_t(i) });
+	for(uint32_t i = extra_begin; i < extra_end; ++i)
+		keys.push_back(dcon::demographics_key{ dcon::demographics_key::value_base_t(i) });
+
+	// ideologies and issue options are weighted by the pop demographics, so only the ones being regenerated are computed
+	std::vector<std::pair<dcon::pop_demographics_key, uint32_t>> weighted;
+	for(auto i : state.world.in_ideology) {
+		auto k = uint32_t(to_key(state, i).index());
+		if(k >= extra_begin && k < extra_end)
+			weighted.emplace_back(pop_demographics::to_key(state, i), k);
+	}
+	for(auto i : state.world.in_issue_option) {
+		auto k = uint32_t(to_key(state, i).index());
+		if(k >= extra_begin && k < extra_end)
+			weighted.emplace_back(pop_demographics::to_key(state, i), k);
+	}
+
+	auto const land_provinces = uint32_t(state.province_definitions.first_sea_province.index());
+	concurrency::parallel_for(uint32_t(0), land_provinces, [&](uint32_t i) {
+		thread_local std::vector<float> acc;
+		acc.assign(sz, 0.0f);
+		dcon::province_id p{ dcon::province_id::value_base_t(i) };
+		auto const colonial = state.world.province_get_is_colonial(p);
+		for(auto pl : state.world.province_get_pop_location(p)) {
+			accumulate_pop(state, pl.get_pop(), colonial, weighted, acc.data());
 		}
-		dcon::demographics_key key{dcon::demographics_key::value_base_t(index)};
-		if(index < count_special_keys) {
-			switch(index) {
-			case 0: // constexpr inline dcon::demographics_key total(0);
-				sum_over_demographics(state, key, [](sys::state const& state, dcon::pop_id p) { return state.world.pop_get_size(p); });
-				break;
-			case 1: // constexpr inline dcon::demographics_key employable(1);
-				sum_over_demographics(state, key, [](sys::state const& state, dcon::pop_id p) {
-					return state.world.pop_type_get_has_unemployment(state.world.pop_get_poptype(p)) ? state.world.pop_get_size(p) : 0.0f;
-				});
-				break;
-			case 2: // constexpr inline dcon::demographics_key employed(2);
-				sum_over_demographics(state, key,
-						[](sys::state const& state, dcon::pop_id p) { return state.world.pop_get_employment(p); });
-				break;
-			case 3: // constexpr inline dcon::demographics_key consciousness(3);
-				sum_over_demographics(state, key, [](sys::state const& state, dcon::pop_id p) {
-					return state.world.pop_get_consciousness(p) * state.world.pop_get_size(p);
-				});
-				break;
-			case 4: // constexpr inline dcon::demographics_key militancy(4);
-				sum_over_demographics(state, key, [](sys::state const& state, dcon::pop_id p) {
-					return state.world.pop_get_militancy(p) * state.world.pop_get_size(p);
-				});
-				break;
-			case 5: // constexpr inline dcon::demographics_key literacy(5);
-				sum_over_demographics(state, key, [](sys::state const& state, dcon::pop_id p) {
-					return state.world.pop_get_literacy(p) * state.world.pop_get_size(p);
-				});
-				break;
-			case 6: // constexpr inline dcon::demographics_key political_reform_desire(6);
-				sum_over_demographics(state, key, [](sys::state const& state, dcon::pop_id p) {
-					if(state.world.province_get_is_colonial(state.world.pop_get_province_from_pop_location(p)) == false) {
-						auto movement = state.world.pop_get_movement_from_pop_movement_membership(p);
-						if(movement) {
-							auto opt = state.world.movement_get_associated_issue_option(movement);
-							auto optpar = state.world.issue_option_get_parent_issue(opt);
-							if(opt && state.world.issue_get_issue_type(optpar) == uint8_t(culture::issue_type::political))
-								return state.world.pop_get_size(p);
-						}
-						return 0.0f;
-					} else
-						return 0.0f;
-				});
-				break;
-			case 7: // constexpr inline dcon::demographics_key social_reform_desire(7);
-				sum_over_demographics(state, key, [](sys::state const& state, dcon::pop_id p) {
-					if(state.world.province_get_is_colonial(state.world.pop_get_province_from_pop_location(p)) == false) {
-						auto movement = state.world.pop_get_movement_from_pop_movement_membership(p);
-						if(movement) {
-							auto opt = state.world.movement_get_associated_issue_option(movement);
-							auto optpar = state.world.issue_option_get_parent_issue(opt);
-							if(opt && state.world.issue_get_issue_type(optpar) == uint8_t(culture::issue_type::social))
-								return state.world.pop_get_size(p);
-						}
-						return 0.0f;
-					} else
-						return 0.0f;
-				});
-				break;
-			case 8: // constexpr inline dcon::demographics_key poor_militancy(8);
-				sum_over_demographics(state, key, [](sys::state const& state, dcon::pop_id p) {
-					return state.world.pop_type_get_strata(state.world.pop_get_poptype(p)) == uint8_t(culture::pop_strata::poor)
-										 ? state.world.pop_get_militancy(p) * state.world.pop_get_size(p)
-										 : 0.0f;
-				});
-				break;
-			case 9: // constexpr inline dcon::demographics_key middle_militancy(9);
-				sum_over_demographics(state, key, [](sys::state const& state, dcon::pop_id p) {
-					return state.world.pop_type_get_strata(state.world.pop_get_poptype(p)) == uint8_t(culture::pop_strata::middle)
-										 ? state.world.pop_get_militancy(p) * state.world.pop_get_size(p)
-										 : 0.0f;
-				});
-				break;
-			case 10: // constexpr inline dcon::demographics_key rich_militancy(10);
-				sum_over_demographics(state, key, [](sys::state const& state, dcon::pop_id p) {
-					return state.world.pop_type_get_strata(state.world.pop_get_poptype(p)) == uint8_t(culture::pop_strata::rich)
-										 ? state.world.pop_get_militancy(p) * state.world.pop_get_size(p)
-										 : 0.0f;
-				});
-				break;
-			case 11: // constexpr inline dcon::demographics_key poor_life_needs(11);
-				sum_over_demographics(state, key, [](sys::state const& state, dcon::pop_id p) {
-					return state.world.pop_type_get_strata(state.world.pop_get_poptype(p)) == uint8_t(culture::pop_strata::poor)
-										 ? state.world.pop_get_life_needs_satisfaction(p) * state.world.pop_get_size(p)
-										 : 0.0f;
-				});
-				break;
-			case 12: // constexpr inline dcon::demographics_key middle_life_needs(12);
-				sum_over_demographics(state, key, [](sys::state const& state, dcon::pop_id p) {
-					return state.world.pop_type_get_strata(state.world.pop_get_poptype(p)) == uint8_t(culture::pop_strata::middle)
-										 ? state.world.pop_get_life_needs_satisfaction(p) * state.world.pop_get_size(p)
-										 : 0.0f;
-				});
-				break;
-			case 13: // constexpr inline dcon::demographics_key rich_life_needs(13);
-				sum_over_demographics(state, key, [](sys::state const& state, dcon::pop_id p) {
-					return state.world.pop_type_get_strata(state.world.pop_get_poptype(p)) == uint8_t(culture::pop_strata::rich)
-										 ? state.world.pop_get_life_needs_satisfaction(p) * state.world.pop_get_size(p)
-										 : 0.0f;
-				});
-				break;
-			case 14: // constexpr inline dcon::demographics_key poor_everyday_needs(14);
-				sum_over_demographics(state, key, [](sys::state const& state, dcon::pop_id p) {
-					return state.world.pop_type_get_strata(state.world.pop_get_poptype(p)) == uint8_t(culture::pop_strata::poor)
-										 ? state.world.pop_get_everyday_needs_satisfaction(p) * state.world.pop_get_size(p)
-										 : 0.0f;
-				});
-				break;
-			case 15: // constexpr inline dcon::demographics_key middle_everyday_needs(15);
-				sum_over_demographics(state, key, [](sys::state const& state, dcon::pop_id p) {
-					return state.world.pop_type_get_strata(state.world.pop_get_poptype(p)) == uint8_t(culture::pop_strata::middle)
-										 ? state.world.pop_get_everyday_needs_satisfaction(p) * state.world.pop_get_size(p)
-										 : 0.0f;
-				});
-				break;
-			case 16: // constexpr inline dcon::demographics_key rich_everyday_needs(16);
-				sum_over_demographics(state, key, [](sys::state const& state, dcon::pop_id p) {
-					return state.world.pop_type_get_strata(state.world.pop_get_poptype(p)) == uint8_t(culture::pop_strata::rich)
-										 ? state.world.pop_get_everyday_needs_satisfaction(p) * state.world.pop_get_size(p)
-										 : 0.0f;
-				});
-				break;
-			case 17: // constexpr inline dcon::demographics_key poor_luxury_needs(17);
-				sum_over_demographics(state, key, [](sys::state const& state, dcon::pop_id p) {
-					return state.world.pop_type_get_strata(state.world.pop_get_poptype(p)) == uint8_t(culture::pop_strata::poor)
-										 ? state.world.pop_get_luxury_needs_satisfaction(p) * state.world.pop_get_size(p)
-										 : 0.0f;
-				});
-				break;
-			case 18: // constexpr inline dcon::demographics_key middle_luxury_needs(18);
-				sum_over_demographics(state, key, [](sys::state const& state, dcon::pop_id p) {
-					return state.world.pop_type_get_strata(state.world.pop_get_poptype(p)) == uint8_t(culture::pop_strata::middle)
-										 ? state.world.pop_get_luxury_needs_satisfaction(p) * state.world.pop_get_size(p)
-										 : 0.0f;
-				});
-				break;
-			case 19: // constexpr inline dcon::demographics_key rich_luxury_needs(19);
-				sum_over_demographics(state, key, [](sys::state const& state, dcon::pop_id p) {
-					return state.world.pop_type_get_strata(state.world.pop_get_poptype(p)) == uint8_t(culture::pop_strata::rich)
-										 ? state.world.pop_get_luxury_needs_satisfaction(p) * state.world.pop_get_size(p)
-										 : 0.0f;
-				});
-				break;
-			case 20: // constexpr inline dcon::demographics_key poor_total(20);
-				sum_over_demographics(state, key, [](sys::state const& state, dcon::pop_id p) {
-					return state.world.pop_type_get_strata(state.world.pop_get_poptype(p)) == uint8_t(culture::pop_strata::poor)
-										 ? state.world.pop_get_size(p)
-										 : 0.0f;
-				});
-				break;
-			case 21: // constexpr inline dcon::demographics_key middle_total(21);
-				sum_over_demographics(state, key, [](sys::state const& state, dcon::pop_id p) {
-					return state.world.pop_type_get_strata(state.world.pop_get_poptype(p)) == uint8_t(culture::pop_strata::middle)
-										 ? state.world.pop_get_size(p)
-										 : 0.0f;
-				});
-				break;
-			case 22: // constexpr inline dcon::demographics_key rich_total(22);
-				sum_over_demographics(state, key, [](sys::state const& state, dcon::pop_id p) {
-					return state.world.pop_type_get_strata(state.world.pop_get_poptype(p)) == uint8_t(culture::pop_strata::rich)
-										 ? state.world.pop_get_size(p)
-										 : 0.0f;
-				});
-				break;
-			}
-		// common - pop type - employment - culture - ideology - issue option - religion
-		} else if(key.index() < to_employment_key(state, dcon::pop_type_id(0)).index()) { // pop type
-			dcon::pop_type_id pkey{ dcon::pop_type_id::value_base_t(index - (count_special_keys)) };
-			sum_over_demographics(state, key, [pkey](sys::state const& state, dcon::pop_id p) {
-				return state.world.pop_get_poptype(p) == pkey ? state.world.pop_get_size(p) : 0.0f;
-			});
-		} else if(key.index() < to_key(state, dcon::culture_id(0)).index()) { // employment
-			dcon::pop_type_id pkey{ dcon::pop_type_id::value_base_t(index - (count_special_keys + state.world.pop_type_size())) };
-			if(state.world.pop_type_get_has_unemployment(pkey)) {
-				sum_over_demographics(state, key, [pkey](sys::state const& state, dcon::pop_id p) {
-					return state.world.pop_get_poptype(p) == pkey ? state.world.pop_get_employment(p) : 0.0f;
-				});
-			} else {
-				sum_over_demographics(state, key, [pkey](sys::state const& state, dcon::pop_id p) {
-					return state.world.pop_get_poptype(p) == pkey ? state.world.pop_get_size(p) : 0.0f;
-				});
-			}
-		} else if(key.index() < to_key(state, dcon::ideology_id(0)).index()) { // culture
-			dcon::culture_id pkey{
-					dcon::culture_id::value_base_t(index - (count_special_keys + state.world.pop_type_size() * 2)) };
-			sum_over_demographics(state, key, [pkey](sys::state const& state, dcon::pop_id p) {
-				return state.world.pop_get_culture(p) == pkey ? state.world.pop_get_size(p) : 0.0f;
-			});
-		} else if(key.index() < to_key(state, dcon::issue_option_id(0)).index()) { // ideology
-			dcon::ideology_id pkey{dcon::ideology_id::value_base_t(index - (count_special_keys + state.world.pop_type_size() * 2 + state.world.culture_size()))};
-			auto pdemo_key = pop_demographics::to_key(state, pkey);
-			sum_over_demographics(state, key, [pdemo_key](sys::state const& state, dcon::pop_id p) {
-				return state.world.pop_get_demographics(p, pdemo_key) * state.world.pop_get_size(p);
-			});
-		} else if(key.index() < to_key(state, dcon::religion_id(0)).index()) { // issue option
-			dcon::issue_option_id pkey{dcon::issue_option_id::value_base_t(index - (count_special_keys + state.world.pop_type_size() * 2 + state.world.culture_size() + state.world.ideology_size()))};
-			auto pdemo_key = pop_demographics::to_key(state, pkey);
-			sum_over_demographics(state, key, [pdemo_key](sys::state const& state, dcon::pop_id p) {
-				return state.world.pop_get_demographics(p, pdemo_key) * state.world.pop_get_size(p);
-			});
-		} else  { // religion
-			dcon::religion_id pkey{dcon::religion_id::value_base_t(
-					index - (count_special_keys + state.world.pop_type_size() * 2 + state.world.culture_size() + state.world.ideology_size() + state.world.issue_option_size()))};
-			sum_over_demographics(state, key, [pkey](sys::state const& state, dcon::pop_id p) {
-				return state.world.pop_get_religion(p) == pkey ? state.world.pop_get_size(p) : 0.0f;
-			});
+		for(auto k : keys)
+			state.world.province_set_demographics(p, k, acc[k.index()]);
+	});
+
+	owner_grouping provinces_of_state;
+	provinces_of_state.build(state.world.state_instance_size(), land_provinces, [&](uint32_t i) {
+		return int32_t(state.world.province_get_state_membership(dcon::province_id{ dcon::province_id::value_base_t(i) }).index());
+	});
+	concurrency::parallel_for(uint32_t(0), state.world.state_instance_size(), [&](uint32_t i) {
+		thread_local std::vector<float> acc;
+		acc.assign(sz, 0.0f);
+		for(auto j = provinces_of_state.starts[i]; j < provinces_of_state.starts[i + 1]; ++j) {
+			dcon::province_id p{ dcon::province_id::value_base_t(provinces_of_state.members[j]) };
+			for(auto k : keys)
+				acc[k.index()] += state.world.province_get_demographics(p, k);
+		}
+		dcon::state_instance_id s{ dcon::state_instance_id::value_base_t(i) };
+		for(auto k : keys)
+			state.world.state_instance_set_demographics(s, k, acc[k.index()]);
+	});
+
+	owner_grouping states_of_nation;
+	states_of_nation.build(state.world.nation_size(), state.world.state_instance_size(), [&](uint32_t i) {
+		return int32_t(state.world.state_instance_get_nation_from_state_ownership(dcon::state_instance_id{ dcon::state_instance_id::value_base_t(i) }).index());
+	});
+	concurrency::parallel_for(uint32_t(0), state.world.nation_size(), [&](uint32_t i) {
+		thread_local std::vector<float> acc;
+		acc.assign(sz, 0.0f);
+		for(auto j = states_of_nation.starts[i]; j < states_of_nation.starts[i + 1]; ++j) {
+			dcon::state_instance_id s{ dcon::state_instance_id::value_base_t(states_of_nation.members[j]) };
+			for(auto k : keys)
+				acc[k.index()] += state.world.state_instance_get_demographics(s, k);
 		}
+		dcon::nation_id n{ dcon::nation_id::value_base_t(i) };
+		for(auto k : keys)
+			state.world.nation_set_demographics(n, k, acc[k.index()]);
 	});
 
 	//
@@ -1036,6 +947,32 @@ float get_estimated_literacy_change(sys::state& state, dcon::nation_id n) {
 	return t != 0.f ? sum / t : 0.f;
 }
 
+// Evaluates, for the pops in ids, the multiplicative modifier given by modifier_of for each pop's type. Rather than lane by
+// lane, this is done as one vector evaluation per pop type present in the block, with the lanes of the other types masked out.
+// Since the pops are kept sorted by province and type (see sort_pops_by_location), a block rarely holds more than a few types.
+// Lanes that are not active, or whose type has no modifier, are zero.
+template<typename F>
+ve::fp_vector evaluate_pop_type_modifiers(sys::state& state, ve::contiguous_tags<dcon::pop_id> ids, ve::mask_vector active, F const& modifier_of) {
+	auto types = state.world.pop_get_poptype(ids);
+	std::array<dcon::pop_type_id, ve::vector_size> present;
+	uint32_t present_count = 0;
+	ve::apply([&](dcon::pop_type_id t, bool a) {
+		if(a && t && std::find(present.begin(), present.begin() + present_count, t) == present.begin() + present_count)
+			present[present_count++] = t;
+	}, types, active);
+
+	ve::fp_vector result{ 0.0f };
+	for(uint32_t j = 0; j < present_count; ++j) {
+		if(auto modifier = modifier_of(present[j]); modifier) {
+			auto lanes = active && (ve::tagged_vector<int32_t>(types) == present[j].index());
+			result = ve::select(lanes,
+				trigger::evaluate_multiplicative_modifier(state, modifier, trigger::to_generic(ids), trigger::to_generic(ids), 0, lanes),
+				result);
+		}
+	}
+	return result;
+}
+
 void update_ideologies(sys::state& state, uint32_t offset, uint32_t divisions, ideology_buffer& ibuf) {
 	/*
 	For ideologies after their enable date (actual discovery / activation is irrelevant), and not restricted to civs only for pops
@@ -1056,31 +993,16 @@ void update_ideologies(sys::state& state, uint32_t offset, uint32_t divisions, i
 				pexecute_staggered_blocks(offset, divisions, new_pop_count, [&](auto ids) {
 					auto owner = nations::owner_of_pop(state, ids);
 
-					auto amount = ve::apply(
-							[&](dcon::pop_id pid, dcon::pop_type_id ptid, dcon::nation_id o) {
-								if(state.world.nation_get_is_civilized(o)) {
-									auto ptrigger = state.world.pop_type_get_ideology(ptid, i);
-									return ptrigger ? trigger::evaluate_multiplicative_modifier(state, ptrigger, trigger::to_generic(pid),
-											trigger::to_generic(pid), 0) : 0.0f;
-								} else
-									return 0.0f;
-							},
-							ids, state.world.pop_get_poptype(ids), owner);
+					auto amount = evaluate_pop_type_modifiers(state, ids, ve::mask_vector{ state.world.nation_get_is_civilized(owner) },
+							[&](dcon::pop_type_id ptid) { return state.world.pop_type_get_ideology(ptid, i); });
 
 					ibuf.temp_buffers[i].set(ids, amount);
 					ibuf.totals.set(ids, ibuf.totals.get(ids) + amount);
 				});
 			} else {
 				pexecute_staggered_blocks(offset, divisions, new_pop_count, [&](auto ids) {
-					auto owner = nations::owner_of_pop(state, ids);
-
-					auto amount = ve::apply(
-							[&](dcon::pop_id pid, dcon::pop_type_id ptid, dcon::nation_id o) {
-								auto ptrigger = state.world.pop_type_get_ideology(ptid, i);
-								return ptrigger ? trigger::evaluate_multiplicative_modifier(state, ptrigger, trigger::to_generic(pid),
-										trigger::to_generic(pid), 0) : 0.0f;
-							},
-							ids, state.world.pop_get_poptype(ids), owner);
+					auto amount = evaluate_pop_type_modifiers(state, ids, ve::mask_vector(true),
+							[&](dcon::pop_type_id ptid) { return state.world.pop_type_get_ideology(ptid, i); });
 
 					ibuf.temp_buffers[i].set(ids, amount);
 					ibuf.totals.set(ids, ibuf.totals.get(ids) + amount);
@@ -1155,15 +1077,8 @@ void update_issues(sys::state& state, uint32_t offset, uint32_t divisions, issue
 			auto owner_modifier =
 					has_modifier ? (state.world.nation_get_modifier_values(owner, modifier_key) + 1.0f) : ve::fp_vector(1.0f);
 
-			auto amount = owner_modifier * ve::select(allowed_by_owner,
-				ve::apply([&](dcon::pop_id pid, dcon::pop_type_id ptid, dcon::nation_id o) {
-					 if(auto mtrigger = state.world.pop_type_get_issues(ptid, iid); mtrigger) {
-						 return trigger::evaluate_multiplicative_modifier(state, mtrigger,  trigger::to_generic(pid), trigger::to_generic(pid), 0);
-					 } else {
-						return 0.0f;
-					 }
-				 },  ids, state.world.pop_get_poptype(ids), owner),
-				0.0f);
+			auto amount = owner_modifier * evaluate_pop_type_modifiers(state, ids, allowed_by_owner,
+				[&](dcon::pop_type_id ptid) { return state.world.pop_type_get_issues(ptid, iid); });
 
 			ibuf.temp_buffers[iid].set(ids, amount);
 			ibuf.totals.set(ids, ibuf.totals.get(ids) + amount);
@@ -2628,4 +2543,133 @@ void remove_small_pops(sys::state& state) {
 }
 
 
+namespace {
+
+template<typename T, typename G, typename S>
+void permute_pop_values(std::vector<dcon::pop_id> const& order, G const& get, S const& set) {
+	std::vector<T> values(order.size());
+	for(size_t i = 0; i < order.size(); ++i)
+		values[i] = get(order[i]);
+	for(size_t i = 0; i < order.size(); ++i)
+		set(dcon::pop_id{ dcon::pop_id::value_base_t(i) }, values[i]);
+}
+
+} // namespace
+
+void sort_pops_by_location(sys::state& state) {
+	/*
+	Pops are numbered in the order they were created in, and deleting one moves the last pop into its place, so over time the
+	pops of a province end up scattered across the whole table. This renumbers them so that the pops of each province are
+	contiguous, in order of province and then pop type (and otherwise keeping their current order), which makes every walk
+	over the pops of a province read memory in order. The ids kept by the game state itself (regiments, constructions and
+	queued events) are updated; any other id held from before the call is invalidated.
+	*/
+	auto const count = state.world.pop_size();
+	std::vector<dcon::pop_id> order;
+	order.reserve(count);
+	for(uint32_t i = 0; i < count; ++i)
+		order.push_back(dcon::pop_id{ dcon::pop_id::value_base_t(i) });
+	auto location_of = [&](dcon::pop_id p) {
+		auto loc = state.world.pop_get_province_from_pop_location(p);
+		return std::make_pair(loc ? uint32_t(loc.index()) : std::numeric_limits<uint32_t>::max(),
+				uint32_t(state.world.pop_get_poptype(p).index()));
+	};
+	auto in_order = [&](dcon::pop_id a, dcon::pop_id b) { return location_of(a) < location_of(b); };
+	if(std::is_sorted(order.begin(), order.end(), in_order))
+		return;
+	std::stable_sort(order.begin(), order.end(), in_order);
+
+	std::vector<dcon::pop_id> new_id(count);
+	for(uint32_t i = 0; i < count; ++i)
+		new_id[order[i].index()] = dcon::pop_id{ dcon::pop_id::value_base_t(i) };
+
+	// relationships that are keyed by the pop are removed, and then recreated once the pops have moved
+	std::vector<dcon::province_id> locations(count);
+	std::vector<dcon::movement_id> movements(count);
+	std::vector<dcon::rebel_faction_id> factions(count);
+	for(uint32_t i = 0; i < count; ++i) {
+		auto p = order[i];
+		locations[i] = state.world.pop_get_province_from_pop_location(p);
+		movements[i] = state.world.pop_get_movement_from_pop_movement_membership(p);
+		factions[i] = state.world.pop_get_rebel_faction_from_pop_rebellion_membership(p);
+	}
+	for(uint32_t i = 0; i < count; ++i) {
+		dcon::pop_id p{ dcon::pop_id::value_base_t(i) };
+		if(auto m = state.world.pop_get_pop_movement_membership(p); m)
+			state.world.delete_pop_movement_membership(m);
+		if(auto m = state.world.pop_get_pop_rebellion_membership(p); m)
+			state.world.delete_pop_rebellion_membership(m);
+		if(auto m = state.world.pop_get_pop_location_as_pop(p); m)
+			state.world.delete_pop_location(m);
+	}
+
+	// relationships that only refer to the pop are pointed at its new id
+	for(auto r : state.world.in_regiment) {
+		if(auto p = state.world.regiment_get_pop_from_regiment_source(r); p)
+			state.world.regiment_set_pop_from_regiment_source(r, new_id[p.index()]);
+	}
+	for(auto lc : state.world.in_province_land_construction) {
+		if(auto p = state.world.province_land_construction_get_pop(lc); p)
+			state.world.province_land_construction_set_pop(lc, new_id[p.index()]);
+	}
+	// as are the pops that queued events are waiting to be fired on
+	auto remap_slot = [&](int32_t& slot, event::slot_type t) {
+		if(t == event::slot_type::pop && uint32_t(slot) < count)
+			slot = trigger::to_generic(new_id[slot]);
+	};
+	for(auto* events : { &state.pending_n_event, &state.future_n_event }) {
+		for(auto& e : *events) {
+			remap_slot(e.primary_slot, e.pt);
+			remap_slot(e.from_slot, e.ft);
+		}
+	}
+	for(auto* events : { &state.pending_p_event, &state.future_p_event }) {
+		for(auto& e : *events)
+			remap_slot(e.from_slot, e.ft);
+	}
+
+#define PERMUTE_POP_PROPERTY(name, type) \
+	permute_pop_values<type>(order, [&](dcon::pop_id p) { return state.world.pop_get_##name(p); }, \
+			[&](dcon::pop_id p, type v) { state.world.pop_set_##name(p, v); })
+
+	PERMUTE_POP_PROPERTY(poptype, dcon::pop_type_id);
+	PERMUTE_POP_PROPERTY(religion, dcon::religion_id);
+	PERMUTE_POP_PROPERTY(culture, dcon::culture_id);
+	PERMUTE_POP_PROPERTY(size, float);
+	PERMUTE_POP_PROPERTY(savings, float);
+	PERMUTE_POP_PROPERTY(consciousness, float);
+	PERMUTE_POP_PROPERTY(militancy, float);
+	PERMUTE_POP_PROPERTY(literacy, float);
+	PERMUTE_POP_PROPERTY(employment, float);
+	PERMUTE_POP_PROPERTY(life_needs_satisfaction, float);
+	PERMUTE_POP_PROPERTY(everyday_needs_satisfaction, float);
+	PERMUTE_POP_PROPERTY(luxury_needs_satisfaction, float);
+	PERMUTE_POP_PROPERTY(political_reform_desire, float);
+	PERMUTE_POP_PROPERTY(social_reform_desire, float);
+	PERMUTE_POP_PROPERTY(dominant_ideology, dcon::ideology_id);
+	PERMUTE_POP_PROPERTY(dominant_issue_option, dcon::issue_option_id);
+	PERMUTE_POP_PROPERTY(is_primary_or_accepted_culture, bool);
+
+#undef PERMUTE_POP_PROPERTY
+
+	auto const pdsz = pop_demographics::size(state);
+	for(uint32_t k = 0; k < pdsz; ++k) {
+		dcon::pop_demographics_key key{ dcon::pop_demographics_key::value_base_t(k) };
+		permute_pop_values<float>(order, [&](dcon::pop_id p) { return state.world.pop_get_demographics(p, key); },
+				[&](dcon::pop_id p, float v) { state.world.pop_set_demographics(p, key, v); });
+	}
+
+	// recreated in order of the new ids, so that the pop lists of each province are in order too
+	for(uint32_t i = 0; i < count; ++i) {
+		dcon::pop_id p{ dcon::pop_id::value_base_t(i) };
+		if(locations[i])
+			state.world.force_create_pop_location(p, locations[i]);
+		if(movements[i])
+			state.world.try_create_pop_movement_membership(p, movements[i]);
+		if(factions[i])
+			state.world.try_create_pop_rebellion_membership(p, factions[i]);
+	}
+}
+
+
 } // namespace demographics
@@ -190,6 +190,8 @@ void apply_conversion(sys::state& state, uint32_t offset, uint32_t divisions, co
 
 void remove_size_zero_pops(sys::state& state);
 void remove_small_pops(sys::state& state);
+// renumbers the pops so that those of each province are contiguous; invalidates any pop ids held from before
+void sort_pops_by_location(sys::state& state);
 
 float get_monthly_pop_increase(sys::state& state, dcon::pop_id);
 int64_t get_monthly_pop_increase(sys::state& state, dcon::nation_id n);
@@ -16,9 +16,20 @@ enum class economy_reason {
 	pop, factory, rgo, artisan, construction, nation, stockpile, overseas_penalty
 };
 
+inline constexpr uint32_t economy_reason_count = 8;
+
+// What the demand of nation n adds to the demand_by_category of a commodity. The nations consume concurrently, so each writes
+// only its own part of state.nation_demand_by_category, and the parts are added up in a fixed order once they are done (see
+// daily_update).
+float& nation_demand_record(sys::state& state, dcon::nation_id n, dcon::commodity_id c, economy_reason reason) {
+	auto index = (size_t(n.index()) * state.world.commodity_size() + size_t(c.index())) * economy_reason_count + size_t(reason);
+	assert(index < state.nation_demand_by_category.size());
+	return state.nation_demand_by_category[index];
+}
+
 void register_demand(sys::state& state, dcon::nation_id n, dcon::commodity_id commodity_type, float amount, economy_reason reason) {
 	state.world.nation_get_real_demand(n, commodity_type) += amount;
-	state.world.commodity_get_demand_by_category(commodity_type, (int)reason) += amount;
+	nation_demand_record(state, n, commodity_type, reason) += amount;
 	assert(std::isfinite(state.world.nation_get_real_demand(n, commodity_type)));
 }
 
@@ -2314,11 +2325,12 @@ void update_national_consumption(sys::state& state, dcon::nation_id n, float spe
 void update_pop_consumption(sys::state& state, dcon::nation_id n, float base_demand, float invention_factor) {
 	uint32_t total_commodities = state.world.commodity_size();
 
-	static auto ln_demand_vector = state.world.pop_type_make_vectorizable_float_buffer();
+	// per thread, as nations consume concurrently
+	thread_local auto ln_demand_vector = state.world.pop_type_make_vectorizable_float_buffer();
 	state.world.execute_serial_over_pop_type([&](auto ids) { ln_demand_vector.set(ids, ve::fp_vector{}); });
-	static auto en_demand_vector = state.world.pop_type_make_vectorizable_float_buffer();
+	thread_local auto en_demand_vector = state.world.pop_type_make_vectorizable_float_buffer();
 	state.world.execute_serial_over_pop_type([&](auto ids) { en_demand_vector.set(ids, ve::fp_vector{}); });
-	static auto lx_demand_vector = state.world.pop_type_make_vectorizable_float_buffer();
+	thread_local auto lx_demand_vector = state.world.pop_type_make_vectorizable_float_buffer();
 	state.world.execute_serial_over_pop_type([&](auto ids) { lx_demand_vector.set(ids, ve::fp_vector{}); });
 
 	// state.defines.alice_needs_scaling_factor
@@ -2838,6 +2850,47 @@ profit_distribution distribute_factory_profit(sys::state const & state, dcon::st
 	};
 }
 
+void sum_market_totals(sys::state& state, dcon::commodity_id const* commodities, uint32_t count, market_totals* out) {
+	// the values of each commodity are stored contiguously over the nations, so each total is a plain vector sum
+	for(uint32_t i = 0; i < count; ++i) {
+		auto c = commodities[i];
+		ve::fp_vector real_demand;
+		ve::fp_vector consumption;
+		ve::fp_vector production;
+		state.world.execute_serial_over_nation([&](auto nids) {
+			auto rd = state.world.nation_get_real_demand(nids, c);
+			real_demand = real_demand + rd;
+			consumption = consumption + rd * state.world.nation_get_demand_satisfaction(nids, c);
+			production = production + state.world.nation_get_domestic_market_pool(nids, c);
+		});
+		out[i].real_demand = real_demand.reduce();
+		out[i].consumption = consumption.reduce();
+		out[i].production = production.reduce();
+	}
+}
+
+float adjusted_price(float current_price, float supply, float demand) {
+	float market_balance = demand - supply;
+	float max_slope = math::sqrt(abs(market_balance)) + 20.f;
+
+	float oversupply_factor = std::clamp(((supply + 0.001f) / (demand + 0.001f) - 1.f), 0.f, max_slope);
+	float overdemand_factor = std::clamp(((demand + 0.001f) / (supply + 0.001f) - 1.f), 0.f, max_slope);
+
+	float speed_modifer = (overdemand_factor - oversupply_factor);
+
+	float price_speed = 0.05f * speed_modifer;
+
+	if(current_price < 1.f) {
+		price_speed *= current_price;
+	} else {
+		price_speed *= math::sqrt(current_price);
+	}
+
+	current_price += price_speed;
+
+	return std::clamp(current_price, 0.001f, 100000.0f);
+}
+
 void daily_update(sys::state& state, bool initiate_buildings) {
 
 	/* initialization parallel block */
@@ -2910,14 +2963,6 @@ void daily_update(sys::state& state, bool initiate_buildings) {
 	following the same logic as Victoria 2
 	*/
 
-	{
-		for(uint32_t i = 0; i < 8; i++) {
-			state.world.for_each_commodity([&](dcon::commodity_id c) {
-				state.world.commodity_set_demand_by_category(c, i, 0.f);
-			});
-		}
-	}
-
 	for(auto n : state.nations_by_rank) {
 		if(!n) // test for running out of sorted nations
 			break;
@@ -2929,9 +2974,21 @@ void daily_update(sys::state& state, bool initiate_buildings) {
 		give_sphere_leader_production(state, n); // no need for redundant checks here
 	}
 
+	uint32_t ranked_nations = 0;
 	for(auto n : state.nations_by_rank) {
 		if(!n) // test for running out of sorted nations
 			break;
+		++ranked_nations;
+	}
+	state.nation_demand_by_category.assign(size_t(state.world.nation_size()) * total_commodities * economy_reason_count, 0.0f);
+
+	/*
+	consumption: each nation works out what its pops, factories, rgos, artisans and government want to buy. This only touches the
+	nation's own data, and that of its provinces, pops and factories, so the nations do this concurrently; what is shared between
+	them (the demand by category of each commodity) is added up afterwards, in order of rank.
+	*/
+	concurrency::parallel_for(uint32_t(0), ranked_nations, [&](uint32_t rank) {
+		auto n = state.nations_by_rank[rank];
 
 		// reset gdp
 		state.world.nation_set_gdp(n, 0.f);
@@ -2950,8 +3007,6 @@ void daily_update(sys::state& state, bool initiate_buildings) {
 		*/
 
 		populate_effective_prices(state, n);
-		auto global_price_multiplier = global_market_price_multiplier(state, n);
-		auto sl = state.world.nation_get_in_sphere_of(n);
 
 		float base_demand =
 			state.defines.base_goods_demand + state.world.nation_get_modifier_values(n, sys::national_mod_offsets::goods_demand);
@@ -3054,6 +3109,21 @@ void daily_update(sys::state& state, bool initiate_buildings) {
 
 			update_national_consumption(state, n, spending_scale, pi_scale);
 		}
+	});
+
+	for(uint32_t i = 0; i < economy_reason_count; i++) {
+		state.world.for_each_commodity([&](dcon::commodity_id c) {
+			float total = 0.0f;
+			for(uint32_t rank = 0; rank < ranked_nations; ++rank)
+				total += nation_demand_record(state, state.nations_by_rank[rank], c, economy_reason(i));
+			state.world.commodity_set_demand_by_category(c, i, total);
+		});
+	}
+
+	for(uint32_t rank = 0; rank < ranked_nations; ++rank) {
+		auto n = state.nations_by_rank[rank];
+		auto global_price_multiplier = global_market_price_multiplier(state, n);
+		auto sl = state.world.nation_get_in_sphere_of(n);
 
 		/*
 		perform actual consumption / purchasing subject to availability
@@ -3684,47 +3754,17 @@ void daily_update(sys::state& state, bool initiate_buildings) {
 			return;
 		}
 
-		float total_r_demand = 0.0f;
-		float total_consumption = 0.0f;
-		float total_production = 0.0f;
+		market_totals totals;
+		sum_market_totals(state, &cid, 1, &totals);
 
-		state.world.for_each_nation([&](dcon::nation_id n) {
-			total_r_demand += state.world.nation_get_real_demand(n, cid);
-			total_consumption += state.world.nation_get_real_demand(n, cid) * state.world.nation_get_demand_satisfaction(n, cid);
-			total_production += state.world.nation_get_domestic_market_pool(n, cid);
-		});
-
-		state.world.commodity_set_total_consumption(cid, total_consumption);
-		state.world.commodity_set_total_real_demand(cid, total_r_demand);
+		state.world.commodity_set_total_consumption(cid, totals.consumption);
+		state.world.commodity_set_total_real_demand(cid, totals.real_demand);
 
 		auto prior_production = state.world.commodity_get_total_production(cid);
-		state.world.commodity_set_total_production(cid, total_production);
+		state.world.commodity_set_total_production(cid, totals.production);
 
 		float supply = prior_production + state.world.commodity_get_global_market_pool(cid) / 12.f;
-		float demand = total_r_demand;
-
-		auto base_price = state.world.commodity_get_cost(cid);
-		auto current_price = state.world.commodity_get_current_price(cid);
-
-		float market_balance = demand - supply;
-		float max_slope = math::sqrt(abs(market_balance)) + 20.f;
-
-		float oversupply_factor = std::clamp(((supply + 0.001f) / (demand + 0.001f) - 1.f), 0.f, max_slope);
-		float overdemand_factor = std::clamp(((demand + 0.001f) / (supply + 0.001f) - 1.f), 0.f, max_slope);
-
-		float speed_modifer = (overdemand_factor - oversupply_factor);
-
-		float price_speed = 0.05f * speed_modifer;
-
-		if(current_price < 1.f) {
-			price_speed *= current_price;
-		} else {
-			price_speed *= math::sqrt(current_price);
-		}
-
-		current_price += price_speed;
-
-		state.world.commodity_set_current_price(cid, std::clamp(current_price, 0.001f, 100000.0f));
+		state.world.commodity_set_current_price(cid, adjusted_price(state.world.commodity_get_current_price(cid), supply, totals.real_demand));
 	});
 
 	if(state.cheat_data.ecodump) {
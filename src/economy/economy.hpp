@@ -182,6 +182,17 @@ float rgo_expected_worker_norm_profit(sys::state& state, dcon::province_id p, dc
 void update_rgo_employment(sys::state& state);
 void update_factory_employment(sys::state& state);
 void daily_update(sys::state& state, bool initiate_building);
+
+// the totals over the nations that decide how the price of a commodity moves
+struct market_totals {
+	float real_demand = 0.0f;
+	float consumption = 0.0f; // the part of the real demand that was satisfied
+	float production = 0.0f; // what is in the domestic market pools
+};
+// sums the market totals of each of the count commodities into out, as vector sums over the nations
+void sum_market_totals(sys::state& state, dcon::commodity_id const* commodities, uint32_t count, market_totals* out);
+// the price a commodity moves to in a day, given its current price and the supply and demand for it
+float adjusted_price(float current_price, float supply, float demand);
 void resolve_constructions(sys::state& state);
 
 float base_artisan_profit(sys::state& state, dcon::nation_id n, dcon::commodity_id c);
@@ -4643,6 +4643,8 @@ void execute_notify_start_game(sys::state& state, dcon::nation_id source) {
 	/* And clear the save stuff */
 	state.network_state.current_save_buffer.reset();
 	state.network_state.current_save_length = 0;
+	state.network_state.current_full_save_buffer.reset();
+	state.network_state.current_full_save_length = 0;
 	/* Clear AI data */
 	for(const auto n : state.world.in_nation)
 		if(state.world.nation_get_is_player_controlled(n))
@@ -5073,6 +5075,7 @@ bool can_perform_command(sys::state& state, payload& c) {
 void execute_command(sys::state& state, payload& c) {
 	if(!can_perform_command(state, c))
 		return;
+	trigger::discard_memoized_results(state);
 	switch(c.type) {
 	case command_type::invalid:
 		std::abort(); // invalid command
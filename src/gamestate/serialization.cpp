@@ -3,6 +3,8 @@
 #include "serialization.hpp"
 #include <random>
 #include <ctime>
+#include <atomic>
+#include <thread>
 
 #define ZSTD_STATIC_LINKING_ONLY
 #define XXH_NAMESPACE ZSTD_
@@ -103,11 +105,117 @@ mod_identifier extract_mod_information(uint8_t const* ptr_in, uint64_t file_size
 	return mod_identifier{ mod_path, h.timestamp, h.count };
 }
 
-uint8_t* write_compressed_section(uint8_t* ptr_out, uint8_t const* ptr_in, uint32_t uncompressed_size) {
+// zstd contexts (and, with workers, their thread pools) are expensive to create, so each thread keeps its own
+struct zstd_thread_data {
+	ZSTD_CCtx* compression = nullptr;
+	ZSTD_DCtx* decompression = nullptr;
+	std::vector<uint8_t> decompressed; // reused between sections, see trim_decompression_buffer
+
+	~zstd_thread_data() {
+		ZSTD_freeCCtx(compression);
+		ZSTD_freeDCtx(decompression);
+	}
+};
+static thread_local zstd_thread_data zstd_data;
+
+// the most that a thread keeps of its decompression buffer once a section has been read: enough for the small sections that
+// are decompressed often, while the buffer for a whole save or scenario is given back rather than held for the life of the thread
+constexpr size_t retained_decompression_buffer = size_t(4) * 1024 * 1024;
+
+// A chunked section replaces the compressed length with chunked_section, followed by the total length, the chunk length, the
+// chunk count and the compressed length of each chunk; the chunks follow, each one a complete zstd frame.
+constexpr uint32_t chunked_section = 0xFFFFFFFF;
+
+bool is_chunked(uint32_t uncompressed_size, compression_parameters const& params) {
+	return params.chunk_size != 0 && uncompressed_size > params.chunk_size;
+}
+
+size_t compressed_section_bound(uint32_t uncompressed_size, compression_parameters const& params) {
+	if(is_chunked(uncompressed_size, params)) {
+		size_t chunk_count = (size_t(uncompressed_size) + params.chunk_size - 1) / params.chunk_size;
+		return sizeof(uint32_t) * (4 + chunk_count) + ZSTD_compressBound(params.chunk_size) * chunk_count;
+	}
+	return ZSTD_compressBound(uncompressed_size) + sizeof(uint32_t) * 2;
+}
+
+ZSTD_CCtx* prepare_compression_context(compression_parameters const& params, int32_t workers) {
+	if(!zstd_data.compression)
+		zstd_data.compression = ZSTD_createCCtx();
+	auto cctx = zstd_data.compression;
+	ZSTD_CCtx_reset(cctx, ZSTD_reset_session_and_parameters);
+	ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, params.level);
+	ZSTD_CCtx_setParameter(cctx, ZSTD_c_nbWorkers, std::max(workers, 0));
+	ZSTD_CCtx_setParameter(cctx, ZSTD_c_enableLongDistanceMatching, params.long_distance_matching ? 1 : 0);
+	return cctx;
+}
+
+// Runs function(i) for each chunk on up to thread_count threads, the calling thread included. The other threads are started
+// for the call rather than borrowed from concurrency::parallel_for: a save is written alongside the simulation, and sharing its
+// worker pool would let game update tasks stall the save (and the save's chunks stall the game update).
+template<typename F>
+void for_each_chunk(uint32_t chunk_count, uint32_t thread_count, F const& function) {
+	thread_count = std::clamp(thread_count, uint32_t(1), std::max(chunk_count, uint32_t(1)));
+	std::atomic<uint32_t> next_chunk = 0;
+	auto work = [&]() {
+		for(uint32_t i = next_chunk.fetch_add(1); i < chunk_count; i = next_chunk.fetch_add(1))
+			function(i);
+	};
+	std::vector<std::thread> threads;
+	threads.reserve(thread_count - 1);
+	for(uint32_t i = 1; i < thread_count; ++i)
+		threads.emplace_back(work);
+	work();
+	for(auto& t : threads)
+		t.join();
+}
+
+uint8_t* write_chunked_section(uint8_t* ptr_out, uint8_t const* ptr_in, uint32_t uncompressed_size, compression_parameters const& params) {
+	uint32_t chunk_size = params.chunk_size;
+	uint32_t chunk_count = uint32_t((size_t(uncompressed_size) + chunk_size - 1) / chunk_size);
+	uint32_t marker = chunked_section;
+
+	auto table = ptr_out + sizeof(uint32_t) * 4;
+	auto chunks_start = table + sizeof(uint32_t) * chunk_count;
+	auto chunk_bound = ZSTD_compressBound(chunk_size);
+
+	// each chunk is compressed into its own worst-case slot (the chunks provide the parallelism, so zstd gets no workers) ...
+	for_each_chunk(chunk_count, uint32_t(std::max(params.workers, 0)), [&](uint32_t i) {
+		auto offset = size_t(i) * chunk_size;
+		auto length = std::min(size_t(chunk_size), size_t(uncompressed_size) - offset);
+		auto cctx = prepare_compression_context(params, 0);
+		auto result = ZSTD_compress2(cctx, chunks_start + chunk_bound * i, chunk_bound, ptr_in + offset, length);
+		assert(!ZSTD_isError(result));
+		uint32_t compressed_length = uint32_t(result);
+		memcpy(table + sizeof(uint32_t) * i, &compressed_length, sizeof(uint32_t));
+	});
+
+	// ... and then the slots are packed together
+	auto position = chunks_start;
+	for(uint32_t i = 0; i < chunk_count; ++i) {
+		uint32_t compressed_length = 0;
+		memcpy(&compressed_length, table + sizeof(uint32_t) * i, sizeof(uint32_t));
+		memmove(position, chunks_start + chunk_bound * i, compressed_length);
+		position += compressed_length;
+	}
+
+	ptr_out = memcpy_serialize(ptr_out, marker);
+	ptr_out = memcpy_serialize(ptr_out, uncompressed_size);
+	ptr_out = memcpy_serialize(ptr_out, chunk_size);
+	ptr_out = memcpy_serialize(ptr_out, chunk_count);
+	return position;
+}
+
+uint8_t* write_compressed_section(uint8_t* ptr_out, uint8_t const* ptr_in, uint32_t uncompressed_size, compression_parameters const& params) {
+	if(is_chunked(uncompressed_size, params))
+		return write_chunked_section(ptr_out, ptr_in, uncompressed_size, params);
+
 	uint32_t decompressed_length = uncompressed_size;
 
-	uint32_t section_length = uint32_t(ZSTD_compress(ptr_out + sizeof(uint32_t) * 2, ZSTD_compressBound(uncompressed_size), ptr_in,
-			uncompressed_size, 0)); // write compressed data
+	auto cctx = prepare_compression_context(params, params.workers);
+	auto result = ZSTD_compress2(cctx, ptr_out + sizeof(uint32_t) * 2, ZSTD_compressBound(uncompressed_size), ptr_in,
+			uncompressed_size); // write compressed data
+	assert(!ZSTD_isError(result));
+	uint32_t section_length = uint32_t(result);
 
 	memcpy(ptr_out, &section_length, sizeof(uint32_t));
 	memcpy(ptr_out + sizeof(uint32_t), &decompressed_length, sizeof(uint32_t));
@@ -115,25 +223,119 @@ uint8_t* write_compressed_section(uint8_t* ptr_out, uint8_t const* ptr_in, uint3
 	return ptr_out + sizeof(uint32_t) * 2 + section_length;
 }
 
-template<typename T>
-uint8_t const* with_decompressed_section(uint8_t const* ptr_in, T const& function) {
+// layout: a compressed length of zero (which zstd never produces), the length, the padding length, the padding, then the data
+uint8_t* write_stored_section(uint8_t* ptr_out, uint8_t const* file_start, uint8_t const* ptr_in, uint32_t size) {
+	uint32_t section_length = 0;
+	auto data_offset = size_t(ptr_out - file_start) + sizeof(uint32_t) * 3;
+	uint32_t padding = uint32_t((stored_section_alignment - data_offset % stored_section_alignment) % stored_section_alignment);
+
+	ptr_out = memcpy_serialize(ptr_out, section_length);
+	ptr_out = memcpy_serialize(ptr_out, size);
+	ptr_out = memcpy_serialize(ptr_out, padding);
+	memset(ptr_out, 0, padding);
+	ptr_out += padding;
+	memcpy(ptr_out, ptr_in, size);
+	return ptr_out + size;
+}
+
+uint8_t const* decompress_section(uint8_t const* ptr_in, uint8_t const*& data_out, uint32_t& length_out) {
 	uint32_t section_length = 0;
 	uint32_t decompressed_length = 0;
 	memcpy(&section_length, ptr_in, sizeof(uint32_t));
 	memcpy(&decompressed_length, ptr_in + sizeof(uint32_t), sizeof(uint32_t));
 
-	uint8_t* temp_buffer = new uint8_t[decompressed_length];
-	// TODO: allocate memory for decompression and decompress into it
+	if(section_length == 0) { // stored
+		uint32_t padding = 0;
+		memcpy(&padding, ptr_in + sizeof(uint32_t) * 2, sizeof(uint32_t));
+		data_out = ptr_in + sizeof(uint32_t) * 3 + padding;
+		length_out = decompressed_length;
+		return data_out + decompressed_length;
+	}
+	if(section_length == chunked_section) {
+		uint32_t chunk_size = 0;
+		uint32_t chunk_count = 0;
+		memcpy(&chunk_size, ptr_in + sizeof(uint32_t) * 2, sizeof(uint32_t));
+		memcpy(&chunk_count, ptr_in + sizeof(uint32_t) * 3, sizeof(uint32_t));
+		auto table = ptr_in + sizeof(uint32_t) * 4;
+
+		std::vector<size_t> chunk_offsets(chunk_count + 1);
+		chunk_offsets[0] = sizeof(uint32_t) * (4 + size_t(chunk_count));
+		for(uint32_t i = 0; i < chunk_count; ++i) {
+			uint32_t compressed_length = 0;
+			memcpy(&compressed_length, table + sizeof(uint32_t) * i, sizeof(uint32_t));
+			chunk_offsets[i + 1] = chunk_offsets[i] + compressed_length;
+		}
 
-	ZSTD_decompress(temp_buffer, decompressed_length, ptr_in + sizeof(uint32_t) * 2, section_length);
+		// the output belongs to the calling thread, but each chunk is decompressed with the context of the thread running it
+		if(zstd_data.decompressed.size() < decompressed_length)
+			zstd_data.decompressed.resize(decompressed_length);
+		auto destination = zstd_data.decompressed.data();
+		for_each_chunk(chunk_count, std::thread::hardware_concurrency(), [&](uint32_t i) {
+			if(!zstd_data.decompression)
+				zstd_data.decompression = ZSTD_createDCtx();
+			auto offset = size_t(i) * chunk_size;
+			auto length = std::min(size_t(chunk_size), size_t(decompressed_length) - offset);
+			ZSTD_decompressDCtx(zstd_data.decompression, destination + offset, length, ptr_in + chunk_offsets[i],
+					chunk_offsets[i + 1] - chunk_offsets[i]);
+		});
+
+		data_out = destination;
+		length_out = decompressed_length;
+		return ptr_in + chunk_offsets[chunk_count];
+	}
 
-	// function(ptr_in + sizeof(uint32_t) * 2, decompressed_length);
-	function(temp_buffer, decompressed_length);
+	if(!zstd_data.decompression)
+		zstd_data.decompression = ZSTD_createDCtx();
+	if(zstd_data.decompressed.size() < decompressed_length)
+		zstd_data.decompressed.resize(decompressed_length);
 
-	delete[] temp_buffer;
+	ZSTD_decompressDCtx(zstd_data.decompression, zstd_data.decompressed.data(), decompressed_length, ptr_in + sizeof(uint32_t) * 2,
+			section_length);
+
+	data_out = zstd_data.decompressed.data();
+	length_out = decompressed_length;
+	return ptr_in + sizeof(uint32_t) * 2 + section_length;
+}
+
+uint8_t const* skip_compressed_section(uint8_t const* ptr_in) {
+	uint32_t section_length = 0;
+	memcpy(&section_length, ptr_in, sizeof(uint32_t));
+	if(section_length == 0) { // stored
+		uint32_t length = 0;
+		uint32_t padding = 0;
+		memcpy(&length, ptr_in + sizeof(uint32_t), sizeof(uint32_t));
+		memcpy(&padding, ptr_in + sizeof(uint32_t) * 2, sizeof(uint32_t));
+		return ptr_in + sizeof(uint32_t) * 3 + padding + length;
+	}
+	if(section_length == chunked_section) {
+		uint32_t chunk_count = 0;
+		memcpy(&chunk_count, ptr_in + sizeof(uint32_t) * 3, sizeof(uint32_t));
+		auto position = ptr_in + sizeof(uint32_t) * (4 + size_t(chunk_count));
+		for(uint32_t i = 0; i < chunk_count; ++i) {
+			uint32_t compressed_length = 0;
+			memcpy(&compressed_length, ptr_in + sizeof(uint32_t) * (4 + size_t(i)), sizeof(uint32_t));
+			position += compressed_length;
+		}
+		return position;
+	}
 	return ptr_in + sizeof(uint32_t) * 2 + section_length;
 }
 
+void trim_decompression_buffer() {
+	if(zstd_data.decompressed.capacity() > retained_decompression_buffer)
+		std::vector<uint8_t>().swap(zstd_data.decompressed);
+}
+
+template<typename T>
+uint8_t const* with_decompressed_section(uint8_t const* ptr_in, T const& function) {
+	uint8_t const* data = nullptr;
+	uint32_t length = 0;
+	auto next = decompress_section(ptr_in, data, length);
+	function(data, length);
+	trim_decompression_buffer();
+	return next;
+}
+
 uint8_t const* read_scenario_section(uint8_t const* ptr_in, uint8_t const* section_end, sys::state& state) {
 	// hand-written contribution
 	{ // map
@@ -292,6 +494,9 @@ uint8_t const* read_scenario_section(uint8_t const* ptr_in, uint8_t const* secti
 	}
 	ptr_in = memcpy_deserialize(ptr_in, state.start_date);
 	ptr_in = memcpy_deserialize(ptr_in, state.end_date);
+	// the lookups refer to the data they are replacing, and are only needed while building a scenario anyway
+	state.trigger_data_lookup.clear();
+	state.effect_data_lookup.clear();
 	ptr_in = deserialize(ptr_in, state.trigger_data);
 	ptr_in = deserialize(ptr_in, state.trigger_data_indices);
 	ptr_in = deserialize(ptr_in, state.effect_data);
@@ -791,7 +996,7 @@ uint8_t* write_save_section(uint8_t* ptr_in, sys::state& state) {
 
 	return reinterpret_cast<uint8_t*>(start);
 }
-size_t sizeof_save_section(sys::state& state) {
+size_t save_section_dcon_offset(sys::state& state) {
 	size_t sz = 0;
 
 	// hand-written contribution
@@ -832,11 +1037,133 @@ size_t sizeof_save_section(sys::state& state) {
 		sz += sizeof(state.military_definitions.world_wars_enabled);
 	}
 
-	// data container contribution
+	return sz;
+}
+
+size_t sizeof_save_section(sys::state& state) {
+	// data container contribution, after the hand-written one
 	dcon::load_record loaded = state.world.make_serialize_record_store_save();
-	sz += state.world.serialize_size(loaded);
+	return save_section_dcon_offset(state) + state.world.serialize_size(loaded);
+}
 
-	return sz;
+namespace {
+
+struct save_delta_span {
+	uint32_t length = 0;
+	uint32_t reference_offset = 0; // or unmatched_span, if the span is stored as-is
+};
+constexpr uint32_t unmatched_span = 0xFFFFFFFF;
+
+// the end of each span: the hand-written part, each data container record (with its header), then anything left over
+void find_save_delta_spans(uint8_t const* section, size_t section_size, size_t dcon_offset, std::vector<uint32_t>& ends_out) {
+	ends_out.clear();
+	dcon_offset = std::min(dcon_offset, section_size);
+	if(dcon_offset > 0)
+		ends_out.push_back(uint32_t(dcon_offset));
+	if(dcon_offset < section_size) {
+		dcon::for_each_record(reinterpret_cast<std::byte const*>(section + dcon_offset), reinterpret_cast<std::byte const*>(section + section_size),
+			[&](dcon::record_header const& header, std::byte const* data_start, std::byte const* data_end) {
+			ends_out.push_back(uint32_t(reinterpret_cast<uint8_t const*>(data_end) - section));
+		});
+		if(ends_out.empty() || ends_out.back() != section_size)
+			ends_out.push_back(uint32_t(section_size));
+	}
+}
+
+} // namespace
+
+// layout: section size, span count, the span table, then the spans themselves in section order
+size_t write_save_delta(std::vector<uint8_t>& delta_out, uint8_t const* section, size_t section_size, size_t section_dcon_offset,
+		uint8_t const* reference, size_t reference_size, size_t reference_dcon_offset) {
+	std::vector<uint32_t> ends;
+	std::vector<uint32_t> reference_ends;
+	find_save_delta_spans(section, section_size, section_dcon_offset, ends);
+	find_save_delta_spans(reference, reference_size, reference_dcon_offset, reference_ends);
+
+	std::vector<save_delta_span> spans(ends.size());
+	size_t unmatched = 0;
+	for(size_t i = 0; i < ends.size(); ++i) {
+		uint32_t start = i == 0 ? 0 : ends[i - 1];
+		spans[i].length = ends[i] - start;
+		spans[i].reference_offset = unmatched_span;
+		if(i < reference_ends.size()) {
+			uint32_t reference_start = i == 0 ? 0 : reference_ends[i - 1];
+			if(reference_ends[i] - reference_start == spans[i].length)
+				spans[i].reference_offset = reference_start;
+		}
+		if(spans[i].reference_offset == unmatched_span)
+			unmatched += spans[i].length;
+	}
+
+	uint32_t total_length = uint32_t(section_size);
+	uint32_t span_count = uint32_t(spans.size());
+	size_t table_size = sizeof(uint32_t) * 2 + sizeof(save_delta_span) * spans.size();
+	delta_out.resize(table_size + section_size);
+	auto ptr = delta_out.data();
+	ptr = memcpy_serialize(ptr, total_length);
+	ptr = memcpy_serialize(ptr, span_count);
+	if(!spans.empty())
+		memcpy(ptr, spans.data(), sizeof(save_delta_span) * spans.size());
+
+	auto payload = delta_out.data() + table_size;
+	for_each_chunk(span_count, std::thread::hardware_concurrency(), [&](uint32_t i) {
+		uint32_t start = i == 0 ? 0 : ends[i - 1];
+		auto const& sp = spans[i];
+		if(sp.reference_offset == unmatched_span) {
+			memcpy(payload + start, section + start, sp.length);
+		} else {
+			for(uint32_t j = 0; j < sp.length; ++j)
+				payload[start + j] = uint8_t(section[start + j] ^ reference[sp.reference_offset + j]);
+		}
+	});
+
+	return unmatched;
+}
+
+bool apply_save_delta(std::vector<uint8_t>& section_out, uint8_t const* delta, size_t delta_size, uint8_t const* reference,
+		size_t reference_size) {
+	uint32_t total_length = 0;
+	uint32_t span_count = 0;
+	if(delta_size < sizeof(uint32_t) * 2)
+		return false;
+	delta = memcpy_deserialize(delta, total_length);
+	delta = memcpy_deserialize(delta, span_count);
+	delta_size -= sizeof(uint32_t) * 2;
+	if(span_count > delta_size / sizeof(save_delta_span))
+		return false;
+	size_t table_size = sizeof(save_delta_span) * span_count;
+	if(delta_size - table_size != total_length)
+		return false;
+
+	std::vector<save_delta_span> spans(span_count);
+	std::vector<uint32_t> starts(span_count);
+	if(span_count > 0)
+		memcpy(spans.data(), delta, table_size);
+	uint64_t position = 0;
+	for(uint32_t i = 0; i < span_count; ++i) {
+		starts[i] = uint32_t(position);
+		position += spans[i].length;
+		if(position > total_length)
+			return false;
+		if(spans[i].reference_offset != unmatched_span && uint64_t(spans[i].reference_offset) + spans[i].length > reference_size)
+			return false;
+	}
+	if(position != total_length)
+		return false;
+
+	section_out.resize(total_length);
+	auto payload = delta + table_size;
+	for_each_chunk(span_count, std::thread::hardware_concurrency(), [&](uint32_t i) {
+		auto const& sp = spans[i];
+		auto out = section_out.data() + starts[i];
+		if(sp.reference_offset == unmatched_span) {
+			memcpy(out, payload + starts[i], sp.length);
+		} else {
+			for(uint32_t j = 0; j < sp.length; ++j)
+				out[j] = uint8_t(payload[starts[i] + j] ^ reference[sp.reference_offset + j]);
+		}
+	});
+	return true;
 }
 
 void write_scenario_file(sys::state& state, native_string_view name, uint32_t count) {
@@ -851,9 +1178,15 @@ void write_scenario_file(sys::state& state, native_string_view name, uint32_t co
 	state.scenario_time_stamp = header.timestamp;
 
 
+	// uncompressed scenarios are bigger, but are read in place from the mapped file
+	bool stored = state.user_settings.uncompressed_scenarios;
+	auto section_bound = [stored](size_t space) {
+		return stored ? space + stored_section_alignment + sizeof(uint32_t) * 3 : compressed_section_bound(uint32_t(space), state.user_settings.save_compression);
+	};
+
 	// this is an upper bound, since compacting the data may require less space
 	size_t total_size =
-			sizeof_scenario_header(header) + sizeof_mod_path(simple_fs::extract_state(state.common_fs)) + ZSTD_compressBound(scenario_space) + ZSTD_compressBound(save_space) + sizeof(uint32_t) * 4;
+			sizeof_scenario_header(header) + sizeof_mod_path(simple_fs::extract_state(state.common_fs)) + section_bound(scenario_space) + section_bound(save_space);
 
 	uint8_t* temp_buffer = new uint8_t[total_size];
 	uint8_t* buffer_position = temp_buffer;
@@ -870,14 +1203,20 @@ void write_scenario_file(sys::state& state, native_string_view name, uint32_t co
 	blake2b(checksum, sizeof(*checksum), temp_scenario_buffer, scenario_space, nullptr, 0);
 	state.scenario_checksum = *checksum;
 
-	buffer_position = write_compressed_section(buffer_position, temp_scenario_buffer, uint32_t(scenario_space));
+	if(stored)
+		buffer_position = write_stored_section(buffer_position, temp_buffer, temp_scenario_buffer, uint32_t(scenario_space));
+	else
+		buffer_position = write_compressed_section(buffer_position, temp_scenario_buffer, uint32_t(scenario_space), state.user_settings.save_compression);
 	delete[] temp_scenario_buffer;
 
 	uint8_t* temp_save_buffer = new uint8_t[save_space];
 	auto last_save_written = write_save_section(temp_save_buffer, state);
 	auto last_save_written_count = last_save_written - temp_save_buffer;
 	assert(size_t(last_save_written_count) == save_space);
-	buffer_position = write_compressed_section(buffer_position, temp_save_buffer, uint32_t(save_space));
+	if(stored)
+		buffer_position = write_stored_section(buffer_position, temp_buffer, temp_save_buffer, uint32_t(save_space));
+	else
+		buffer_position = write_compressed_section(buffer_position, temp_save_buffer, uint32_t(save_space), state.user_settings.save_compression);
 	delete[] temp_save_buffer;
 
 	auto total_size_used = buffer_position - temp_buffer;
@@ -955,6 +1294,7 @@ bool try_read_scenario_and_save_file(sys::state& state, native_string_view name)
 				[&](uint8_t const* ptr_in, uint32_t length) { read_scenario_section(ptr_in, ptr_in + length, state); });
 		buffer_pos = with_decompressed_section(buffer_pos,
 				[&](uint8_t const* ptr_in, uint32_t length) { read_save_section(ptr_in, ptr_in + length, state); });
+		state.scenario_save_dcon_offset = save_section_dcon_offset(state);
 
 		state.game_seed = uint32_t(std::random_device()());
 
@@ -992,10 +1332,7 @@ bool try_read_scenario_as_save_file(sys::state& state, native_string_view name)
 
 		buffer_pos = load_mod_path(buffer_pos, state);
 
-		buffer_pos = with_decompressed_section(buffer_pos,
-			[&](uint8_t const* ptr_in, uint32_t length) {
-				// DO NOTHING -- this skips over reading the scenario section
-			});
+		buffer_pos = skip_compressed_section(buffer_pos); // the scenario section is already loaded
 		buffer_pos = with_decompressed_section(buffer_pos,
 			[&](uint8_t const* ptr_in, uint32_t length) {
 				read_save_section(ptr_in, ptr_in + length, state);
@@ -1011,6 +1348,32 @@ bool try_read_scenario_as_save_file(sys::state& state, native_string_view name)
 	}
 }
 
+bool read_scenario_save_section(sys::state& state, std::vector<uint8_t>& section_out) {
+	auto dir = simple_fs::get_or_create_scenario_directory();
+	auto scenario_file = open_file(dir, state.loaded_scenario_file);
+	if(!scenario_file)
+		return false;
+
+	scenario_header header;
+	header.version = 0;
+
+	auto contents = simple_fs::view_contents(*scenario_file);
+	uint8_t const* buffer_pos = reinterpret_cast<uint8_t const*>(contents.data);
+
+	if(contents.file_size > sizeof_scenario_header(header)) {
+		buffer_pos = read_scenario_header(buffer_pos, header);
+	}
+	if(header.version != sys::scenario_file_version || !state.scenario_checksum.is_equal(header.checksum))
+		return false;
+
+	uint32_t mod_path_length = 0;
+	buffer_pos = memcpy_deserialize(buffer_pos, mod_path_length);
+	buffer_pos += mod_path_length * sizeof(native_char);
+	buffer_pos = skip_compressed_section(buffer_pos);
+	with_decompressed_section(buffer_pos, [&](uint8_t const* ptr_in, uint32_t length) { section_out.assign(ptr_in, ptr_in + length); });
+	return true;
+}
+
 std::string make_time_string(uint64_t value) {
 	std::string result;
 	for(int32_t i = 64 / 4; i --> 0; ) {
@@ -1019,7 +1382,7 @@ std::string make_time_string(uint64_t value) {
 	return result;
 }
 
-void write_save_file(sys::state& state, save_type type, std::string const& name) {
+save_header make_save_header(sys::state& state, std::string const& name) {
 	save_header header;
 	header.count = state.scenario_counter;
 	//header.timestamp = state.scenario_time_stamp;
@@ -1036,11 +1399,76 @@ void write_save_file(sys::state& state, save_type type, std::string const& name)
 	} else {
 		header.save_name[31] = 0;
 	}
+	return header;
+}
+
+native_string autosave_file_name(int32_t index) {
+	return native_string(NATIVE("autosave_")) + simple_fs::utf8_to_native(std::to_string(index)) + native_string(NATIVE(".bin"));
+}
+
+native_string keyframe_file_name(int32_t index) {
+	// not a .bin, so that it stays out of the save list
+	return native_string(NATIVE("autosave_keyframe_")) + simple_fs::utf8_to_native(std::to_string(index)) + native_string(NATIVE(".key"));
+}
+
+native_string make_save_file_name(sys::state& state, save_type type, save_header const& header) {
+	if(type == sys::save_type::autosave) {
+		auto result = autosave_file_name(state.autosave_counter);
+		state.autosave_counter = (state.autosave_counter + 1) % sys::max_autosaves;
+		return result;
+	} else if(type == sys::save_type::bookmark) {
+		auto ymd_date = state.current_date.to_ymd(state.start_date);
+		auto base_str = "bookmark_" + make_time_string(uint64_t(std::time(nullptr))) + "-" + std::to_string(ymd_date.year) + "-" + std::to_string(ymd_date.month) + "-" + std::to_string(ymd_date.day) + ".bin";
+		return simple_fs::utf8_to_native(base_str);
+	} else {
+		auto ymd_date = state.current_date.to_ymd(state.start_date);
+		auto base_str = make_time_string(uint64_t(std::time(nullptr))) + "-" + nations::int_to_tag(state.world.national_identity_get_identifying_int(header.tag)) + "-" + std::to_string(ymd_date.year) + "-" + std::to_string(ymd_date.month) + "-" + std::to_string(ymd_date.day) + ".bin";
+		return simple_fs::utf8_to_native(base_str);
+	}
+}
+
+void write_economy_dumps(sys::state& state) {
+	auto data_dumps_directory = simple_fs::get_or_create_data_dumps_directory();
+
+	simple_fs::write_file(
+		data_dumps_directory,
+		NATIVE("economy_dump.txt"),
+		state.cheat_data.national_economy_dump_buffer.c_str(),
+		uint32_t(state.cheat_data.national_economy_dump_buffer.size())
+	);
+	simple_fs::write_file(
+		data_dumps_directory,
+		NATIVE("prices_dump.txt"),
+		state.cheat_data.prices_dump_buffer.c_str(),
+		uint32_t(state.cheat_data.prices_dump_buffer.size())
+	);
+	simple_fs::write_file(
+		data_dumps_directory,
+		NATIVE("demand_dump.txt"),
+		state.cheat_data.demand_dump_buffer.c_str(),
+		uint32_t(state.cheat_data.demand_dump_buffer.size())
+	);
+	simple_fs::write_file(
+		data_dumps_directory,
+		NATIVE("supply_dump.txt"),
+		state.cheat_data.supply_dump_buffer.c_str(),
+		uint32_t(state.cheat_data.supply_dump_buffer.size())
+	);
+	simple_fs::write_file(
+		data_dumps_directory,
+		NATIVE("demand_by_category_dump.txt"),
+		state.cheat_data.demand_by_category_dump_buffer.c_str(),
+		uint32_t(state.cheat_data.demand_by_category_dump_buffer.size())
+	);
+}
+
+void write_save_file(sys::state& state, save_type type, std::string const& name) {
+	save_header header = make_save_header(state, name);
 
 	size_t save_space = sizeof_save_section(state);
 
 	// this is an upper bound, since compacting the data may require less space
-	size_t total_size = sizeof_save_header(header) + ZSTD_compressBound(save_space) + sizeof(uint32_t) * 2;
+	size_t total_size = sizeof_save_header(header) + compressed_section_bound(uint32_t(save_space), state.user_settings.save_compression);
 
 	uint8_t* temp_buffer = new uint8_t[total_size];
 	uint8_t* buffer_position = temp_buffer;
@@ -1049,66 +1477,208 @@ void write_save_file(sys::state& state, save_type type, std::string const& name)
 
 	uint8_t* temp_save_buffer = new uint8_t[save_space];
 	write_save_section(temp_save_buffer, state);
-	buffer_position = write_compressed_section(buffer_position, temp_save_buffer, uint32_t(save_space));
+	buffer_position = write_compressed_section(buffer_position, temp_save_buffer, uint32_t(save_space), state.user_settings.save_compression);
 	delete[] temp_save_buffer;
 
 	auto total_size_used = buffer_position - temp_buffer;
 
 	auto sdir = simple_fs::get_or_create_save_game_directory();
-
-	if(type == sys::save_type::autosave) {
-		simple_fs::write_file(sdir, native_string(NATIVE("autosave_")) + simple_fs::utf8_to_native(std::to_string(state.autosave_counter)) + native_string(NATIVE(".bin")), reinterpret_cast<char*>(temp_buffer), uint32_t(total_size_used));
-		state.autosave_counter = (state.autosave_counter + 1) % sys::max_autosaves;
-	} else if(type == sys::save_type::bookmark) {
-		auto ymd_date = state.current_date.to_ymd(state.start_date);
-		auto base_str = "bookmark_" + make_time_string(uint64_t(std::time(nullptr))) + "-" + std::to_string(ymd_date.year) + "-" + std::to_string(ymd_date.month) + "-" + std::to_string(ymd_date.day) + ".bin";
-		simple_fs::write_file(sdir, simple_fs::utf8_to_native(base_str), reinterpret_cast<char*>(temp_buffer), uint32_t(total_size_used));
-	} else {
-		auto ymd_date = state.current_date.to_ymd(state.start_date);
-		auto base_str = make_time_string(uint64_t(std::time(nullptr))) + "-" + nations::int_to_tag(state.world.national_identity_get_identifying_int(header.tag)) + "-" + std::to_string(ymd_date.year) + "-" + std::to_string(ymd_date.month) + "-" + std::to_string(ymd_date.day) + ".bin";
-		simple_fs::write_file(sdir, simple_fs::utf8_to_native(base_str), reinterpret_cast<char*>(temp_buffer), uint32_t(total_size_used));
-	}
+	simple_fs::write_file(sdir, make_save_file_name(state, type, header), reinterpret_cast<char*>(temp_buffer), uint32_t(total_size_used));
 	delete[] temp_buffer;
 
 	state.save_list_updated.store(true, std::memory_order::release); // update for ui
 
+	if(state.cheat_data.ecodump) {
+		write_economy_dumps(state);
+	}
+}
+
+// picks the keyframe file that the delta autosaves on disk depend on least, preferring one that none of them need
+native_string choose_keyframe_file_name() {
+	auto sdir = simple_fs::get_or_create_save_game_directory();
+	std::array<uint64_t, background_save_writer::keyframe_files> newest_dependent{}; // timestamp of the newest delta using it
+	for(int32_t i = 0; i < sys::max_autosaves; ++i) {
+		auto f = simple_fs::open_file(sdir, autosave_file_name(i));
+		if(!f)
+			continue;
+		auto contents = simple_fs::view_contents(*f);
+		uint8_t const* buffer_pos = reinterpret_cast<uint8_t const*>(contents.data);
+		save_header header;
+		header.version = 0;
+		if(contents.file_size > sizeof_save_header(header))
+			buffer_pos = read_save_header(buffer_pos, header);
+		if(header.version != sys::delta_save_file_version)
+			continue;
+		native_string keyframe;
+		read_mod_path(buffer_pos, reinterpret_cast<uint8_t const*>(contents.data) + contents.file_size, keyframe);
+		for(int32_t k = 0; k < background_save_writer::keyframe_files; ++k) {
+			if(keyframe == keyframe_file_name(k))
+				newest_dependent[k] = std::max(newest_dependent[k], header.timestamp + 1);
+		}
+	}
+	int32_t best = 0;
+	for(int32_t k = 1; k < background_save_writer::keyframe_files; ++k) {
+		if(newest_dependent[k] < newest_dependent[best])
+			best = k;
+	}
+	return keyframe_file_name(best);
+}
+
+void background_save_worker(background_save_writer& w, sys::state& state) {
+	while(true) {
+		int32_t slot = -1;
+		{
+			std::unique_lock lk(w.lock);
+			w.signal.wait(lk, [&]() { return w.quit || w.queued_slot != -1; });
+			if(w.queued_slot == -1) // quitting with nothing left to write
+				return;
+			slot = w.queued_slot;
+			w.queued_slot = -1;
+			w.writing_slot = slot;
+		}
+		w.signal.notify_all(); // the game thread may be waiting for the queued slot to be picked up
+
+		auto& job = w.slots[slot];
+		auto sdir = simple_fs::get_or_create_save_game_directory();
+
+		bool write_keyframe = w.keyframe_file_name.empty() || w.autosaves_since_keyframe + 1 >= background_save_writer::keyframe_interval;
+		if(!job.delta || write_keyframe) {
+			size_t total_size = sizeof_save_header(job.header) + compressed_section_bound(uint32_t(job.section_size), job.compression);
+			if(w.compressed_buffer.size() < total_size)
+				w.compressed_buffer.resize(total_size);
+
+			uint8_t* buffer_position = w.compressed_buffer.data();
+			buffer_position = write_save_header(buffer_position, job.header);
+			buffer_position = write_compressed_section(buffer_position, job.buffer.data(), uint32_t(job.section_size), job.compression);
+			auto total_size_used = buffer_position - w.compressed_buffer.data();
+
+			simple_fs::write_file(sdir, job.file_name, reinterpret_cast<char*>(w.compressed_buffer.data()), uint32_t(total_size_used));
+
+			if(job.delta) { // the same save also becomes the keyframe that the following autosaves are encoded against
+				w.keyframe_file_name = choose_keyframe_file_name();
+				simple_fs::write_file(sdir, w.keyframe_file_name, reinterpret_cast<char*>(w.compressed_buffer.data()), uint32_t(total_size_used));
+
+				if(w.keyframe.size() < job.section_size)
+					w.keyframe.resize(job.section_size);
+				memcpy(w.keyframe.data(), job.buffer.data(), job.section_size);
+				w.keyframe_size = job.section_size;
+				w.keyframe_dcon_offset = job.dcon_offset;
+				blake2b(&w.keyframe_checksum, sizeof(w.keyframe_checksum), w.keyframe.data(), w.keyframe_size, nullptr, 0);
+				w.autosaves_since_keyframe = 0;
+			}
+		} else {
+			write_save_delta(w.delta_buffer, job.buffer.data(), job.section_size, job.dcon_offset, w.keyframe.data(), w.keyframe_size,
+					w.keyframe_dcon_offset);
+
+			save_header header = job.header;
+			header.version = sys::delta_save_file_version;
+			size_t total_size = sizeof_save_header(header) + sizeof_mod_path(w.keyframe_file_name) + sizeof(checksum_key)
+				+ compressed_section_bound(uint32_t(w.delta_buffer.size()), job.compression);
+			if(w.compressed_buffer.size() < total_size)
+				w.compressed_buffer.resize(total_size);
+
+			uint8_t* buffer_position = w.compressed_buffer.data();
+			buffer_position = write_save_header(buffer_position, header);
+			buffer_position = write_mod_path(buffer_position, w.keyframe_file_name);
+			buffer_position = memcpy_serialize(buffer_position, w.keyframe_checksum);
+			buffer_position = write_compressed_section(buffer_position, w.delta_buffer.data(), uint32_t(w.delta_buffer.size()), job.compression);
+			auto total_size_used = buffer_position - w.compressed_buffer.data();
+
+			simple_fs::write_file(sdir, job.file_name, reinterpret_cast<char*>(w.compressed_buffer.data()), uint32_t(total_size_used));
+			++w.autosaves_since_keyframe;
+		}
+
+		state.save_list_updated.store(true, std::memory_order::release); // update for ui
+
+		{
+			std::lock_guard lk(w.lock);
+			w.writing_slot = -1;
+		}
+		w.signal.notify_all();
+	}
+}
+
+background_save_writer::~background_save_writer() {
+	{
+		std::lock_guard lk(lock);
+		quit = true;
+	}
+	signal.notify_all();
+	if(worker.joinable())
+		worker.join(); // lets the last queued save finish so that it is not left half written
+}
+
+void write_save_file_in_background(sys::state& state, save_type type, std::string const& name) {
+	auto& w = state.save_writer;
+	int32_t slot = 0;
+	{
+		std::unique_lock lk(w.lock);
+		if(!w.worker.joinable()) {
+			w.worker = std::thread([&w, &state]() { background_save_worker(w, state); });
+		}
+		// back-pressure: if one save is being written and another is already queued, wait for the queued one to be picked up
+		w.signal.wait(lk, [&]() { return w.queued_slot == -1; });
+		slot = (w.writing_slot == 0) ? 1 : 0;
+	}
+
+	// the chosen slot is neither queued nor being written, so the worker will not touch it until we queue it
+	auto& job = w.slots[slot];
+	job.header = make_save_header(state, name);
+	dcon::load_record loaded = state.world.make_serialize_record_store_save();
+	job.dcon_offset = save_section_dcon_offset(state);
+	job.section_size = job.dcon_offset + state.world.serialize_size(loaded);
+	job.delta = type == sys::save_type::autosave && state.user_settings.delta_autosaves;
+	job.compression = state.user_settings.save_compression;
+	if(job.buffer.size() < job.section_size)
+		job.buffer.resize(job.section_size);
+	write_save_section(job.buffer.data(), state);
+	job.file_name = make_save_file_name(state, type, job.header);
+
+	{
+		std::lock_guard lk(w.lock);
+		w.queued_slot = slot;
+	}
+	w.signal.notify_all();
 
 	if(state.cheat_data.ecodump) {
-		auto data_dumps_directory = simple_fs::get_or_create_data_dumps_directory();
-
-		simple_fs::write_file(
-			data_dumps_directory,
-			NATIVE("economy_dump.txt"),
-			state.cheat_data.national_economy_dump_buffer.c_str(),
-			uint32_t(state.cheat_data.national_economy_dump_buffer.size())
-		);
-		simple_fs::write_file(
-			data_dumps_directory,
-			NATIVE("prices_dump.txt"),
-			state.cheat_data.prices_dump_buffer.c_str(),
-			uint32_t(state.cheat_data.prices_dump_buffer.size())
-		);
-		simple_fs::write_file(
-			data_dumps_directory,
-			NATIVE("demand_dump.txt"),
-			state.cheat_data.demand_dump_buffer.c_str(),
-			uint32_t(state.cheat_data.demand_dump_buffer.size())
-		);
-		simple_fs::write_file(
-			data_dumps_directory,
-			NATIVE("supply_dump.txt"),
-			state.cheat_data.supply_dump_buffer.c_str(),
-			uint32_t(state.cheat_data.supply_dump_buffer.size())
-		);
-		simple_fs::write_file(
-			data_dumps_directory,
-			NATIVE("demand_by_category_dump.txt"),
-			state.cheat_data.demand_by_category_dump_buffer.c_str(),
-			uint32_t(state.cheat_data.demand_by_category_dump_buffer.size())
-		);
+		write_economy_dumps(state);
 	}
 }
+
+void flush_background_saves(sys::state& state) {
+	auto& w = state.save_writer;
+	std::unique_lock lk(w.lock);
+	w.signal.wait(lk, [&]() { return w.queued_slot == -1 && w.writing_slot == -1; });
+}
+
+// the full save section that a delta save was encoded against, provided that the keyframe file has not been replaced since
+bool read_save_keyframe(sys::state& state, native_string_view name, checksum_key const& checksum, std::vector<uint8_t>& section_out) {
+	auto dir = simple_fs::get_or_create_save_game_directory();
+	auto keyframe_file = open_file(dir, name);
+	if(!keyframe_file)
+		return false;
+
+	save_header header;
+	header.version = 0;
+
+	auto contents = simple_fs::view_contents(*keyframe_file);
+	uint8_t const* buffer_pos = reinterpret_cast<uint8_t const*>(contents.data);
+	if(contents.file_size > sizeof_save_header(header)) {
+		buffer_pos = read_save_header(buffer_pos, header);
+	}
+	if(header.version != sys::save_file_version || !state.scenario_checksum.is_equal(header.checksum))
+		return false;
+
+	with_decompressed_section(buffer_pos, [&](uint8_t const* ptr_in, uint32_t length) { section_out.assign(ptr_in, ptr_in + length); });
+
+	checksum_key found;
+	blake2b(&found, sizeof(found), section_out.data(), section_out.size(), nullptr, 0);
+	return found.is_equal(checksum);
+}
+
 bool try_read_save_file(sys::state& state, native_string_view name) {
+	flush_background_saves(state); // don't read an autosave that is still being written
+
 	auto dir = simple_fs::get_or_create_save_game_directory();
 	auto save_file = open_file(dir, name);
 	if(save_file) {
@@ -1123,7 +1693,7 @@ bool try_read_save_file(sys::state& state, native_string_view name) {
 			buffer_pos = read_save_header(buffer_pos, header);
 		}
 
-		if(header.version != sys::save_file_version) {
+		if(header.version != sys::save_file_version && header.version != sys::delta_save_file_version) {
 			return false;
 		}
 
@@ -1134,6 +1704,32 @@ bool try_read_save_file(sys::state& state, native_string_view name) {
 		if(!state.scenario_checksum.is_equal(header.checksum))
 			return false;
 
+		if(header.version == sys::delta_save_file_version) {
+			native_string keyframe_name;
+			read_mod_path(buffer_pos, file_end, keyframe_name);
+			if(keyframe_name.empty())
+				return false;
+			buffer_pos += sizeof_mod_path(keyframe_name);
+			checksum_key keyframe_checksum;
+			buffer_pos = memcpy_deserialize(buffer_pos, keyframe_checksum);
+
+			std::vector<uint8_t> keyframe;
+			if(!read_save_keyframe(state, keyframe_name, keyframe_checksum, keyframe))
+				return false;
+
+			std::vector<uint8_t> section;
+			bool reconstructed = false;
+			with_decompressed_section(buffer_pos, [&](uint8_t const* ptr_in, uint32_t length) {
+				reconstructed = apply_save_delta(section, ptr_in, length, keyframe.data(), keyframe.size());
+			});
+			if(!reconstructed)
+				return false;
+
+			state.loaded_save_file = name;
+			read_save_section(section.data(), section.data() + section.size(), state);
+			return true;
+		}
+
 		state.loaded_save_file = name;
 
 		buffer_pos = with_decompressed_section(buffer_pos,
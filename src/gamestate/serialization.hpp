@@ -1,5 +1,10 @@
 #pragma once
 #include <vector>
+#include <array>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "constants.hpp"
 #include "container_types.hpp"
 #include "unordered_dense.h"
 #include "text.hpp"
@@ -128,8 +133,10 @@ inline uint8_t const* deserialize(uint8_t const* ptr_in, ankerl::unordered_dense
 	return ptr_in + sizeof(uint32_t) + sizeof(vec.values()[0]) * length;
 }
 
-constexpr inline uint32_t save_file_version = 39;
+constexpr inline uint32_t save_file_version = 40;
 constexpr inline uint32_t scenario_file_version = 127 + save_file_version;
+// a save that only stores its difference to a keyframe save (see write_save_delta); older versions reject it as unknown
+constexpr inline uint32_t delta_save_file_version = 0x80000000 | save_file_version;
 
 struct scenario_header {
 	uint32_t version = scenario_file_version;
@@ -169,7 +176,29 @@ size_t sizeof_save_header(save_header const& header_in);
 
 mod_identifier extract_mod_information(uint8_t const* ptr_in, uint64_t file_size);
 
-uint8_t* write_compressed_section(uint8_t* ptr_out, uint8_t const* ptr_in, uint32_t uncompressed_size);
+// how a section is compressed; the output can be decompressed by any reader regardless of the parameters used
+struct compression_parameters {
+	int32_t level = 0; // 0 selects zstd's default level
+	int32_t workers = 2; // threads compressing a section, as zstd workers or over its chunks; 0 compresses on the calling thread
+	bool long_distance_matching = false; // finds repeats across the whole section, at the cost of memory and time
+	// larger sections are split into independently compressed chunks of this size, which are compressed and decompressed in
+	// parallel; 0 compresses the section as a single frame, which compresses slightly better but decompresses on one thread
+	uint32_t chunk_size = uint32_t(4) << 20;
+};
+
+// the most space write_compressed_section may need
+size_t compressed_section_bound(uint32_t uncompressed_size, compression_parameters const& params);
+uint8_t* write_compressed_section(uint8_t* ptr_out, uint8_t const* ptr_in, uint32_t uncompressed_size, compression_parameters const& params);
+// A stored section is written without compression, padded so that its data starts on a page boundary relative to file_start.
+// Read from a mapped file, it is used in place: no decompression, no buffer, and only the pages actually read are loaded.
+constexpr inline size_t stored_section_alignment = 4096;
+uint8_t* write_stored_section(uint8_t* ptr_out, uint8_t const* file_start, uint8_t const* ptr_in, uint32_t size);
+// decompresses into a buffer owned by the calling thread, which is reused (and overwritten) by the next call on that thread,
+// except for stored sections, which are returned in place; returns the position after the section
+uint8_t const* decompress_section(uint8_t const* ptr_in, uint8_t const*& data_out, uint32_t& length_out);
+// to be called once the data from decompress_section is no longer needed: frees the buffer if it has grown past a few megabytes
+void trim_decompression_buffer();
+uint8_t const* skip_compressed_section(uint8_t const* ptr_in);
 
 // Note: these functions are for read / writing the *uncompressed* data
 uint8_t const* read_scenario_section(uint8_t const* ptr_in, uint8_t const* section_end, sys::state& state);
@@ -178,13 +207,71 @@ uint8_t* write_scenario_section(uint8_t* ptr_in, sys::state& state);
 uint8_t* write_save_section(uint8_t* ptr_in, sys::state& state);
 size_t sizeof_scenario_section(sys::state& state);
 size_t sizeof_save_section(sys::state& state);
+size_t save_section_dcon_offset(sys::state& state); // the size of the hand-written part, where the data container records begin
+
+// Delta encoding of a save section against an earlier one (the reference). Both are split into the hand-written part and one
+// span per data container record; a span that has the same length as its counterpart in the reference is stored XORed with
+// it, so that unchanged data becomes runs of zeros that zstd compresses to almost nothing, and any other span is stored as-is.
+// Decoding does not depend on how well the spans lined up, so any reference gives the right result, just a larger delta.
+// Returns the number of bytes that had to be stored as-is.
+size_t write_save_delta(std::vector<uint8_t>& delta_out, uint8_t const* section, size_t section_size, size_t section_dcon_offset,
+		uint8_t const* reference, size_t reference_size, size_t reference_dcon_offset);
+// returns false if the delta is malformed or does not fit the reference
+bool apply_save_delta(std::vector<uint8_t>& section_out, uint8_t const* delta, size_t delta_size, uint8_t const* reference,
+		size_t reference_size);
 
 void write_scenario_file(sys::state& state, native_string_view name, uint32_t count);
 bool try_read_scenario_file(sys::state& state, native_string_view name);
 bool try_read_scenario_and_save_file(sys::state& state, native_string_view name);
 bool try_read_scenario_as_save_file(sys::state& state, native_string_view name);
+// the uncompressed save section of the loaded scenario file, which every player of a session has on disk
+bool read_scenario_save_section(sys::state& state, std::vector<uint8_t>& section_out);
 
 void write_save_file(sys::state& state, sys::save_type type = sys::save_type::normal, std::string const& name = std::string(""));
 bool try_read_save_file(sys::state& state, native_string_view name);
 
+// background saving: the save section is snapshotted on the game thread into one of two reusable buffers,
+// and compressing + writing it to disk is left to a worker thread
+struct background_save {
+	std::vector<uint8_t> buffer; // uncompressed save section; grows as needed and is never shrunk
+	size_t section_size = 0;
+	size_t dcon_offset = 0;
+	bool delta = false; // may be written as a delta against the current keyframe
+	compression_parameters compression;
+	save_header header;
+	native_string file_name;
+};
+
+struct background_save_writer {
+	std::array<background_save, 2> slots;
+	std::vector<uint8_t> compressed_buffer; // only touched by the worker
+	std::thread worker;
+	std::mutex lock;
+	std::condition_variable signal;
+	int32_t queued_slot = -1;  // snapshot waiting for the worker
+	int32_t writing_slot = -1; // snapshot the worker is currently compressing / writing
+	bool quit = false;
+
+	// delta autosaves: every keyframe_interval-th autosave is also written in full to a keyframe file, and the ones in between
+	// only store their difference to it. Deltas live for max_autosaves autosaves, so with the interval at least that long a
+	// keyframe is never needed by more than the deltas of the current and the previous interval; the third keyframe file
+	// covers deltas left over from an earlier session. Only touched by the worker.
+	static constexpr int32_t keyframe_interval = sys::max_autosaves;
+	static constexpr int32_t keyframe_files = 3;
+	std::vector<uint8_t> keyframe;
+	std::vector<uint8_t> delta_buffer;
+	size_t keyframe_size = 0;
+	size_t keyframe_dcon_offset = 0;
+	checksum_key keyframe_checksum; // of the uncompressed section, so that a delta can't be applied to a replaced keyframe
+	native_string keyframe_file_name; // empty until the first keyframe of the session has been written
+	int32_t autosaves_since_keyframe = 0;
+
+	~background_save_writer();
+};
+
+// snapshots the save and returns; if both buffers are still busy, this waits until the oldest save finishes (back-pressure)
+void write_save_file_in_background(sys::state& state, sys::save_type type = sys::save_type::autosave, std::string const& name = std::string(""));
+// blocks until every queued background save has been written to disk
+void flush_background_saves(sys::state& state);
+
 } // namespace sys
@@ -1,6 +1,8 @@
 #include <algorithm>
 #include <functional>
 #include <thread>
+#include <optional>
+#include <cstring>
 #include "system_state.hpp"
 #include "dcon_generated.hpp"
 #include "map_modes.hpp"
@@ -37,6 +39,8 @@
 #include "gui_map_legend.hpp"
 #include "gui_unit_grid_box.hpp"
 #include "blake2.h"
+#include "tick_profiler.hpp"
+#include "triggers.hpp"
 
 namespace ui {
 void create_in_game_windows(sys::state& state) {
@@ -1676,28 +1680,20 @@ dcon::trigger_key state::commit_trigger_data(std::vector<uint16_t> data) {
 		return dcon::trigger_key();
 	}
 
-	auto search_result = std::search(trigger_data.data() + 1, trigger_data.data() + trigger_data.size(),
-			std::boyer_moore_horspool_searcher(data.data(), data.data() + data.size()));
-	if(search_result != trigger_data.data() + trigger_data.size()) {
-		auto const start = search_result - trigger_data.data();
-		auto it = std::find(trigger_data_indices.begin(), trigger_data_indices.end(), int32_t(start));
-		if(it != trigger_data_indices.end()) {
-			auto d = std::distance(trigger_data_indices.begin(), it);
-			return dcon::trigger_key(dcon::trigger_key::value_base_t(d - 1));
-		} else {
-			trigger_data_indices.push_back(int32_t(start));
-			assert(trigger_data_indices.size() <= std::numeric_limits<uint16_t>::max());
-			return dcon::trigger_key(dcon::trigger_key::value_base_t(trigger_data_indices.size() - 1 - 1));
-		}
-	} else {
-		auto start = trigger_data.size();
-		auto size = data.size();
-		trigger_data.resize(start + size, uint16_t(0));
-		std::copy_n(data.data(), size, trigger_data.data() + start);
-		trigger_data_indices.push_back(int32_t(start));
-		assert(trigger_data_indices.size() <= std::numeric_limits<uint16_t>::max());
-		return dcon::trigger_key(dcon::trigger_key::value_base_t(trigger_data_indices.size() - 1 - 1));
+	// the new data is appended first, so that it can be looked up in place, and is dropped again if it is already present
+	auto start = trigger_data.size();
+	auto size = data.size();
+	trigger_data.resize(start + size, uint16_t(0));
+	std::copy_n(data.data(), size, trigger_data.data() + start);
+
+	auto [it, inserted] = trigger_data_lookup.try_emplace(bytecode_span{ int32_t(start), int32_t(size) }, int32_t(trigger_data_indices.size()));
+	if(!inserted) {
+		trigger_data.resize(start);
+		return dcon::trigger_key(dcon::trigger_key::value_base_t(it->second - 1));
 	}
+	trigger_data_indices.push_back(int32_t(start));
+	assert(trigger_data_indices.size() <= std::numeric_limits<uint16_t>::max());
+	return dcon::trigger_key(dcon::trigger_key::value_base_t(trigger_data_indices.size() - 1 - 1));
 }
 
 dcon::effect_key state::commit_effect_data(std::vector<uint16_t> data) {
@@ -1710,28 +1706,19 @@ dcon::effect_key state::commit_effect_data(std::vector<uint16_t> data) {
 		return dcon::effect_key();
 	}
 
-	auto search_result = std::search(effect_data.data() + 1, effect_data.data() + effect_data.size(),
-			std::boyer_moore_horspool_searcher(data.data(), data.data() + data.size()));
-	if(search_result != effect_data.data() + effect_data.size()) {
-		auto const start = search_result - effect_data.data();
-		auto it = std::find(effect_data_indices.begin(), effect_data_indices.end(), int32_t(start));
-		if(it != effect_data_indices.end()) {
-			auto d = std::distance(effect_data_indices.begin(), it);
-			return dcon::effect_key(dcon::effect_key::value_base_t(d - 1));
-		} else {
-			effect_data_indices.push_back(int32_t(start));
-			assert(effect_data_indices.size() <= std::numeric_limits<uint16_t>::max());
-			return dcon::effect_key(dcon::effect_key::value_base_t(effect_data_indices.size() - 1 - 1));
-		}
-	} else {
-		auto start = effect_data.size();
-		auto size = data.size();
-		effect_data.resize(start + size, uint16_t(0));
-		std::copy_n(data.data(), size, effect_data.data() + start);
-		effect_data_indices.push_back(int32_t(start));
-		assert(effect_data_indices.size() <= std::numeric_limits<uint16_t>::max());
-		return dcon::effect_key(dcon::effect_key::value_base_t(effect_data_indices.size() - 1 - 1));
+	auto start = effect_data.size();
+	auto size = data.size();
+	effect_data.resize(start + size, uint16_t(0));
+	std::copy_n(data.data(), size, effect_data.data() + start);
+
+	auto [it, inserted] = effect_data_lookup.try_emplace(bytecode_span{ int32_t(start), int32_t(size) }, int32_t(effect_data_indices.size()));
+	if(!inserted) {
+		effect_data.resize(start);
+		return dcon::effect_key(dcon::effect_key::value_base_t(it->second - 1));
 	}
+	effect_data_indices.push_back(int32_t(start));
+	assert(effect_data_indices.size() <= std::numeric_limits<uint16_t>::max());
+	return dcon::effect_key(dcon::effect_key::value_base_t(effect_data_indices.size() - 1 - 1));
 }
 
 void state::save_user_settings() const {
@@ -1789,6 +1776,11 @@ void state::save_user_settings() const {
 	US_SAVE(notify_rebels_defeat);
 	US_SAVE(color_blind_mode);
 	US_SAVE(current_language);
+	US_SAVE(background_autosaves);
+	US_SAVE(save_compression);
+	US_SAVE(network_compression);
+	US_SAVE(delta_autosaves);
+	US_SAVE(uncompressed_scenarios);
 #undef US_SAVE
 
 	simple_fs::write_file(settings_location, NATIVE("user_settings.dat"), &buffer[0], uint32_t(ptr - buffer));
@@ -1856,6 +1848,11 @@ void state::load_user_settings() {
 			US_LOAD(notify_rebels_defeat);
 			US_LOAD(color_blind_mode);
 			US_LOAD(current_language);
+			US_LOAD(background_autosaves);
+			US_LOAD(save_compression);
+			US_LOAD(network_compression);
+			US_LOAD(delta_autosaves);
+			US_LOAD(uncompressed_scenarios);
 #undef US_LOAD
 		} while(false);
 
@@ -3385,6 +3382,8 @@ void state::preload() {
 
 void state::fill_unsaved_data() { // reconstructs derived values that are not directly saved after a save has been loaded
 	great_nations.reserve(int32_t(defines.great_nations_count));
+	trigger::enable_compiled_triggers(*this);
+	event::build_event_schedules(*this);
 
 	world.nation_resize_modifier_values(sys::national_mod_offsets::count);
 	world.nation_resize_rgo_goods_output(world.commodity_size());
@@ -3469,10 +3468,21 @@ void state::fill_unsaved_data() { // reconstructs derived values that are not di
 
 	economy::regenerate_unsaved_values(*this);
 
-	military::regenerate_land_unit_average(*this);
-	military::regenerate_ship_scores(*this);
-	nations::update_industrial_scores(*this);
-	nations::update_military_scores(*this);
+	// these are independent of each other, and run concurrently in the daily update as well
+	concurrency::parallel_for(0, 3, [&](int32_t index) {
+		switch(index) {
+		case 0:
+			military::regenerate_land_unit_average(*this);
+			break;
+		case 1:
+			military::regenerate_ship_scores(*this);
+			break;
+		case 2:
+			nations::update_industrial_scores(*this);
+			break;
+		}
+	});
+	nations::update_military_scores(*this); // reads the land unit averages and ship scores
 	nations::update_rankings(*this);
 	nations::update_ui_rankings(*this);
 
@@ -3606,6 +3616,10 @@ void state::fill_unsaved_data() { // reconstructs derived values that are not di
 }
 
 void state::single_game_tick() {
+	// a trace that was recorded and then switched off is written out here, while no update phase can be adding to it
+	if(!cheat_data.tick_trace && tick_profile::has_trace_events())
+		tick_profile::write_trace(*this);
+
 	// do update logic
 
 	current_date += 1;
@@ -3616,9 +3630,14 @@ void state::single_game_tick() {
 		return;
 	}
 
+	tick_profile::scoped_timer tick_timer{ *this, "single_game_tick" };
+
 	auto ymd_date = current_date.to_ymd(start_date);
 
-	diplomatic_message::update_pending(*this);
+	{
+		tick_profile::scoped_timer t{ *this, "update_pending_diplomatic_messages" };
+		diplomatic_message::update_pending(*this);
+	}
 
 	auto month_start = sys::year_month_day{ ymd_date.year, ymd_date.month, uint16_t(1) };
 	auto next_month_start = ymd_date.month != 12 ? sys::year_month_day{ ymd_date.year, uint16_t(ymd_date.month + 1), uint16_t(1) } : sys::year_month_day{ ymd_date.year + 1, uint16_t(1), uint16_t(1) };
@@ -3636,6 +3655,8 @@ void state::single_game_tick() {
 
 	// calculate complex changes in parallel where we can, but don't actually apply the results
 	// instead, the changes are saved to be applied only after all triggers have been evaluated
+	std::optional<tick_profile::scoped_timer> demographics_timer;
+	demographics_timer.emplace(*this, "demographics_update");
 	concurrency::parallel_for(0, 8, [&](int32_t index) {
 		switch(index) {
 		case 0:
@@ -3706,6 +3727,8 @@ void state::single_game_tick() {
 	});
 
 	// apply in parallel where we can
+	demographics_timer.reset();
+	demographics_timer.emplace(*this, "demographics_apply");
 	concurrency::parallel_for(0, 8, [&](int32_t index) {
 		switch(index) {
 		case 0:
@@ -3768,6 +3791,8 @@ void state::single_game_tick() {
 	});
 
 	// because they may add pops, these changes must be applied sequentially
+	demographics_timer.reset();
+	demographics_timer.emplace(*this, "demographics_apply_sequential");
 	{
 		auto o = uint32_t(ymd_date.day + 6);
 		if(o >= days_in_month)
@@ -3806,107 +3831,153 @@ void state::single_game_tick() {
 	}
 
 	demographics::remove_size_zero_pops(*this);
+	if(ymd_date.day == 1) {
+		tick_profile::scoped_timer t{ *this, "sort_pops_by_location" };
+		demographics::sort_pops_by_location(*this);
+	}
 
 	// basic repopulation of demographics derived values
+	demographics_timer.reset();
+	demographics_timer.emplace(*this, "regenerate_from_pop_data_daily");
 	demographics::regenerate_from_pop_data_daily(*this);
+	demographics_timer.reset();
 
 	// values updates pass 1 (mostly trivial things, can be done in parallel)
-	concurrency::parallel_for(0, 17, [&](int32_t index) {
-		switch(index) {
-		case 0:
-			ai::refresh_home_ports(*this);
-			break;
-		case 1:
+	static constexpr struct {
+		char const* name;
+		void (*update)(sys::state&);
+	} values_updates[] = {
+		{ "refresh_home_ports", ai::refresh_home_ports },
+		{ "update_research_points", [](sys::state& state) {
 			// Instant research cheat
-			for(auto n: this->cheat_data.instant_research_nations) {
-				auto tech = this->world.nation_get_current_research(n);
+			for(auto n : state.cheat_data.instant_research_nations) {
+				auto tech = state.world.nation_get_current_research(n);
 				if(tech.is_valid()) {
-					float points = culture::effective_technology_cost(*this, this->current_date.to_ymd(this->start_date).year, n, tech);
-   					this->world.nation_set_research_points(n, points);
+					float points = culture::effective_technology_cost(state, state.current_date.to_ymd(state.start_date).year, n, tech);
+					state.world.nation_set_research_points(n, points);
 				}
 			}
-			nations::update_research_points(*this);
-			break;
-		case 2:
-			military::regenerate_land_unit_average(*this);
-			break;
-		case 3:
-			military::regenerate_ship_scores(*this);
-			break;
-		case 4:
-			nations::update_industrial_scores(*this);
-			break;
-		case 5:
-			military::update_naval_supply_points(*this);
-			break;
-		case 6:
-			military::update_all_recruitable_regiments(*this);
-			break;
-		case 7:
-			military::regenerate_total_regiment_counts(*this);
-			break;
-		case 8:
-			economy::update_rgo_employment(*this);
-			break;
-		case 9:
-			economy::update_factory_employment(*this);
-			break;
-		case 10:
-			nations::update_administrative_efficiency(*this);
-			rebel::daily_update_rebel_organization(*this);
-			break;
-		case 11:
-			military::daily_leaders_update(*this);
-			break;
-		case 12:
-			politics::daily_party_loyalty_update(*this);
-			break;
-		case 13:
-			nations::daily_update_flashpoint_tension(*this);
-			break;
-		case 14:
-			military::update_ticking_war_score(*this);
-			break;
-		case 15:
-			military::increase_dig_in(*this);
-			break;
-		case 16:
-			military::update_blockade_status(*this);
-			break;
-		}
+			nations::update_research_points(state);
+		} },
+		{ "regenerate_land_unit_average", military::regenerate_land_unit_average },
+		{ "regenerate_ship_scores", military::regenerate_ship_scores },
+		{ "update_industrial_scores", nations::update_industrial_scores },
+		{ "update_naval_supply_points", military::update_naval_supply_points },
+		{ "update_all_recruitable_regiments", military::update_all_recruitable_regiments },
+		{ "regenerate_total_regiment_counts", military::regenerate_total_regiment_counts },
+		{ "update_rgo_employment", economy::update_rgo_employment },
+		{ "update_factory_employment", economy::update_factory_employment },
+		{ "update_administrative_efficiency", [](sys::state& state) {
+			nations::update_administrative_efficiency(state);
+			rebel::daily_update_rebel_organization(state);
+		} },
+		{ "daily_leaders_update", military::daily_leaders_update },
+		{ "daily_party_loyalty_update", politics::daily_party_loyalty_update },
+		{ "daily_update_flashpoint_tension", nations::daily_update_flashpoint_tension },
+		{ "update_ticking_war_score", military::update_ticking_war_score },
+		{ "increase_dig_in", military::increase_dig_in },
+		{ "update_blockade_status", military::update_blockade_status },
+	};
+	concurrency::parallel_for(0, int32_t(std::size(values_updates)), [&](int32_t index) {
+		tick_profile::scoped_timer t{ *this, values_updates[index].name };
+		values_updates[index].update(*this);
 	});
 
-	economy::daily_update(*this, true);
+	// everything below either fires events and effects or depends on the results of the phase before it, and so runs in order
+	{
+		tick_profile::scoped_timer t{ *this, "economy_daily_update" };
+		economy::daily_update(*this, true);
+	}
 
-	military::recover_org(*this);
-	military::update_siege_progress(*this);
-	military::update_movement(*this);
-	military::update_naval_battles(*this);
-	military::update_land_battles(*this);
+	{
+		tick_profile::scoped_timer t{ *this, "recover_org" };
+		military::recover_org(*this);
+	}
+	{
+		tick_profile::scoped_timer t{ *this, "update_siege_progress" };
+		military::update_siege_progress(*this);
+	}
+	{
+		tick_profile::scoped_timer t{ *this, "update_movement" };
+		military::update_movement(*this);
+	}
+	{
+		tick_profile::scoped_timer t{ *this, "update_naval_battles" };
+		military::update_naval_battles(*this);
+	}
+	{
+		tick_profile::scoped_timer t{ *this, "update_land_battles" };
+		military::update_land_battles(*this);
+	}
 
-	military::advance_mobilizations(*this);
+	{
+		tick_profile::scoped_timer t{ *this, "advance_mobilizations" };
+		military::advance_mobilizations(*this);
+	}
 
-	province::update_colonization(*this);
-	military::update_cbs(*this); // may add/remove cbs to a nation
+	{
+		tick_profile::scoped_timer t{ *this, "update_colonization" };
+		province::update_colonization(*this);
+	}
+	{
+		tick_profile::scoped_timer t{ *this, "update_cbs" };
+		military::update_cbs(*this); // may add/remove cbs to a nation
+	}
 
-	event::update_events(*this);
+	{
+		tick_profile::scoped_timer t{ *this, "update_events" };
+		event::update_events(*this);
+	}
 
-	culture::update_research(*this, uint32_t(ymd_date.year));
+	{
+		tick_profile::scoped_timer t{ *this, "update_research" };
+		culture::update_research(*this, uint32_t(ymd_date.year));
+	}
 
-	nations::update_military_scores(*this); // depends on ship score, land unit average
-	nations::update_rankings(*this);				// depends on industrial score, military scores
-	nations::update_great_powers(*this);		// depends on rankings
-	nations::update_influence(*this);				// depends on rankings, great powers
+	{
+		tick_profile::scoped_timer t{ *this, "update_military_scores" };
+		nations::update_military_scores(*this); // depends on ship score, land unit average
+	}
+	{
+		tick_profile::scoped_timer t{ *this, "update_rankings" };
+		nations::update_rankings(*this); // depends on industrial score, military scores
+	}
+	{
+		tick_profile::scoped_timer t{ *this, "update_great_powers" };
+		nations::update_great_powers(*this); // depends on rankings
+	}
+	{
+		tick_profile::scoped_timer t{ *this, "update_influence" };
+		nations::update_influence(*this); // depends on rankings, great powers
+	}
 
-	nations::update_crisis(*this);
-	politics::update_elections(*this);
+	{
+		tick_profile::scoped_timer t{ *this, "update_crisis" };
+		nations::update_crisis(*this);
+	}
+	{
+		tick_profile::scoped_timer t{ *this, "update_elections" };
+		politics::update_elections(*this);
+	}
 
 	//
 	if(current_date.value % 4 == 0) {
+		tick_profile::scoped_timer t{ *this, "update_ai_colonial_investment" };
 		ai::update_ai_colonial_investment(*this);
 	}
 
 	// Once per month updates, spread out over the month
+	static char const* const monthly_phase_names[] = { "monthly_updates_day_0", "monthly_updates_day_1",
+		"monthly_updates_day_2", "monthly_updates_day_3", "monthly_updates_day_4", "monthly_updates_day_5", "monthly_updates_day_6",
+		"monthly_updates_day_7", "monthly_updates_day_8", "monthly_updates_day_9", "monthly_updates_day_10",
+		"monthly_updates_day_11", "monthly_updates_day_12", "monthly_updates_day_13", "monthly_updates_day_14",
+		"monthly_updates_day_15", "monthly_updates_day_16", "monthly_updates_day_17", "monthly_updates_day_18",
+		"monthly_updates_day_19", "monthly_updates_day_20", "monthly_updates_day_21", "monthly_updates_day_22",
+		"monthly_updates_day_23", "monthly_updates_day_24", "monthly_updates_day_25", "monthly_updates_day_26",
+		"monthly_updates_day_27", "monthly_updates_day_28", "monthly_updates_day_29", "monthly_updates_day_30",
+		"monthly_updates_day_31" };
+	std::optional<tick_profile::scoped_timer> monthly_timer;
+	monthly_timer.emplace(*this, monthly_phase_names[ymd_date.day % 32]);
 	switch(ymd_date.day) {
 		case 1:
 			nations::update_monthly_points(*this);
@@ -4021,10 +4092,15 @@ void state::single_game_tick() {
 		default:
 			break;
 	}
+	monthly_timer.reset();
 
-	military::apply_regiment_damage(*this);
+	{
+		tick_profile::scoped_timer t{ *this, "apply_regiment_damage" };
+		military::apply_regiment_damage(*this);
+	}
 
 	if(ymd_date.day == 1) {
+		tick_profile::scoped_timer t{ *this, "start_of_month_updates" };
 		if(ymd_date.month == 1) {
 			// yearly update : redo the upper house
 			for(auto n : world.in_nation) {
@@ -4038,11 +4114,7 @@ void state::single_game_tick() {
 			ai::upgrade_colonies(*this);
 		}
 		if(ymd_date.month == 3 && !national_definitions.on_quarterly_pulse.empty()) {
-			for(auto n : world.in_nation) {
-				if(n.get_owned_province_count() > 0) {
-					event::fire_fixed_event(*this, national_definitions.on_quarterly_pulse, trigger::to_generic(n.id), event::slot_type::nation, n.id, -1, event::slot_type::none);
-				}
-			}
+			event::fire_pulse(*this, national_definitions.on_quarterly_pulse);
 		}
 		if(ymd_date.month == 4 && ymd_date.year % 2 == 0) { // the purge
 			demographics::remove_small_pops(*this);
@@ -4051,51 +4123,44 @@ void state::single_game_tick() {
 			ai::prune_alliances(*this);
 		}
 		if(ymd_date.month == 6 && !national_definitions.on_quarterly_pulse.empty()) {
-			for(auto n : world.in_nation) {
-				if(n.get_owned_province_count() > 0) {
-					event::fire_fixed_event(*this, national_definitions.on_quarterly_pulse, trigger::to_generic(n.id), event::slot_type::nation, n.id, -1, event::slot_type::none);
-				}
-			}
+			event::fire_pulse(*this, national_definitions.on_quarterly_pulse);
 		}
 		if(ymd_date.month == 7) {
 			ai::update_influence_priorities(*this);
 		}
 		if(ymd_date.month == 9 && !national_definitions.on_quarterly_pulse.empty()) {
-			for(auto n : world.in_nation) {
-				if(n.get_owned_province_count() > 0) {
-					event::fire_fixed_event(*this, national_definitions.on_quarterly_pulse, trigger::to_generic(n.id), event::slot_type::nation, n.id, -1, event::slot_type::none);
-				}
-			}
+			event::fire_pulse(*this, national_definitions.on_quarterly_pulse);
 		}
 		if(ymd_date.month == 10 && !national_definitions.on_yearly_pulse.empty()) {
-			for(auto n : world.in_nation) {
-				if(n.get_owned_province_count() > 0) {
-					event::fire_fixed_event(*this, national_definitions.on_yearly_pulse, trigger::to_generic(n.id), event::slot_type::nation, n.id, -1, event::slot_type::none);
-				}
-			}
+			event::fire_pulse(*this, national_definitions.on_yearly_pulse);
 		}
 		if(ymd_date.month == 11) {
 			ai::prune_alliances(*this);
 		}
 		if(ymd_date.month == 12 && !national_definitions.on_quarterly_pulse.empty()) {
-			for(auto n : world.in_nation) {
-				if(n.get_owned_province_count() > 0) {
-					event::fire_fixed_event(*this, national_definitions.on_quarterly_pulse, trigger::to_generic(n.id), event::slot_type::nation, n.id, -1, event::slot_type::none);
-				}
-			}
+			event::fire_pulse(*this, national_definitions.on_quarterly_pulse);
 		}
 	}
 
-	ai::general_ai_unit_tick(*this);
+	{
+		tick_profile::scoped_timer t{ *this, "general_ai_unit_tick" };
+		ai::general_ai_unit_tick(*this);
+	}
 
-	military::run_gc(*this);
-	nations::run_gc(*this);
-	military::update_blackflag_status(*this);
-	ai::daily_cleanup(*this);
+	{
+		tick_profile::scoped_timer t{ *this, "run_gc" };
+		military::run_gc(*this);
+		nations::run_gc(*this);
+		military::update_blackflag_status(*this);
+		ai::daily_cleanup(*this);
+	}
 
-	province::update_connected_regions(*this);
-	province::update_cached_values(*this);
-	nations::update_cached_values(*this);
+	{
+		tick_profile::scoped_timer t{ *this, "update_cached_values" };
+		province::update_connected_regions(*this);
+		province::update_cached_values(*this);
+		nations::update_cached_values(*this);
+	}
 	/*
 	 * END OF DAY: update cached data
 	 */
@@ -4113,36 +4178,76 @@ void state::single_game_tick() {
 
 	game_state_updated.store(true, std::memory_order::release);
 
+	bool autosave_today = false;
 	switch(user_settings.autosaves) {
 	case autosave_frequency::none:
 		break;
 	case autosave_frequency::daily:
-		write_save_file(*this, sys::save_type::autosave);
+		autosave_today = true;
 		break;
 	case autosave_frequency::monthly:
-		if(ymd_date.day == 1)
-			write_save_file(*this, sys::save_type::autosave);
+		autosave_today = ymd_date.day == 1;
 		break;
 	case autosave_frequency::yearly:
-		if(ymd_date.month == 1 && ymd_date.day == 1)
-			write_save_file(*this, sys::save_type::autosave);
+		autosave_today = ymd_date.month == 1 && ymd_date.day == 1;
 		break;
 	default:
 		break;
 	}
+	if(autosave_today) {
+		tick_profile::scoped_timer t{ *this, "autosave" };
+		if(user_settings.background_autosaves)
+			write_save_file_in_background(*this, sys::save_type::autosave);
+		else
+			write_save_file(*this, sys::save_type::autosave);
+	}
 }
 
 sys::checksum_key state::get_save_checksum() {
+	auto& c = checksum_cache;
+	std::lock_guard lk(c.lock);
+
+	std::swap(c.buffer, c.previous_buffer);
+	std::swap(c.chunks, c.previous_chunks);
+	std::swap(c.digests, c.previous_digests);
+
 	dcon::load_record loaded = world.make_serialize_record_store_save();
-	auto buffer = std::unique_ptr<uint8_t[]>(new uint8_t[world.serialize_size(loaded)]);
-	std::byte* start = reinterpret_cast<std::byte*>(buffer.get());
+	auto size = world.serialize_size(loaded);
+	if(c.buffer.size() < size)
+		c.buffer.resize(size);
+	std::byte* start = reinterpret_cast<std::byte*>(c.buffer.data());
 	world.serialize(start, loaded);
+	auto buffer_end = reinterpret_cast<std::byte const*>(start);
+
+	// split along the records of the serialized data, so that a change to one property only invalidates its own chunks
+	c.chunks.clear();
+	dcon::for_each_record(reinterpret_cast<std::byte const*>(c.buffer.data()), buffer_end,
+		[&](dcon::record_header const& header, std::byte const* data_start, std::byte const* data_end) {
+		auto offset = size_t(data_start - reinterpret_cast<std::byte const*>(c.buffer.data()));
+		auto remaining = size_t(data_end - data_start);
+		do {
+			auto chunk_size = std::min(remaining, save_checksum_cache::max_chunk_size);
+			c.chunks.push_back(save_checksum_cache::chunk{ offset, chunk_size });
+			offset += chunk_size;
+			remaining -= chunk_size;
+		} while(remaining > 0);
+	});
 
-	auto buffer_position = reinterpret_cast<uint8_t*>(start);
-	int32_t total_size_used = static_cast<int32_t>(buffer_position - buffer.get());
+	c.digests.resize(c.chunks.size() * save_checksum_cache::digest_size);
+	bool can_reuse = c.chunks.size() == c.previous_chunks.size();
+	concurrency::parallel_for(uint32_t(0), uint32_t(c.chunks.size()), [&](uint32_t i) {
+		auto& ch = c.chunks[i];
+		auto digest = c.digests.data() + i * save_checksum_cache::digest_size;
+		if(can_reuse && c.previous_chunks[i].offset == ch.offset && c.previous_chunks[i].size == ch.size
+			&& std::memcmp(c.buffer.data() + ch.offset, c.previous_buffer.data() + ch.offset, ch.size) == 0) {
+			std::memcpy(digest, c.previous_digests.data() + i * save_checksum_cache::digest_size, save_checksum_cache::digest_size);
+		} else {
+			blake2b(digest, save_checksum_cache::digest_size, c.buffer.data() + ch.offset, ch.size, nullptr, 0);
+		}
+	});
 
 	checksum_key key;
-	blake2b(&key, sizeof(key), buffer.get(), total_size_used, nullptr, 0);
+	blake2b(&key, sizeof(key), c.digests.data(), c.digests.size(), nullptr, 0);
 	return key;
 }
 
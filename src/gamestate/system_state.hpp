@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <atomic>
 #include <chrono>
+#include <mutex>
 //#include <fstream>
 
 #include "window.hpp"
@@ -30,6 +31,7 @@
 #include "events.hpp"
 #include "notifications.hpp"
 #include "network.hpp"
+#include "serialization.hpp"
 
 // this header will eventually contain the highest-level objects
 // that represent the overall state of the program
@@ -388,6 +390,11 @@ struct user_settings_s {
 	bool notify_rebels_defeat = true;
 	sys::color_blind_mode color_blind_mode = sys::color_blind_mode::none;
 	uint32_t current_language = 0;
+	bool background_autosaves = true; // compress and write autosaves on a worker thread instead of the game thread
+	compression_parameters save_compression; // for save and scenario files
+	compression_parameters network_compression{ 19, 2, true, 0 }; // for the save sent to clients joining a session
+	bool delta_autosaves = true; // background autosaves between keyframes only store what changed
+	bool uncompressed_scenarios = false; // larger scenario files that load without decompressing
 };
 
 struct global_scenario_data_s { // this struct holds miscellaneous global properties of the scenario
@@ -402,6 +409,10 @@ struct cheat_data_s {
 	bool instant_industry = false;
 	std::vector<dcon::nation_id> instant_research_nations;
 	bool daily_oos_check = false;
+	bool tick_trace = false; // record every timed phase of the daily update for tick_trace.json
+	bool trigger_profile = false; // count and sample the evaluation of every trigger, see trigger_profiler.hpp
+	bool trigger_memoization = true; // reuse the results of iterating trigger scopes while evaluating events and decisions
+	bool parallel_effects = false; // fire events whose effects are local to their nations concurrently, see event::is_local_to_nation
 	bool province_names = false;
 
 	bool ecodump = false;
@@ -417,6 +428,29 @@ struct cheat_data_s {
 	bool always_potential_decisions = false;
 };
 
+// The save checksum hashes the serialized save data in independent chunks (one or more per dcon property), in parallel, and
+// then hashes the chunk digests together. The previous serialization is kept, and a chunk whose bytes are identical to the
+// ones it had at the last checksum reuses its digest instead of being hashed again. Comparing the bytes costs a second buffer
+// the size of the save, but keeps the checksum exactly as strong as hashing every chunk. The save data is still serialized in
+// full on every call, since dcon exposes its properties only through serialize.
+struct save_checksum_cache {
+	static constexpr size_t max_chunk_size = size_t(1) << 20;
+	static constexpr size_t digest_size = 32;
+
+	struct chunk {
+		size_t offset = 0;
+		size_t size = 0;
+	};
+
+	std::vector<uint8_t> buffer; // reused between checksums
+	std::vector<uint8_t> previous_buffer;
+	std::vector<chunk> chunks;
+	std::vector<chunk> previous_chunks;
+	std::vector<uint8_t> digests;
+	std::vector<uint8_t> previous_digests;
+	std::mutex lock; // the ui and the game thread may both ask for a checksum
+};
+
 struct crisis_member_def {
 	dcon::nation_id id;
 
@@ -486,8 +520,16 @@ struct alignas(64) state {
 	std::vector<int32_t> trigger_data_indices;
 	std::vector<uint16_t> effect_data;
 	std::vector<int32_t> effect_data_indices;
+	// scenario building only: maps the bytecode committed so far to the index of its key, so that identical scripts share a key
+	ankerl::unordered_dense::map<bytecode_span, int32_t, bytecode_span_hash, bytecode_span_eq> trigger_data_lookup;
+	ankerl::unordered_dense::map<bytecode_span, int32_t, bytecode_span_hash, bytecode_span_eq> effect_data_lookup;
 	std::vector<value_modifier_segment> value_modifier_segments;
 	tagged_vector<value_modifier_description, dcon::value_modifier_key> value_modifiers;
+	// while a trigger::memoization_window is open, scopes that iterate over sets of objects keep their results per thread;
+	// changing the generation discards everything that has been kept so far
+	bool trigger_memo_open = false;
+	std::atomic<uint32_t> trigger_memo_generation = 0;
+	bool compiled_triggers_active = false; // see trigger_compiler.hpp
 
 	std::vector<char> text_data; // stores string data in the win1250 codepage
 	std::vector<text::text_component> text_components;
@@ -502,6 +544,7 @@ struct alignas(64) state {
 	std::vector<dcon::nation_id> nations_by_military_score;
 	std::vector<dcon::nation_id> nations_by_prestige_score;
 	std::vector<great_nation> great_nations;
+	std::vector<float> nation_demand_by_category; // scratch for economy::daily_update: what each nation adds to the demand by category of each commodity
 
 	uint64_t scenario_time_stamp = 0;	// for identifying the scenario file
 	uint32_t scenario_counter = 0;		// as above
@@ -510,6 +553,7 @@ struct alignas(64) state {
 	sys::checksum_key session_host_checksum;// for checking that the client can join a session
 	native_string loaded_scenario_file;
 	native_string loaded_save_file;
+	size_t scenario_save_dcon_offset = 0; // where the data container records begin in the scenario file's save section
 
 	//
 	// Crisis data
@@ -546,6 +590,9 @@ struct alignas(64) state {
 	std::vector<event::pending_human_n_event> future_n_event;
 	std::vector<event::pending_human_p_event> future_p_event;
 
+	event::event_schedule free_national_event_schedule; // derived from the events by event::build_event_schedules
+	event::event_schedule free_provincial_event_schedule;
+
 	std::vector<int32_t> unit_names_indices; // indices for the names
 	std::vector<char> unit_names;
 	// a second text buffer, this time for just the unit names
@@ -644,6 +691,11 @@ struct alignas(64) state {
 	// network data
 	network::network_state network_state;
 
+	// autosaves written off of the game thread
+	background_save_writer save_writer;
+
+	save_checksum_cache checksum_cache;
+
 	// the following functions will be invoked by the window subsystem
 
 	void on_create(); // called once after the window is created and opengl is ready
@@ -695,7 +747,7 @@ struct alignas(64) state {
 	dcon::trigger_key commit_trigger_data(std::vector<uint16_t> data);
 	dcon::effect_key commit_effect_data(std::vector<uint16_t> data);
 
-	state() : key_to_text_sequence(0, text::vector_backed_hash(text_data), text::vector_backed_eq(text_data)), incoming_commands(1024), new_n_event(1024), new_f_n_event(1024), new_p_event(1024), new_f_p_event(1024), new_requests(256), new_messages(2048), naval_battle_reports(256), land_battle_reports(256) { }
+	state() : trigger_data_lookup(0, bytecode_span_hash(trigger_data), bytecode_span_eq(trigger_data)), effect_data_lookup(0, bytecode_span_hash(effect_data), bytecode_span_eq(effect_data)), key_to_text_sequence(0, text::vector_backed_hash(text_data), text::vector_backed_eq(text_data)), incoming_commands(1024), new_n_event(1024), new_f_n_event(1024), new_p_event(1024), new_f_p_event(1024), new_requests(256), new_messages(2048), naval_battle_reports(256), land_battle_reports(256) { }
 
 	~state() = default;
 
@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <cstring>
+#include "tick_profiler.hpp"
+#include "system_state.hpp"
+#include "simple_fs.hpp"
+
+namespace tick_profile {
+
+namespace {
+
+std::chrono::steady_clock::time_point const profile_start = std::chrono::steady_clock::now();
+
+phase_record phases[max_phases];
+std::atomic<int32_t> phase_count = 0;
+std::mutex registration_lock;
+
+struct trace_event {
+	int32_t phase = 0;
+	int64_t start = 0;
+	int64_t duration = 0;
+};
+
+// each thread appends only to its own buffer; the buffers are only read or cleared by the game thread between ticks
+struct thread_trace {
+	std::vector<trace_event> events;
+	uint32_t thread = 0;
+};
+
+std::vector<std::unique_ptr<thread_trace>> thread_traces;
+std::atomic<uint32_t> trace_event_count = 0;
+thread_local thread_trace* local_trace = nullptr;
+
+int32_t find_phase(char const* name, int32_t count) {
+	for(int32_t i = 0; i < count; ++i) {
+		if(phases[i].name == name)
+			return i;
+	}
+	for(int32_t i = 0; i < count; ++i) {
+		if(std::strcmp(phases[i].name, name) == 0)
+			return i;
+	}
+	return -1;
+}
+
+} // namespace
+
+int32_t phase_id(char const* name) {
+	auto found = find_phase(name, phase_count.load(std::memory_order::acquire));
+	if(found != -1)
+		return found;
+
+	std::lock_guard lk(registration_lock);
+	auto count = phase_count.load(std::memory_order::acquire);
+	found = find_phase(name, count);
+	if(found != -1)
+		return found;
+	if(count >= max_phases)
+		return -1;
+	phases[count].name = name;
+	phase_count.store(count + 1, std::memory_order::release);
+	return count;
+}
+
+void record_sample(int32_t id, uint32_t microseconds) {
+	if(id < 0)
+		return;
+	auto& p = phases[id];
+	auto index = p.sample_count.fetch_add(1, std::memory_order::relaxed);
+	p.total_microseconds.fetch_add(microseconds, std::memory_order::relaxed);
+	p.samples[index & (samples_per_phase - 1)].store(microseconds, std::memory_order::relaxed);
+}
+
+void record_trace_event(int32_t id, int64_t start, int64_t duration) {
+	if(id < 0)
+		return;
+	if(!local_trace) {
+		std::lock_guard lk(registration_lock);
+		thread_traces.push_back(std::make_unique<thread_trace>());
+		thread_traces.back()->thread = uint32_t(thread_traces.size());
+		local_trace = thread_traces.back().get();
+	}
+	if(local_trace->events.size() >= max_trace_events_per_thread)
+		return;
+	local_trace->events.push_back(trace_event{ id, start, duration });
+	trace_event_count.fetch_add(1, std::memory_order::relaxed);
+}
+
+int64_t microseconds_since_start(std::chrono::steady_clock::time_point t) {
+	return std::chrono::duration_cast<std::chrono::microseconds>(t - profile_start).count();
+}
+
+std::vector<phase_summary> summarize() {
+	std::vector<phase_summary> result;
+	std::vector<uint32_t> sorted;
+	auto count = phase_count.load(std::memory_order::acquire);
+	for(int32_t i = 0; i < count; ++i) {
+		auto& p = phases[i];
+		auto calls = p.sample_count.load(std::memory_order::relaxed);
+		auto n = std::min(calls, samples_per_phase);
+		if(n == 0)
+			continue;
+
+		sorted.resize(n);
+		uint64_t total = 0;
+		for(uint32_t j = 0; j < n; ++j) {
+			sorted[j] = p.samples[j].load(std::memory_order::relaxed);
+			total += sorted[j];
+		}
+		std::sort(sorted.begin(), sorted.end());
+
+		phase_summary s;
+		s.name = p.name;
+		s.count = n;
+		s.calls = calls;
+		s.total = p.total_microseconds.load(std::memory_order::relaxed);
+		s.p50 = sorted[n / 2];
+		s.p99 = sorted[(n * 99) / 100];
+		s.max = sorted[n - 1];
+		s.mean = float(total) / float(n);
+		result.push_back(s);
+	}
+	std::sort(result.begin(), result.end(), [](phase_summary const& a, phase_summary const& b) { return a.mean > b.mean; });
+	return result;
+}
+
+void reset() {
+	auto count = phase_count.load(std::memory_order::acquire);
+	for(int32_t i = 0; i < count; ++i) {
+		phases[i].sample_count.store(0, std::memory_order::relaxed);
+		phases[i].total_microseconds.store(0, std::memory_order::relaxed);
+	}
+}
+
+bool has_trace_events() {
+	return trace_event_count.load(std::memory_order::relaxed) != 0;
+}
+
+std::string trace_to_json() {
+	std::string out = "{\"traceEvents\":[\n";
+	bool first = true;
+	std::lock_guard lk(registration_lock);
+	for(auto& t : thread_traces) {
+		for(auto& e : t->events) {
+			if(!first)
+				out += ",\n";
+			first = false;
+			out += "{\"name\":\"";
+			out += phases[e.phase].name;
+			out += "\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+			out += std::to_string(t->thread);
+			out += ",\"ts\":";
+			out += std::to_string(e.start);
+			out += ",\"dur\":";
+			out += std::to_string(e.duration);
+			out += "}";
+		}
+	}
+	out += "\n]}\n";
+	return out;
+}
+
+void clear_trace() {
+	std::lock_guard lk(registration_lock);
+	for(auto& t : thread_traces) {
+		t->events.clear();
+	}
+	trace_event_count.store(0, std::memory_order::relaxed);
+}
+
+void write_trace(sys::state& state) {
+	auto json = trace_to_json();
+	auto sdir = simple_fs::get_or_create_oos_directory();
+	simple_fs::write_file(sdir, NATIVE("tick_trace.json"), json.data(), uint32_t(json.size()));
+	clear_trace();
+}
+
+scoped_timer::scoped_timer(sys::state& s, char const* name) : state(s), id(phase_id(name)), start(std::chrono::steady_clock::now()) {
+}
+
+scoped_timer::~scoped_timer() {
+	auto end = std::chrono::steady_clock::now();
+	auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+	record_sample(id, uint32_t(duration));
+	if(state.cheat_data.tick_trace)
+		record_trace_event(id, microseconds_since_start(start), duration);
+}
+
+} // namespace tick_profile
@@ -0,0 +1,65 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace sys {
+struct state;
+}
+
+// Timings of the individual phases of the daily update. Every phase keeps a ring of its most recent durations, from which the
+// console reports the median and 99th percentile. Optionally, every timed phase is also recorded, per thread, for export as a
+// chrome://tracing (or Perfetto) json file.
+namespace tick_profile {
+
+inline constexpr int32_t max_phases = 192;
+inline constexpr uint32_t samples_per_phase = 256; // must be a power of two
+inline constexpr size_t max_trace_events_per_thread = size_t(1) << 20;
+
+struct phase_record {
+	char const* name = nullptr;
+	std::atomic<uint32_t> sample_count = 0;
+	std::atomic<uint64_t> total_microseconds = 0;
+	std::atomic<uint32_t> samples[samples_per_phase] = {}; // microseconds
+};
+
+struct phase_summary {
+	char const* name = nullptr;
+	uint32_t count = 0; // how many samples the percentiles were computed from
+	uint32_t calls = 0; // since the last reset
+	uint64_t total = 0; // microseconds, since the last reset
+	uint32_t p50 = 0;
+	uint32_t p99 = 0;
+	uint32_t max = 0;
+	float mean = 0.0f;
+};
+
+// returns a stable index for the named phase, registering it if it has not been seen before
+int32_t phase_id(char const* name);
+void record_sample(int32_t id, uint32_t microseconds);
+void record_trace_event(int32_t id, int64_t start, int64_t duration);
+int64_t microseconds_since_start(std::chrono::steady_clock::time_point t);
+
+// phases with no samples are omitted; sorted from the largest to the smallest mean
+std::vector<phase_summary> summarize();
+void reset();
+
+bool has_trace_events();
+std::string trace_to_json();
+void clear_trace();
+void write_trace(sys::state& state); // writes to the oos dump directory and clears the recorded events
+
+class scoped_timer {
+	sys::state& state;
+	int32_t id;
+	std::chrono::steady_clock::time_point start;
+public:
+	scoped_timer(sys::state& s, char const* name);
+	scoped_timer(scoped_timer const&) = delete;
+	scoped_timer& operator=(scoped_timer const&) = delete;
+	~scoped_timer();
+};
+
+} // namespace tick_profile
@@ -5,6 +5,9 @@
 #include "gui_console.hpp"
 #include "gui_fps_counter.hpp"
 #include "nations.hpp"
+#include "tick_profiler.hpp"
+#include "trigger_profiler.hpp"
+#include "trigger_compiler.hpp"
 
 #define STB_IMAGE_WRITE_IMPLEMENTATION 1
 #include "stb_image_write.h"
@@ -73,7 +76,12 @@ struct command_info {
 		list_all_flags,
 		set_auto_choice_all,
 		clear_auto_choice_all,
-		economy_dump
+		economy_dump,
+		tick_profiler,
+		trigger_profiler,
+		trigger_memoization,
+		compile_triggers,
+		parallel_effects
 	} mode = type::none;
 	std::string_view desc;
 	struct argument_info {
@@ -267,6 +275,21 @@ inline constexpr command_info possible_commands[] = {
 		command_info{ "ecodump", command_info::type::economy_dump, "Starts writing economy info to the disk. Could deteriorate performance.",
 				{command_info::argument_info{}, command_info::argument_info{},
 						command_info::argument_info{}, command_info::argument_info{}} },
+		command_info{ "tickprof", command_info::type::tick_profiler, "Show the time taken by each daily update phase, \"reset\" them, or toggle a \"trace\"",
+				{command_info::argument_info{"action", command_info::argument_info::type::text, true}, command_info::argument_info{},
+						command_info::argument_info{}, command_info::argument_info{}} },
+		command_info{ "trigmemo", command_info::type::trigger_memoization, "Toggle reusing the results of iterating trigger scopes while evaluating events and decisions",
+				{command_info::argument_info{}, command_info::argument_info{},
+						command_info::argument_info{}, command_info::argument_info{}} },
+		command_info{ "pareffects", command_info::type::parallel_effects, "Toggle firing the events that only affect their own nation concurrently",
+				{command_info::argument_info{}, command_info::argument_info{},
+						command_info::argument_info{}, command_info::argument_info{}} },
+		command_info{ "compiletriggers", command_info::type::compile_triggers, "Write the triggers of this scenario as C++, to build in with ALICE_COMPILED_TRIGGERS",
+				{command_info::argument_info{}, command_info::argument_info{},
+						command_info::argument_info{}, command_info::argument_info{}} },
+		command_info{ "trigprof", command_info::type::trigger_profiler, "Show the most expensive triggers, \"toggle\" or \"reset\" the profiler, or write a \"csv\"",
+				{command_info::argument_info{"action", command_info::argument_info::type::text, true}, command_info::argument_info{},
+						command_info::argument_info{}, command_info::argument_info{}} },
 };
 
 uint32_t levenshtein_distance(std::string_view s1, std::string_view s2) {
@@ -2247,6 +2270,86 @@ void ui::console_edit::edit_box_enter(sys::state& state, std::string_view s) noe
 		stbi_write_png_to_func(func, nullptr, int(state.map_state.map_data.size_x), int(state.map_state.map_data.size_y), 3, buffer.get(), 0);
 		break;
 	}
+	case command_info::type::tick_profiler:
+	{
+		if(std::holds_alternative<std::string>(pstate.arg_slots[0])) {
+			auto const k = std::get<std::string>(pstate.arg_slots[0]);
+			if(k == "reset") {
+				tick_profile::reset();
+				log_to_console(state, parent, "✔");
+			} else if(k == "trace") {
+				state.cheat_data.tick_trace = not state.cheat_data.tick_trace;
+				log_to_console(state, parent, state.cheat_data.tick_trace ? "✔" : "✘");
+				if(!state.cheat_data.tick_trace)
+					log_to_console(state, parent, "The trace will be written to tick_trace.json on the next tick");
+			} else {
+				log_to_console(state, parent, "Valid options: reset, trace");
+			}
+			break;
+		}
+		auto summaries = tick_profile::summarize();
+		if(summaries.empty()) {
+			log_to_console(state, parent, "No ticks have been timed yet");
+			break;
+		}
+		for(auto& s : summaries) {
+			log_to_console(state, parent, "\x95\xA7Y" + std::string(s.name) + "\xA7W: p50 " + std::to_string(s.p50) + "us, p99 "
+				+ std::to_string(s.p99) + "us, max " + std::to_string(s.max) + "us (" + std::to_string(s.count) + " samples)");
+		}
+		break;
+	}
+	case command_info::type::compile_triggers:
+	{
+		trigger::write_compiled_triggers(state);
+		log_to_console(state, parent, "Written to compiled_triggers.hpp");
+		log_to_console(state, parent, state.compiled_triggers_active ? "Compiled triggers are in use" : "Compiled triggers are not in use");
+		break;
+	}
+	case command_info::type::trigger_memoization:
+	{
+		state.cheat_data.trigger_memoization = not state.cheat_data.trigger_memoization;
+		log_to_console(state, parent, state.cheat_data.trigger_memoization ? "✔" : "✘");
+		break;
+	}
+	case command_info::type::parallel_effects:
+	{
+		state.cheat_data.parallel_effects = not state.cheat_data.parallel_effects;
+		log_to_console(state, parent, state.cheat_data.parallel_effects ? "✔" : "✘");
+		break;
+	}
+	case command_info::type::trigger_profiler:
+	{
+		if(std::holds_alternative<std::string>(pstate.arg_slots[0])) {
+			auto const k = std::get<std::string>(pstate.arg_slots[0]);
+			if(k == "toggle") {
+				state.cheat_data.trigger_profile = not state.cheat_data.trigger_profile;
+				log_to_console(state, parent, state.cheat_data.trigger_profile ? "✔" : "✘");
+			} else if(k == "reset") {
+				trigger_profile::reset();
+				log_to_console(state, parent, "✔");
+			} else if(k == "csv") {
+				trigger_profile::write_csv(state);
+				log_to_console(state, parent, "Written to trigger_profile.csv");
+			} else {
+				log_to_console(state, parent, "Valid options: toggle, reset, csv");
+			}
+			break;
+		}
+		auto summaries = trigger_profile::summarize();
+		if(summaries.empty()) {
+			log_to_console(state, parent, state.cheat_data.trigger_profile ? "No triggers have been sampled yet" : "The profiler is off, use \"trigprof toggle\"");
+			break;
+		}
+		auto owners = trigger_profile::trigger_owners(state);
+		for(size_t i = 0; i < std::min(summaries.size(), size_t(20)); ++i) {
+			auto& s = summaries[i];
+			auto const& owner = owners[s.key.index()];
+			log_to_console(state, parent, "\x95\xA7Y" + (owner.empty() ? "trigger " + std::to_string(s.key.index()) : owner) + "\xA7W: ~"
+				+ std::to_string(int64_t(s.estimated_total_ms)) + "ms, " + std::to_string(s.calls) + " calls, "
+				+ std::to_string(int64_t(s.mean_us * 1000.0)) + "ns each");
+		}
+		break;
+	}
 	case command_info::type::province_names:
 	{
 		state.cheat_data.province_names = not state.cheat_data.province_names;
@@ -229,7 +229,7 @@ public:
 				c.type = command::command_type::notify_save_loaded;
 				c.source = state.local_player_nation;
 				c.data.notify_save_loaded.target = dcon::nation_id{};
-				network::broadcast_save_to_clients(state, c, state.network_state.current_save_buffer.get(), state.network_state.current_save_length, state.network_state.current_save_checksum);
+				network::broadcast_save_to_clients(state, c);
 			} else {
 				state.fill_unsaved_data();
 			}
@@ -612,7 +612,7 @@ public:
 			bool old_disabled = disabled;
 			for(auto const& client : state.network_state.clients) {
 				if(client.is_active()) {
-					disabled = disabled || !client.send_buffer.empty();
+					disabled = disabled || client.has_pending_output();
 				}
 			}
 			button_element_base::render(state, x, y);
@@ -643,7 +643,7 @@ public:
 			}
 			for(auto const& client : state.network_state.clients) {
 				if(client.is_active()) {
-					if(!client.send_buffer.empty()) {
+					if(client.has_pending_output()) {
 						text::substitution_map sub;
 						text::add_to_substitution_map(sub, text::variable_type::playername, client.playing_as);
 						text::localised_format_box(state, contents, box, std::string_view("alice_play_pending_client"), sub);
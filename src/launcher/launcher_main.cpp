@@ -1015,6 +1015,7 @@ void make_mod_file() {
 				}
 				++max_scenario_count;
 				selected_scenario_file = base_name + NATIVE("-") + std::to_wstring(append) + NATIVE(".bin");
+				game_state->load_user_settings(); // for the scenario's compression settings
 				sys::write_scenario_file(*game_state, selected_scenario_file, max_scenario_count);
 				if(auto of = simple_fs::open_file(sdir, selected_scenario_file); of) {
 					auto content = view_contents(*of);
@@ -12,12 +12,15 @@
 #include "texture.cpp"
 #include "date_interface.cpp"
 #include "serialization.cpp"
+#include "tick_profiler.cpp"
 #include "nations.cpp"
 #include "culture.cpp"
 #include "military.cpp"
 #include "modifiers.cpp"
 #include "province.cpp"
 #include "triggers.cpp"
+#include "trigger_profiler.cpp"
+#include "trigger_compiler.cpp"
 #include "effects.cpp"
 #include "economy.cpp"
 #include "demographics.cpp"
@@ -14,9 +14,16 @@
 #include <sys/socket.h>
 #include <netdb.h>
 #include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <unistd.h>
 #endif // ...
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <string_view>
 #include "system_state.hpp"
 #include "commands.hpp"
@@ -28,6 +35,7 @@
 #define ZSTD_STATIC_LINKING_ONLY
 #define XXH_NAMESPACE ZSTD_
 #include "zstd.h"
+#include "blake2.h"
 
 namespace network {
 
@@ -61,13 +69,9 @@ std::string get_last_error_msg() {
 
 static int internal_socket_recv(socket_t socket_fd, void *data, size_t n) {
 #ifdef _WIN64
-	u_long has_pending = 0;
-	auto r = ioctlsocket(socket_fd, FIONREAD, &has_pending);
-	if(has_pending)
-		return static_cast<int>(recv(socket_fd, reinterpret_cast<char *>(data), static_cast<int>(n), 0));
-	return 0;
+	return static_cast<int>(recv(socket_fd, reinterpret_cast<char *>(data), static_cast<int>(n), 0));
 #else
-	return recv(socket_fd, data, n, MSG_DONTWAIT);
+	return static_cast<int>(recv(socket_fd, data, n, MSG_DONTWAIT));
 #endif
 }
 
@@ -75,59 +79,34 @@ static int internal_socket_send(socket_t socket_fd, const void *data, size_t n)
 #ifdef _WIN64
 	return static_cast<int>(send(socket_fd, reinterpret_cast<const char *>(data), static_cast<int>(n), 0));
 #else
-	return send(socket_fd, data, n, MSG_NOSIGNAL);
+	return static_cast<int>(send(socket_fd, data, n, MSG_NOSIGNAL | MSG_DONTWAIT));
 #endif
 }
 
-template<typename F>
-static int socket_recv(socket_t socket_fd, void* data, size_t len, size_t* m, F&& func) {
-	while(*m < len) {
-		int r = internal_socket_recv(socket_fd, reinterpret_cast<uint8_t*>(data) + *m, len - *m);
-		if(r > 0) {
-			*m += static_cast<size_t>(r);
-		} else if(r < 0) { // error
-#ifdef _WIN32
-			int err = WSAGetLastError();
-			if(err == WSAENOBUFS || err == WSAEWOULDBLOCK) {
-				return 0;
-			}
-			return err;
+static int32_t socket_last_error() {
+#ifdef _WIN64
+	return int32_t(WSAGetLastError());
 #else
-			return r;
+	return int32_t(errno);
 #endif
-		} else if(r == 0) {
-			break;
-		}
-	}
-	// Did we receive a command?
-	if(*m >= len) {
-		assert(*m <= len);
-		*m = 0; // reset
-		func();
-	}
-	return 0;
 }
 
-static int socket_send(socket_t socket_fd, std::vector<char>& buffer) {
-	while(!buffer.empty()) {
-		int r = internal_socket_send(socket_fd, buffer.data(), buffer.size());
-		if(r > 0) {
-			buffer.erase(buffer.begin(), buffer.begin() + static_cast<size_t>(r));
-		} else if(r < 0) {
-#ifdef _WIN32
-			int err = WSAGetLastError();
-			if(err == WSAENOBUFS || err == WSAEWOULDBLOCK) {
-				return 0;
-			}
-			return err;
+static bool socket_would_block() {
+#ifdef _WIN64
+	int err = WSAGetLastError();
+	return err == WSAENOBUFS || err == WSAEWOULDBLOCK;
 #else
-			return r;
+	return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
+
+static void socket_set_nonblocking(socket_t socket_fd) {
+#ifdef _WIN64
+	u_long mode = 1; // 1 to enable non-blocking socket
+	ioctlsocket(socket_fd, FIONBIO, &mode);
+#else
+	fcntl(socket_fd, F_SETFL, fcntl(socket_fd, F_GETFL, 0) | O_NONBLOCK);
 #endif
-		} else if(r == 0) {
-			break;
-		}
-	}
-	return 0;
 }
 
 static void socket_add_to_send_queue(std::vector<char>& buffer, const void *data, size_t n) {
@@ -201,10 +180,7 @@ static socket_t socket_init_server(bool as_v6, struct sockaddr_storage& server_a
 	if(listen(socket_fd, SOMAXCONN) < 0) {
 		window::emit_error_message("Network listen error: " + get_last_error_msg(), true);
 	}
-#ifdef _WIN64
-	u_long mode = 1; // 1 to enable non-blocking socket
-	ioctlsocket(socket_fd, FIONBIO, &mode);
-#endif
+	socket_set_nonblocking(socket_fd);
 	return socket_fd;
 }
 
@@ -249,6 +225,445 @@ static socket_t socket_init_client(bool& as_v6, struct sockaddr_storage& client_
 	return socket_fd;
 }
 
+//
+// frames
+//
+
+static sys::compression_parameters const frame_compression{ 1, 0, false, 0 };
+
+struct frame_decompression_context {
+	ZSTD_DCtx* context = nullptr;
+	~frame_decompression_context() {
+		if(context)
+			ZSTD_freeDCtx(context);
+	}
+};
+static thread_local frame_decompression_context frame_dctx;
+
+void append_frames(std::vector<char>& wire, char const* data, size_t size) {
+	for(size_t offset = 0; offset < size; offset += max_frame_payload) {
+		auto length = uint32_t(std::min(size - offset, size_t(max_frame_payload)));
+		auto old_size = wire.size();
+		wire.resize(old_size + sys::compressed_section_bound(length, frame_compression));
+		auto start = reinterpret_cast<uint8_t*>(wire.data() + old_size);
+		auto end = sys::write_compressed_section(start, reinterpret_cast<uint8_t const*>(data + offset), length, frame_compression);
+		wire.resize(old_size + size_t(end - start));
+	}
+}
+
+bool decode_frames(std::vector<char>& wire, std::vector<char>& out) {
+	// the stream comes from another machine, so unlike a save file nothing in it is trusted
+	size_t const max_frame_size = ZSTD_compressBound(max_frame_payload);
+	size_t offset = 0;
+	bool valid = true;
+	while(wire.size() - offset >= sizeof(uint32_t) * 2) {
+		uint32_t section_length = 0;
+		uint32_t decompressed_length = 0;
+		std::memcpy(&section_length, wire.data() + offset, sizeof(uint32_t));
+		std::memcpy(&decompressed_length, wire.data() + offset + sizeof(uint32_t), sizeof(uint32_t));
+		if(section_length == 0 || section_length > max_frame_size || decompressed_length == 0 || decompressed_length > max_frame_payload) {
+			valid = false; // also rejects stored and chunked sections, which are never sent
+			break;
+		}
+		if(wire.size() - offset < sizeof(uint32_t) * 2 + section_length)
+			break; // the rest of the frame hasn't arrived yet
+
+		if(!frame_dctx.context)
+			frame_dctx.context = ZSTD_createDCtx();
+		auto old_size = out.size();
+		out.resize(old_size + decompressed_length);
+		auto result = ZSTD_decompressDCtx(frame_dctx.context, out.data() + old_size, decompressed_length,
+				wire.data() + offset + sizeof(uint32_t) * 2, section_length);
+		if(ZSTD_isError(result) || result != decompressed_length) {
+			out.resize(old_size);
+			valid = false;
+			break;
+		}
+		offset += sizeof(uint32_t) * 2 + section_length;
+	}
+	wire.erase(wire.begin(), wire.begin() + offset);
+	return valid;
+}
+
+void append_wire_preamble(std::vector<char>& wire) {
+	uint32_t const preamble[2] = { wire_format_magic, wire_format_version };
+	wire.insert(wire.end(), reinterpret_cast<char const*>(preamble), reinterpret_cast<char const*>(preamble) + sizeof(preamble));
+}
+
+preamble_status read_wire_preamble(std::vector<char>& wire) {
+	if(wire.size() < wire_preamble_size)
+		return preamble_status::incomplete;
+	uint32_t preamble[2] = { 0, 0 };
+	std::memcpy(preamble, wire.data(), sizeof(preamble));
+	if(preamble[0] != wire_format_magic || preamble[1] != wire_format_version)
+		return preamble_status::rejected;
+	wire.erase(wire.begin(), wire.begin() + wire_preamble_size);
+	return preamble_status::accepted;
+}
+
+//
+// network thread
+//
+
+static void wake_io_thread(network_state& ns) {
+#ifndef _WIN64
+	if(ns.io_wake_fd >= 0) {
+		uint64_t one = 1;
+		auto r = write(ns.io_wake_fd, &one, sizeof(one));
+		(void)r;
+	}
+#endif
+}
+
+static void io_close(network_state& ns, connection& conn) {
+#ifndef _WIN64
+	if(conn.registered)
+		epoll_ctl(ns.io_epoll_fd, EPOLL_CTL_DEL, conn.socket_fd, nullptr);
+#endif
+	socket_shutdown(conn.socket_fd);
+	while(conn.outbound.front())
+		conn.outbound.pop();
+	conn.staged.clear();
+	conn.staged_offset = 0;
+	conn.wire_out.clear();
+	conn.wire_out_offset = 0;
+	conn.framed_bytes = 0;
+	conn.wire_in.clear();
+	conn.registered = false;
+	conn.preamble_sent = false;
+	conn.preamble_received = false;
+	conn.status.store(connection_status::idle, std::memory_order::release);
+}
+
+static void io_fail(network_state& ns, connection& conn, int32_t error) {
+#ifndef _WIN64
+	// a failed socket stays readable, so it would otherwise keep waking the thread until the game thread closes it
+	if(conn.registered) {
+		epoll_ctl(ns.io_epoll_fd, EPOLL_CTL_DEL, conn.socket_fd, nullptr);
+		conn.registered = false;
+	}
+#endif
+	conn.error = error;
+	// the game thread may have started closing it in the meantime, which takes precedence
+	auto expected = connection_status::open;
+	conn.status.compare_exchange_strong(expected, connection_status::failed, std::memory_order::acq_rel);
+}
+
+// frames as much of the queued stream as fits into one frame; false if nothing is queued
+static bool io_frame_output(connection& conn, std::vector<char>& batch) {
+	batch.clear();
+	while(batch.size() < max_frame_payload) {
+		if(conn.staged_offset == conn.staged.size()) {
+			auto* next = conn.outbound.front();
+			if(!next)
+				break;
+			conn.staged = std::move(*next);
+			conn.outbound.pop();
+			conn.staged_offset = 0;
+			continue;
+		}
+		auto n = std::min(size_t(max_frame_payload) - batch.size(), conn.staged.size() - conn.staged_offset);
+		batch.insert(batch.end(), conn.staged.begin() + conn.staged_offset, conn.staged.begin() + conn.staged_offset + n);
+		conn.staged_offset += n;
+	}
+	if(batch.empty())
+		return false;
+	append_frames(conn.wire_out, batch.data(), batch.size());
+	conn.framed_bytes = batch.size();
+	return true;
+}
+
+// writes frames until the queued stream is exhausted or the socket is full; false on error
+static bool io_write(network_state& ns, connection& conn, std::vector<char>& batch, bool& output_pending) {
+	while(true) {
+		if(conn.wire_out_offset == conn.wire_out.size()) {
+			conn.sent_bytes.fetch_add(conn.framed_bytes, std::memory_order::release);
+			conn.framed_bytes = 0;
+			conn.wire_out.clear();
+			conn.wire_out_offset = 0;
+			if(!io_frame_output(conn, batch))
+				return true;
+		}
+		int r = internal_socket_send(conn.socket_fd, conn.wire_out.data() + conn.wire_out_offset, conn.wire_out.size() - conn.wire_out_offset);
+		if(r > 0) {
+			conn.wire_out_offset += size_t(r);
+		} else if(r == 0 || socket_would_block()) {
+			output_pending = true;
+			return true;
+		} else {
+			io_fail(ns, conn, socket_last_error());
+			return false;
+		}
+	}
+}
+
+static void io_read(network_state& ns, connection& conn, bool& input_blocked) {
+	// the game thread consumes one buffer per connection per tick; until it catches up the socket is left alone
+	if(conn.inbound.size() >= conn.inbound.capacity()) {
+		input_blocked = true;
+		return;
+	}
+	constexpr size_t read_size = 64 * 1024;
+	constexpr size_t max_read_per_pass = 1024 * 1024;
+	size_t total = 0;
+	bool closed = false;
+	int32_t error = 0;
+	while(total < max_read_per_pass) {
+		auto old_size = conn.wire_in.size();
+		conn.wire_in.resize(old_size + read_size);
+		int r = internal_socket_recv(conn.socket_fd, conn.wire_in.data() + old_size, read_size);
+		if(r > 0) {
+			conn.wire_in.resize(old_size + size_t(r));
+			total += size_t(r);
+		} else {
+			conn.wire_in.resize(old_size);
+			if(r < 0 && socket_would_block())
+				break;
+			closed = true;
+			error = r < 0 ? socket_last_error() : 0;
+			break;
+		}
+	}
+	if(total > 0 && !conn.preamble_received) {
+		auto status = read_wire_preamble(conn.wire_in);
+		if(status == preamble_status::rejected) {
+			io_fail(ns, conn, wire_format_mismatch);
+			return;
+		}
+		conn.preamble_received = status == preamble_status::accepted;
+	}
+	if(total > 0 && conn.preamble_received) {
+		std::vector<char> decoded;
+		if(!decode_frames(conn.wire_in, decoded)) {
+			io_fail(ns, conn, 0);
+			return;
+		}
+		if(!decoded.empty())
+			conn.inbound.push(std::move(decoded));
+	}
+	if(closed)
+		io_fail(ns, conn, error);
+}
+
+static void io_service(network_state& ns, connection& conn, std::vector<char>& batch, bool& output_pending, bool& input_blocked) {
+	auto status = conn.status.load(std::memory_order::acquire);
+	if(status == connection_status::closing) {
+		bool ignored = false;
+		io_write(ns, conn, batch, ignored); // best effort, whatever was queued before closing
+		io_close(ns, conn);
+		return;
+	}
+	if(status != connection_status::open)
+		return;
+#ifndef _WIN64
+	if(!conn.registered) {
+		epoll_event ev{};
+		ev.events = EPOLLIN;
+		ev.data.ptr = &conn;
+		epoll_ctl(ns.io_epoll_fd, EPOLL_CTL_ADD, conn.socket_fd, &ev);
+		conn.registered = true;
+	}
+#endif
+	if(!conn.preamble_sent) { // goes out ahead of the first frame
+		append_wire_preamble(conn.wire_out);
+		conn.preamble_sent = true;
+	}
+	if(!io_write(ns, conn, batch, output_pending))
+		return;
+	io_read(ns, conn, input_blocked);
+}
+
+static void io_accept(network_state& ns) {
+	while(true) {
+		accepted_socket a;
+		socklen_t addr_len = sizeof(a.address);
+		a.socket_fd = accept(ns.socket_fd, (struct sockaddr*)&a.address, &addr_len);
+#ifdef _WIN64
+		if(a.socket_fd == static_cast<socket_t>(INVALID_SOCKET))
+			return;
+#else
+		if(a.socket_fd < 0)
+			return;
+#endif
+		socket_set_nonblocking(a.socket_fd);
+		if(!ns.accepted_sockets.try_push(a))
+			socket_shutdown(a.socket_fd);
+	}
+}
+
+static void io_thread_main(network_state& ns, bool as_host) {
+	std::vector<connection*> connections;
+	if(as_host) {
+		for(auto& client : ns.clients)
+			connections.push_back(&client.conn);
+	} else {
+		connections.push_back(&ns.host_connection);
+	}
+	std::vector<char> batch;
+#ifdef _WIN64
+	std::vector<WSAPOLLFD> fds;
+#else
+	epoll_event events[64];
+#endif
+	bool output_pending = false;
+	bool input_blocked = false;
+	while(ns.io_running.load(std::memory_order::acquire)) {
+		if(input_blocked) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		} else {
+#ifdef _WIN64
+			// there is nothing to wake WSAPoll with, so it waits no longer than the old select did
+			fds.clear();
+			if(as_host)
+				fds.push_back(WSAPOLLFD{ ns.socket_fd, POLLRDNORM, 0 });
+			for(auto c : connections) {
+				if(c->status.load(std::memory_order::acquire) == connection_status::open)
+					fds.push_back(WSAPOLLFD{ c->socket_fd, short(output_pending ? (POLLRDNORM | POLLWRNORM) : POLLRDNORM), 0 });
+			}
+			if(fds.empty())
+				Sleep(1);
+			else
+				WSAPoll(fds.data(), ULONG(fds.size()), 1);
+#else
+			// sockets with unsent output are retried every millisecond rather than waited on
+			int n = epoll_wait(ns.io_epoll_fd, events, 64, output_pending ? 1 : -1);
+			for(int i = 0; i < n; ++i) {
+				if(events[i].data.ptr == nullptr) {
+					uint64_t count = 0;
+					auto r = read(ns.io_wake_fd, &count, sizeof(count));
+					(void)r;
+				}
+			}
+#endif
+		}
+		output_pending = false;
+		input_blocked = false;
+		if(as_host)
+			io_accept(ns);
+		for(auto c : connections)
+			io_service(ns, *c, batch, output_pending, input_blocked);
+	}
+	for(auto c : connections) {
+		if(c->status.load(std::memory_order::acquire) != connection_status::idle)
+			io_close(ns, *c);
+	}
+}
+
+static void start_io_thread(network_state& ns, bool as_host) {
+#ifndef _WIN64
+	ns.io_epoll_fd = epoll_create1(0);
+	ns.io_wake_fd = eventfd(0, EFD_NONBLOCK);
+	epoll_event ev{};
+	ev.events = EPOLLIN;
+	ev.data.ptr = nullptr;
+	epoll_ctl(ns.io_epoll_fd, EPOLL_CTL_ADD, ns.io_wake_fd, &ev);
+	if(as_host) {
+		ev.data.ptr = &ns;
+		epoll_ctl(ns.io_epoll_fd, EPOLL_CTL_ADD, ns.socket_fd, &ev);
+	}
+#endif
+	ns.io_running.store(true, std::memory_order::release);
+	ns.io_thread = std::thread([&ns, as_host]() { io_thread_main(ns, as_host); });
+}
+
+void network_state::stop_io_thread() {
+	if(!io_thread.joinable())
+		return;
+	io_running.store(false, std::memory_order::release);
+	wake_io_thread(*this);
+	io_thread.join();
+#ifndef _WIN64
+	close(io_wake_fd);
+	close(io_epoll_fd);
+	io_wake_fd = -1;
+	io_epoll_fd = -1;
+#endif
+}
+
+//
+// game thread side of a connection
+//
+
+static void open_connection(network_state& ns, connection& conn, socket_t socket_fd) {
+	assert(conn.status.load(std::memory_order::acquire) == connection_status::idle);
+	while(conn.inbound.front())
+		conn.inbound.pop();
+	conn.received.clear();
+	conn.received_offset = 0;
+	conn.queued_bytes = 0;
+	conn.sent_bytes.store(0, std::memory_order::relaxed);
+	conn.error = 0;
+	conn.socket_fd = socket_fd;
+	conn.status.store(connection_status::open, std::memory_order::release);
+	wake_io_thread(ns);
+}
+
+static void close_connection(network_state& ns, connection& conn) {
+	auto status = conn.status.load(std::memory_order::acquire);
+	if(status == connection_status::open || status == connection_status::failed) {
+		conn.status.store(connection_status::closing, std::memory_order::release);
+		wake_io_thread(ns);
+	}
+}
+
+static std::string connection_error_msg(connection const& conn) {
+	if(conn.error == 0)
+		return std::string("connection closed");
+	if(conn.error == wire_format_mismatch)
+		return std::string("the other side runs an incompatible version of the game");
+#ifdef _WIN64
+	return get_wsa_error_text(conn.error);
+#else
+	return std::to_string(conn.error) + " = " + std::strerror(conn.error);
+#endif
+}
+
+// fills data from the received stream, calling func once all len bytes have arrived; non-zero once the connection has failed
+// and everything it received has been consumed
+template<typename F>
+static int stream_recv(connection& conn, void* data, size_t len, size_t* m, F&& func) {
+	while(*m < len) {
+		if(conn.received_offset == conn.received.size()) {
+			auto* next = conn.inbound.front();
+			if(!next)
+				break;
+			conn.received = std::move(*next);
+			conn.inbound.pop();
+			conn.received_offset = 0;
+			continue;
+		}
+		auto n = std::min(len - *m, conn.received.size() - conn.received_offset);
+		std::memcpy(reinterpret_cast<uint8_t*>(data) + *m, conn.received.data() + conn.received_offset, n);
+		conn.received_offset += n;
+		*m += n;
+	}
+	// Did we receive a command?
+	if(*m >= len) {
+		assert(*m <= len);
+		*m = 0; // reset
+		func();
+		return 0;
+	}
+	if(conn.status.load(std::memory_order::acquire) == connection_status::failed && conn.inbound.empty())
+		return conn.error != 0 ? int(conn.error) : -1;
+	return 0;
+}
+
+// hands the buffer to the network thread, leaving it empty; if the network thread is behind, it is kept for the next call
+static int stream_send(network_state& ns, connection& conn, std::vector<char>& buffer) {
+	if(conn.status.load(std::memory_order::acquire) == connection_status::failed)
+		return conn.error != 0 ? int(conn.error) : -1;
+	if(buffer.empty())
+		return 0;
+	auto size = buffer.size();
+	if(conn.outbound.try_push(std::move(buffer))) {
+		conn.queued_bytes += size;
+		buffer.clear();
+		wake_io_thread(ns);
+	}
+	return 0;
+}
+
 //
 // non-platform specific
 //
@@ -285,9 +700,13 @@ void init(sys::state& state) {
 #endif
 	if(state.network_mode == sys::network_mode_type::host) {
 		state.network_state.socket_fd = socket_init_server(state.network_state.as_v6, state.network_state.address);
+		start_io_thread(state.network_state, true);
 	} else {
 		assert(state.network_state.ip_address.size() > 0);
-		state.network_state.socket_fd = socket_init_client(state.network_state.as_v6, state.network_state.address, state.network_state.ip_address.c_str());
+		auto socket_fd = socket_init_client(state.network_state.as_v6, state.network_state.address, state.network_state.ip_address.c_str());
+		socket_set_nonblocking(socket_fd);
+		open_connection(state.network_state, state.network_state.host_connection, socket_fd);
+		start_io_thread(state.network_state, false);
 	}
 
 	// Host must have an already selected nation, to prevent issues...
@@ -308,7 +727,7 @@ static void disconnect_client(sys::state& state, client_data& client, bool grace
 	if(command::can_notify_player_leaves(state, client.playing_as, graceful)) {
 		command::notify_player_leaves(state, client.playing_as, graceful);
 	}
-	socket_shutdown(client.socket_fd);
+	close_connection(state.network_state, client.conn);
 	client.socket_fd = 0;
 	client.send_buffer.clear();
 	client.early_send_buffer.clear();
@@ -318,27 +737,54 @@ static void disconnect_client(sys::state& state, client_data& client, bool grace
 	client.playing_as = dcon::nation_id{};
 	client.recv_count = 0;
 	client.handshake = true;
+	client.receives_save_delta = false;
+}
+
+static uint8_t* write_network_compressed_section(sys::state& state, uint8_t* ptr_out, uint8_t const* ptr_in, uint32_t uncompressed_size) {
+	return sys::write_compressed_section(ptr_out, ptr_in, uncompressed_size, state.user_settings.network_compression);
 }
 
-static uint8_t* write_network_compressed_section(uint8_t* ptr_out, uint8_t const* ptr_in, uint32_t uncompressed_size) {
-	uint32_t decompressed_length = uncompressed_size;
-	uint32_t section_length = uint32_t(ZSTD_compress(ptr_out + sizeof(uint32_t) * 2, ZSTD_compressBound(uncompressed_size), ptr_in,
-		uncompressed_size, ZSTD_maxCLevel())); // write compressed data
-	memcpy(ptr_out, &section_length, sizeof(uint32_t));
-	memcpy(ptr_out + sizeof(uint32_t), &decompressed_length, sizeof(uint32_t));
-	return ptr_out + sizeof(uint32_t) * 2 + section_length;
+// every player has the scenario file, so its save section is read once and the saves sent over the network are deltas against it;
+// it is read again once a different scenario has been loaded
+static std::vector<uint8_t> const& scenario_save_reference(sys::state& state) {
+	auto& ns = state.network_state;
+	if(ns.scenario_save.empty() || !ns.scenario_save_source.is_equal(state.scenario_checksum)) {
+		ns.scenario_save.clear();
+		sys::read_scenario_save_section(state, ns.scenario_save);
+		blake2b(&ns.scenario_save_checksum, sizeof(ns.scenario_save_checksum), ns.scenario_save.data(), ns.scenario_save.size(), nullptr,
+				0);
+		ns.scenario_save_source = state.scenario_checksum;
+	}
+	return ns.scenario_save;
 }
 
+// A network save starts with the checksum of the save section that it is a delta against, or with an empty key if it holds the
+// whole section, followed by the compressed section itself
 template<typename T>
-static uint8_t const* with_network_decompressed_section(uint8_t const* ptr_in, T const& function) {
-	uint32_t section_length = 0;
-	uint32_t decompressed_length = 0;
-	memcpy(&section_length, ptr_in, sizeof(uint32_t));
-	memcpy(&decompressed_length, ptr_in + sizeof(uint32_t), sizeof(uint32_t));
-	auto temp_buffer = std::unique_ptr<uint8_t[]>(new uint8_t[decompressed_length]);
-	ZSTD_decompress(temp_buffer.get(), decompressed_length, ptr_in + sizeof(uint32_t) * 2, section_length);
-	function(temp_buffer.get(), decompressed_length);
-	return ptr_in + sizeof(uint32_t) * 2 + section_length;
+static bool with_network_save_section(sys::state& state, uint8_t const* ptr_in, T const& function) {
+	sys::checksum_key base;
+	std::memcpy(&base, ptr_in, sizeof(base));
+	ptr_in += sizeof(base);
+	uint8_t const* data = nullptr;
+	uint32_t length = 0;
+	if(base.is_equal(sys::checksum_key{})) {
+		sys::decompress_section(ptr_in, data, length);
+		function(data, length);
+		sys::trim_decompression_buffer();
+		return true;
+	}
+
+	auto const& reference = scenario_save_reference(state); // first, as reading it reuses the decompression buffer
+	if(!base.is_equal(state.network_state.scenario_save_checksum))
+		return false;
+	sys::decompress_section(ptr_in, data, length);
+	std::vector<uint8_t> section;
+	bool const reconstructed = sys::apply_save_delta(section, data, length, reference.data(), reference.size());
+	sys::trim_decompression_buffer();
+	if(!reconstructed)
+		return false;
+	function(section.data(), uint32_t(section.size()));
+	return true;
 }
 
 bool client_data::is_banned(sys::state& state) const {
@@ -366,7 +812,7 @@ static void send_post_handshake_commands(sys::state& state, network::client_data
 			c.type = command::command_type::notify_save_loaded;
 			c.source = state.local_player_nation;
 			c.data.notify_save_loaded.target = client.playing_as;
-			network::broadcast_save_to_clients(state, c, state.network_state.current_save_buffer.get(), state.network_state.current_save_length, state.network_state.current_save_checksum);
+			network::broadcast_save_to_clients(state, c);
 #ifndef NDEBUG
 			state.console_log("host:send:cmd: (new(2)->save_loaded)");
 #endif
@@ -429,7 +875,7 @@ static void send_post_handshake_commands(sys::state& state, network::client_data
 			network::write_network_save(state);
 			/* Then reload as if we loaded the save data */
 			state.preload();
-			with_network_decompressed_section(state.network_state.current_save_buffer.get(), [&state](uint8_t const* ptr_in, uint32_t length) {
+			with_network_save_section(state, state.network_state.current_save_buffer.get(), [&state](uint8_t const* ptr_in, uint32_t length) {
 				read_save_section(ptr_in, ptr_in + length, state);
 			});
 			state.fill_unsaved_data();
@@ -458,7 +904,7 @@ static void send_post_handshake_commands(sys::state& state, network::client_data
 				c.type = command::command_type::notify_save_loaded;
 				c.source = state.local_player_nation;
 				c.data.notify_save_loaded.target = client.playing_as;
-				network::broadcast_save_to_clients(state, c, state.network_state.current_save_buffer.get(), state.network_state.current_save_length, state.network_state.current_save_checksum);
+				network::broadcast_save_to_clients(state, c);
 #ifndef NDEBUG
 				state.console_log("host:send:cmd: (new->save_loaded)");
 #endif
@@ -486,18 +932,21 @@ static void receive_from_clients(sys::state& state) {
 			continue;
 		int r = 0;
 		if(client.handshake) {
-			r = socket_recv(client.socket_fd, &client.hshake_buffer, sizeof(client.hshake_buffer), &client.recv_count, [&]() {
+			r = stream_recv(client.conn, &client.hshake_buffer, sizeof(client.hshake_buffer), &client.recv_count, [&]() {
 				if(std::memcmp(client.hshake_buffer.password, state.network_state.password, sizeof(state.network_state.password)) != 0) {
 					disconnect_client(state, client, false);
 					return;
 				}
+				// a client with a different scenario save section is sent whole saves rather than deltas
+				scenario_save_reference(state);
+				client.receives_save_delta = client.hshake_buffer.scenario_save_checksum.is_equal(state.network_state.scenario_save_checksum);
 				send_post_handshake_commands(state, client);
 				/* Exit from handshake mode */
 				client.handshake = false;
 				state.game_state_updated.store(true, std::memory_order::release);
 			});
 		} else {
-			r = socket_recv(client.socket_fd, &client.recv_buffer, sizeof(client.recv_buffer), &client.recv_count, [&]() {
+			r = stream_recv(client.conn, &client.recv_buffer, sizeof(client.recv_buffer), &client.recv_count, [&]() {
 				switch(client.recv_buffer.type) {
 				case command::command_type::invalid:
 				case command::command_type::notify_player_ban:
@@ -526,14 +975,23 @@ static void receive_from_clients(sys::state& state) {
 			});
 		}
 		if(r != 0) { // error
-#if !defined(NDEBUG) && defined(_WIN32)
-			state.console_log("host:disconnect: in-receive err=" + std::to_string(int32_t(r)) + "::" + get_last_error_msg());
+#ifndef NDEBUG
+			state.console_log("host:disconnect: in-receive err=" + std::to_string(int32_t(r)) + "::" + connection_error_msg(client.conn));
 #endif
 			network::disconnect_client(state, client, false);
 		}
 	}
 }
 
+static uint32_t write_network_save_buffer(sys::state& state, std::unique_ptr<uint8_t[]>& buffer, sys::checksum_key const& base,
+		uint8_t const* section, uint32_t size) {
+	// this is an upper bound, since compacting the data may require less space
+	buffer.reset(new uint8_t[sizeof(base) + sys::compressed_section_bound(size, state.user_settings.network_compression)]);
+	std::memcpy(buffer.get(), &base, sizeof(base));
+	auto buffer_position = write_network_compressed_section(state, buffer.get() + sizeof(base), section, size);
+	return uint32_t(buffer_position - buffer.get());
+}
+
 void write_network_save(sys::state& state) {
 	/* A save lock will be set when we load a save, naturally loading a save implies
 	that we have done preload/fill_unsaved so we will skip doing that again, to save a
@@ -543,28 +1001,47 @@ void write_network_save(sys::state& state) {
 	/* Clear the player nation */
 	assert(state.local_player_nation == dcon::nation_id{ });
 	write_save_section(save_buffer.get(), state); //writeoff data
-	// this is an upper bound, since compacting the data may require less space
-	state.network_state.current_save_buffer.reset(new uint8_t[ZSTD_compressBound(length) + sizeof(uint32_t) * 2]);
-	auto buffer_position = write_network_compressed_section(state.network_state.current_save_buffer.get(), save_buffer.get(), uint32_t(length));
-	state.network_state.current_save_length = uint32_t(buffer_position - state.network_state.current_save_buffer.get());
+	auto const& reference = scenario_save_reference(state);
+	std::vector<uint8_t> delta;
+	sys::write_save_delta(delta, save_buffer.get(), length, sys::save_section_dcon_offset(state), reference.data(), reference.size(),
+			state.scenario_save_dcon_offset);
+	state.network_state.current_save_length = write_network_save_buffer(state, state.network_state.current_save_buffer,
+			state.network_state.scenario_save_checksum, delta.data(), uint32_t(delta.size()));
+	state.network_state.current_full_save_buffer.reset();
+	state.network_state.current_full_save_length = 0;
 	state.network_state.current_save_checksum = state.get_save_checksum();
 }
 
-void broadcast_save_to_clients(sys::state& state, command::payload& c, uint8_t const* buffer, uint32_t length, sys::checksum_key const& k) {
-	assert(length > 0);
+// the whole save section, for the clients that cannot apply the delta; rebuilt from the delta when the first such client needs it
+static void write_full_network_save(sys::state& state) {
+	auto& ns = state.network_state;
+	if(ns.current_full_save_buffer)
+		return;
+	with_network_save_section(state, ns.current_save_buffer.get(), [&](uint8_t const* ptr_in, uint32_t length) {
+		ns.current_full_save_length = write_network_save_buffer(state, ns.current_full_save_buffer, sys::checksum_key{}, ptr_in, length);
+	});
+}
+
+void broadcast_save_to_clients(sys::state& state, command::payload& c) {
+	auto& ns = state.network_state;
+	assert(ns.current_save_length > 0);
 	assert(c.type == command::command_type::notify_save_loaded);
-	c.data.notify_save_loaded.checksum = k;
-	for(auto& client : state.network_state.clients) {
+	c.data.notify_save_loaded.checksum = ns.current_save_checksum;
+	for(auto& client : ns.clients) {
 		if(!client.is_active())
 			continue;
 		bool send_full = (client.playing_as == c.data.notify_save_loaded.target) || (!c.data.notify_save_loaded.target);
-		if(send_full && !state.network_state.is_new_game) {
+		if(send_full && !ns.is_new_game) {
+			if(!client.receives_save_delta)
+				write_full_network_save(state);
+			auto buffer = client.receives_save_delta ? ns.current_save_buffer.get() : ns.current_full_save_buffer.get();
+			auto length = client.receives_save_delta ? ns.current_save_length : ns.current_full_save_length;
 			/* And then we have to first send the command payload itself */
 			client.save_stream_size = size_t(length);
 			c.data.notify_save_loaded.length = size_t(length);
 			socket_add_to_send_queue(client.send_buffer, &c, sizeof(c));
 			/* And then the bulk payload! */
-			client.save_stream_offset = client.total_sent_bytes + client.send_buffer.size();
+			client.save_stream_offset = client.conn.queued_bytes + client.send_buffer.size();
 			socket_add_to_send_queue(client.send_buffer, buffer, size_t(length));
 #ifndef NDEBUG
 			state.console_log("host:send:save: " + std::to_string(uint32_t(length)));
@@ -587,28 +1064,35 @@ void broadcast_to_clients(sys::state& state, command::payload& c) {
 
 static void accept_new_clients(sys::state& state) {
 	/* Check if any new clients are to join us */
-	fd_set rfds;
-	FD_ZERO(&rfds);
-	FD_SET(state.network_state.socket_fd, &rfds);
-	struct timeval tv{};
-	tv.tv_sec = 0;
-	tv.tv_usec = 1000;
-	if(select(socket_t(int(state.network_state.socket_fd) + 1), &rfds, nullptr, nullptr, &tv) <= 0)
-		return;
-	
-	// Find available slot for client
-	for(auto& client : state.network_state.clients) {
-		if(client.is_active())
+	auto* accepted = state.network_state.accepted_sockets.front();
+	while(accepted) {
+		auto a = *accepted;
+		state.network_state.accepted_sockets.pop();
+		accepted = state.network_state.accepted_sockets.front();
+
+		// Find available slot for client, the network thread may still be closing the connection of one that left
+		client_data* slot = nullptr;
+		for(auto& client : state.network_state.clients) {
+			if(!client.is_active() && client.conn.status.load(std::memory_order::acquire) == connection_status::idle) {
+				slot = &client;
+				break;
+			}
+		}
+		if(!slot) {
+			socket_shutdown(a.socket_fd);
 			continue;
-		socklen_t addr_len = state.network_state.as_v6 ? sizeof(sockaddr_in6) : sizeof(sockaddr_in);
-		client.socket_fd = accept(state.network_state.socket_fd, (struct sockaddr*)&client.address, &addr_len);
+		}
+		auto& client = *slot;
+		client.socket_fd = a.socket_fd;
+		client.address = a.address;
+		open_connection(state.network_state, client.conn, a.socket_fd);
 		if(client.is_banned(state)) {
 			disconnect_client(state, client, false);
-			break;
+			continue;
 		}
 		if(state.mode == sys::game_mode_type::end_screen) {
 			disconnect_client(state, client, false);
-			break;
+			continue;
 		}
 		/* Send it data so she is in sync with everyone else! */
 		client.playing_as = get_temp_nation(state);
@@ -624,7 +1108,6 @@ static void accept_new_clients(sys::state& state) {
 #ifndef NDEBUG
 		state.console_log("host:send:cmd: handshake -> " + std::to_string(client.playing_as.index()));
 #endif
-		return;
 	}
 }
 
@@ -667,49 +1150,25 @@ void send_and_receive_commands(sys::state& state) {
 			c = state.network_state.outgoing_commands.front();
 		}
 
+		// hand what was queued this tick to the network thread, which sends it as one frame
 		for(auto& client : state.network_state.clients) {
 			if(!client.is_active())
 				continue;
-			if(client.handshake) {
-				if(client.early_send_buffer.size() > 0) {
-					size_t old_size = client.early_send_buffer.size();
-					int r = socket_send(client.socket_fd, client.early_send_buffer);
-					if(r != 0) { // error
-#if !defined(NDEBUG) && defined(_WIN32)
-						state.console_log("host:disconnect: in-send-EARLY err=" + std::to_string(int32_t(r)) + "::" + get_last_error_msg());
-#endif
-						disconnect_client(state, client, false);
-						continue;
-					}
-					client.total_sent_bytes += old_size - client.early_send_buffer.size();
-#ifndef NDEBUG
-					if(old_size != client.early_send_buffer.size())
-						state.console_log("host:send:stats: [EARLY] " + std::to_string(uint32_t(client.total_sent_bytes)) + " bytes");
-#endif
-				}
-			} else {
-				if(client.send_buffer.size() > 0) {
-					size_t old_size = client.send_buffer.size();
-					int r = socket_send(client.socket_fd, client.send_buffer);
-					if(r != 0) { // error
-#if !defined(NDEBUG) && defined(_WIN32)
-						state.console_log("host:disconnect: in-send-INGAME err=" + std::to_string(int32_t(r)) + "::" + get_last_error_msg());
-#endif
-						disconnect_client(state, client, false);
-						continue;
-					}
-					client.total_sent_bytes += old_size - client.send_buffer.size();
+			auto& buffer = client.handshake ? client.early_send_buffer : client.send_buffer;
+			int r = stream_send(state.network_state, client.conn, buffer);
+			if(r != 0) { // error
 #ifndef NDEBUG
-					if(old_size != client.send_buffer.size())
-						state.console_log("host:send:stats: [SEND] " + std::to_string(uint32_t(client.total_sent_bytes)) + " bytes");
+				state.console_log("host:disconnect: in-send err=" + std::to_string(int32_t(r)) + "::" + connection_error_msg(client.conn));
 #endif
-				}
+				disconnect_client(state, client, false);
+				continue;
 			}
+			client.total_sent_bytes = client.conn.sent_bytes.load(std::memory_order::acquire);
 		}
 	} else if(state.network_mode == sys::network_mode_type::client) {
 		if(state.network_state.handshake) {
 			/* Send our client's handshake */
-			int r = socket_recv(state.network_state.socket_fd, &state.network_state.s_hshake, sizeof(state.network_state.s_hshake), &state.network_state.recv_count, [&]() {
+			int r = stream_recv(state.network_state.host_connection, &state.network_state.s_hshake, sizeof(state.network_state.s_hshake), &state.network_state.recv_count, [&]() {
 #ifndef NDEBUG
 				state.console_log("client:recv:handshake: OK");
 #endif
@@ -730,6 +1189,7 @@ void send_and_receive_commands(sys::state& state) {
 									continue; // Same version of scenario
 								if(sys::try_read_scenario_and_save_file(state, simple_fs::get_file_name(uf))) {
 									state.fill_unsaved_data();
+									state.network_state.scenario_save.clear();
 									found_match = true;
 									break;
 								}
@@ -748,16 +1208,18 @@ void send_and_receive_commands(sys::state& state) {
 				client_handshake_data hshake;
 				hshake.nickname = state.network_state.nickname;
 				std::memcpy(hshake.password, state.network_state.password, sizeof(hshake.password));
+				scenario_save_reference(state);
+				hshake.scenario_save_checksum = state.network_state.scenario_save_checksum;
 				socket_add_to_send_queue(state.network_state.send_buffer, &hshake, sizeof(hshake));
 				state.network_state.handshake = false;
 			});
 			if(r != 0) { // error
-				ui::popup_error_window(state, "Network Error", "Network client handshake receive error: " + get_last_error_msg());
+				ui::popup_error_window(state, "Network Error", "Network client handshake receive error: " + connection_error_msg(state.network_state.host_connection));
 				network::finish(state, false);
 				return;
 			}
 		} else if(state.network_state.save_stream) {
-			int r = socket_recv(state.network_state.socket_fd, state.network_state.save_data.data(), state.network_state.save_data.size(), &state.network_state.recv_count, [&]() {
+			int r = stream_recv(state.network_state.host_connection, state.network_state.save_data.data(), state.network_state.save_data.size(), &state.network_state.recv_count, [&]() {
 #ifndef NDEBUG
 				state.console_log("client:recv:save: len=" + std::to_string(uint32_t(state.network_state.save_data.size())));
 #endif
@@ -767,9 +1229,14 @@ void send_and_receive_commands(sys::state& state) {
 						players.push_back(n);
 				dcon::nation_id old_local_player_nation = state.local_player_nation;
 				state.preload();
-				with_network_decompressed_section(state.network_state.save_data.data(), [&state](uint8_t const* ptr_in, uint32_t length) {
+				bool loaded = with_network_save_section(state, state.network_state.save_data.data(), [&state](uint8_t const* ptr_in, uint32_t length) {
 					read_save_section(ptr_in, ptr_in + length, state);
 				});
+				if(!loaded) {
+					ui::popup_error_window(state, "Network Error", "Network client save stream could not be read");
+					network::finish(state, false);
+					return;
+				}
 				state.local_player_nation = dcon::nation_id{ };
 				state.fill_unsaved_data();
 				for(const auto n : players)
@@ -786,13 +1253,13 @@ void send_and_receive_commands(sys::state& state) {
 				state.network_state.save_stream = false; // go back to normal command loop stuff
 			});
 			if(r != 0) { // error
-				ui::popup_error_window(state, "Network Error", "Network client save stream receive error: " + get_last_error_msg());
+				ui::popup_error_window(state, "Network Error", "Network client save stream receive error: " + connection_error_msg(state.network_state.host_connection));
 				network::finish(state, false);
 				return;
 			}
 		} else {
 			// receive commands from the server and immediately execute them
-			int r = socket_recv(state.network_state.socket_fd, &state.network_state.recv_buffer, sizeof(state.network_state.recv_buffer), &state.network_state.recv_count, [&]() {
+			int r = stream_recv(state.network_state.host_connection, &state.network_state.recv_buffer, sizeof(state.network_state.recv_buffer), &state.network_state.recv_count, [&]() {
 				command::execute_command(state, state.network_state.recv_buffer);
 				command_executed = true;
 				// start save stream!
@@ -812,7 +1279,7 @@ void send_and_receive_commands(sys::state& state) {
 #endif
 			});
 			if(r != 0) { // error
-				ui::popup_error_window(state, "Network Error", "Network client command receive error: " + get_last_error_msg());
+				ui::popup_error_window(state, "Network Error", "Network client command receive error: " + connection_error_msg(state.network_state.host_connection));
 				network::finish(state, false);
 				return;
 			}
@@ -834,8 +1301,8 @@ void send_and_receive_commands(sys::state& state) {
 		}
 		/* Do not send commands while we're on save stream mode! */
 		if(!state.network_state.save_stream) {
-			if(socket_send(state.network_state.socket_fd, state.network_state.send_buffer) != 0) { // error
-				ui::popup_error_window(state, "Network Error", "Network client command send error: " + get_last_error_msg());
+			if(stream_send(state.network_state, state.network_state.host_connection, state.network_state.send_buffer) != 0) { // error
+				ui::popup_error_window(state, "Network Error", "Network client command send error: " + connection_error_msg(state.network_state.host_connection));
 				network::finish(state, false);
 				return;
 			}
@@ -878,16 +1345,25 @@ void finish(sys::state& state, bool notify_host) {
 			c.source = state.local_player_nation;
 			c.data.notify_leave.make_ai = true;
 			socket_add_to_send_queue(state.network_state.send_buffer, &c, sizeof(c));
-			while(state.network_state.send_buffer.size() > 0) {
-				if(socket_send(state.network_state.socket_fd, state.network_state.send_buffer) != 0) { // error
-					//ui::popup_error_window(state, "Network Error", "Network client command send error: " + get_last_error_msg());
+			// give the network thread a moment to deliver the goodbye before the connection is closed
+			auto& conn = state.network_state.host_connection;
+			auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+			while(std::chrono::steady_clock::now() < deadline) {
+				if(stream_send(state.network_state, conn, state.network_state.send_buffer) != 0) // error
 					break;
-				}
+				if(state.network_state.send_buffer.empty() && conn.sent_bytes.load(std::memory_order::acquire) >= conn.queued_bytes)
+					break;
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
 			}
 		}
 	}
-	
+
+	close_connection(state.network_state, state.network_state.host_connection);
+	for(auto& client : state.network_state.clients)
+		close_connection(state.network_state, client.conn);
+	state.network_state.stop_io_thread();
 	socket_shutdown(state.network_state.socket_fd);
+	state.network_state.socket_fd = 0;
 #ifdef _WIN64
 	WSACleanup();
 #endif
@@ -896,7 +1372,7 @@ void finish(sys::state& state, bool notify_host) {
 void ban_player(sys::state& state, client_data& client) {
 	if(!client.is_active())
 		return;
-	socket_shutdown(client.socket_fd);
+	close_connection(state.network_state, client.conn);
 	client.socket_fd = 0;
 	if(state.network_state.as_v6) {
 		auto sa = (struct sockaddr_in6*)&client.address;
@@ -910,7 +1386,7 @@ void ban_player(sys::state& state, client_data& client) {
 void kick_player(sys::state& state, client_data& client) {
 	if(!client.is_active())
 		return;
-	socket_shutdown(client.socket_fd);
+	close_connection(state.network_state, client.conn);
 	client.socket_fd = 0;
 }
 
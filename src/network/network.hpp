@@ -1,7 +1,10 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <string>
+#include <thread>
+#include <vector>
 #ifdef _WIN64 // WINDOWS
 #define _WINSOCK_DEPRECATED_NO_WARNINGS 1
 #ifndef WINSOCK2_IMPORTED
@@ -34,6 +37,7 @@ typedef int socket_t;
 struct client_handshake_data {
 	sys::player_name nickname;
 	uint8_t password[16] = {0};
+	sys::checksum_key scenario_save_checksum; // of the save section that the client would apply a save delta to
 	uint8_t reserved[48] = {0};
 };
 
@@ -45,10 +49,71 @@ struct server_handshake_data {
 	uint8_t reserved[64] = {0};
 };
 
+// Sockets are only read and written by the network thread, which frames and compresses the outgoing stream of every connection
+// and decodes the incoming one. The game thread exchanges plain stream bytes with it through the queues, so it never waits on a
+// socket. A connection is opened by the game thread while idle, and only the network thread returns it to idle.
+enum class connection_status : uint8_t {
+	idle, open, closing, failed
+};
+
+struct connection {
+	rigtorp::SPSCQueue<std::vector<char>> outbound{ 64 }; // game thread -> network thread
+	rigtorp::SPSCQueue<std::vector<char>> inbound{ 64 }; // network thread -> game thread
+	std::atomic<connection_status> status = connection_status::idle;
+	std::atomic<size_t> sent_bytes = 0; // stream bytes whose frames have been written to the socket
+	socket_t socket_fd = 0;
+	int32_t error = 0; // set by the network thread before it marks the connection as failed; 0 if the peer closed it
+
+	// game thread only
+	size_t queued_bytes = 0; // stream bytes handed to the network thread
+	std::vector<char> received;
+	size_t received_offset = 0;
+
+	// network thread only
+	std::vector<char> staged; // the queued buffer currently being framed
+	size_t staged_offset = 0;
+	std::vector<char> wire_out;
+	size_t wire_out_offset = 0;
+	size_t framed_bytes = 0; // stream bytes contained in wire_out
+	std::vector<char> wire_in;
+	bool registered = false;
+	bool preamble_sent = false;
+	bool preamble_received = false;
+};
+
+// A frame is a compressed section (see serialization.hpp) holding at most max_frame_payload bytes of the stream; everything
+// queued for a connection when the network thread gets to it goes into the same frame, so that a tick's worth of commands is
+// compressed together.
+inline constexpr uint32_t max_frame_payload = 256 * 1024;
+
+void append_frames(std::vector<char>& wire, char const* data, size_t size);
+// moves the payload of the complete frames at the start of wire to the end of out; false if the stream is malformed
+bool decode_frames(std::vector<char>& wire, std::vector<char>& out);
+
+// Each side starts its stream with the magic number and the wire format version before any frame, and drops a peer that
+// sends anything else. The version is to be bumped whenever the frames, the handshakes or the commands change their layout.
+inline constexpr uint32_t wire_format_magic = 0x414C4943; // "ALIC"
+inline constexpr uint32_t wire_format_version = 2;
+inline constexpr size_t wire_preamble_size = sizeof(uint32_t) * 2;
+inline constexpr int32_t wire_format_mismatch = -2; // connection::error of a peer that sent another preamble
+
+enum class preamble_status : uint8_t {
+	incomplete, accepted, rejected
+};
+void append_wire_preamble(std::vector<char>& wire);
+// checks and removes the preamble at the start of wire
+preamble_status read_wire_preamble(std::vector<char>& wire);
+
+struct accepted_socket {
+	socket_t socket_fd = 0;
+	struct sockaddr_storage address;
+};
+
 struct client_data {
 	dcon::nation_id playing_as{};
 	socket_t socket_fd = 0;
 	struct sockaddr_storage address;
+	connection conn;
 
 	client_handshake_data hshake_buffer;
 	command::payload recv_buffer;
@@ -61,11 +126,15 @@ struct client_data {
 	size_t save_stream_offset = 0;
 	size_t save_stream_size = 0;
 	bool handshake = true;
+	bool receives_save_delta = false; // the client has the same scenario save section as the host, see write_network_save
 
 	bool is_banned(sys::state& state) const;
 	inline bool is_active() const {
 		return socket_fd > 0;
 	}
+	inline bool has_pending_output() const {
+		return !send_buffer.empty() || conn.sent_bytes.load(std::memory_order::acquire) < conn.queued_bytes;
+	}
 };
 
 struct network_state {
@@ -74,7 +143,9 @@ struct network_state {
 	sys::checksum_key current_save_checksum;
 	struct sockaddr_storage address;
 	rigtorp::SPSCQueue<command::payload> outgoing_commands;
+	rigtorp::SPSCQueue<accepted_socket> accepted_sockets; // network thread -> game thread
 	std::array<client_data, 128> clients;
+	connection host_connection; // client
 	std::vector<struct in6_addr> v6_banlist;
 	std::vector<struct in_addr> v4_banlist;
 	std::string ip_address = "127.0.0.1";
@@ -83,10 +154,21 @@ struct network_state {
 	command::payload recv_buffer;
 	std::vector<uint8_t> save_data; //client
 	ankerl::unordered_dense::map<int32_t, sys::player_name> map_of_player_names;
-	std::unique_ptr<uint8_t[]> current_save_buffer;
+	std::unique_ptr<uint8_t[]> current_save_buffer; // as a delta against scenario_save
+	std::unique_ptr<uint8_t[]> current_full_save_buffer; // for the clients that cannot apply the delta, if there are any
+	std::vector<uint8_t> scenario_save; // the scenario file's save section, which the save sent to clients is a delta against
+	sys::checksum_key scenario_save_checksum; // of scenario_save
+	sys::checksum_key scenario_save_source; // the scenario checksum that scenario_save was read for
 	size_t recv_count = 0;
 	uint32_t current_save_length = 0;
-	socket_t socket_fd = 0;
+	uint32_t current_full_save_length = 0;
+	socket_t socket_fd = 0; // host: the listening socket
+	std::thread io_thread;
+	std::atomic<bool> io_running = false;
+#ifndef _WIN64
+	int io_epoll_fd = -1;
+	int io_wake_fd = -1;
+#endif
 	uint8_t password[16] = { 0 };
 	std::atomic<bool> save_slock = false;
 	bool as_v6 = false;
@@ -98,8 +180,11 @@ struct network_state {
 	bool handshake = true; // if in handshake mode -> send handshake data
 	bool finished = false; //game can run after disconnection but only to show error messages
 
-	network_state() : outgoing_commands(1024) {}
-	~network_state() {}
+	network_state() : outgoing_commands(1024), accepted_sockets(16) {}
+	~network_state() {
+		stop_io_thread();
+	}
+	void stop_io_thread(); // closes every connection that is still open
 };
 
 void init(sys::state& state);
@@ -109,7 +194,7 @@ void ban_player(sys::state& state, client_data& client);
 void kick_player(sys::state& state, client_data& client);
 void switch_player(sys::state& state, dcon::nation_id new_n, dcon::nation_id old_n);
 void write_network_save(sys::state& state);
-void broadcast_save_to_clients(sys::state& state, command::payload& c, uint8_t const* buffer, uint32_t length, sys::checksum_key const& k);
+void broadcast_save_to_clients(sys::state& state, command::payload& c); // sends the save written by write_network_save
 void broadcast_to_clients(sys::state& state, command::payload& c);
 
 }
@@ -865,10 +865,136 @@ int32_t simplify_trigger(uint16_t* source) {
 	}
 }
 
+// a rough, relative estimate of how much work evaluating a trigger takes
+uint32_t trigger_cost(uint16_t const* source) {
+	auto const code = uint16_t(source[0] & trigger::code_mask);
+	if(code < trigger::first_scope_code)
+		return 1;
+
+	uint64_t members_cost = 0;
+	auto const source_size = 1 + trigger::get_trigger_scope_payload_size(source);
+	auto sub_units_start = source + 2 + trigger::trigger_scope_data_payload(source[0]);
+	while(sub_units_start < source + source_size) {
+		members_cost += trigger_cost(sub_units_start);
+		sub_units_start += 1 + trigger::get_trigger_payload_size(sub_units_start);
+	}
+	if(code == trigger::generic_scope)
+		return uint32_t(std::min(members_cost, uint64_t(std::numeric_limits<uint32_t>::max())));
+	if(trigger::scope_iterates(code))
+		return uint32_t(std::min(16 + members_cost * 16, uint64_t(std::numeric_limits<uint32_t>::max())));
+	return uint32_t(std::min(1 + members_cost, uint64_t(std::numeric_limits<uint32_t>::max())));
+}
+
+// -1 if the trigger isn't a constant
+int32_t constant_trigger_value(uint16_t const* source) {
+	if((source[0] & trigger::code_mask) != trigger::always)
+		return -1;
+	switch(source[0] & trigger::association_mask) {
+	case trigger::association_eq:
+	case trigger::association_le:
+	case trigger::association_ge:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+void optimize_trigger_into(uint16_t const* source, std::vector<uint16_t>& out) {
+	auto const code = uint16_t(source[0] & trigger::code_mask);
+	if(code < trigger::first_scope_code) {
+		out.insert(out.end(), source, source + 1 + trigger::get_trigger_non_scope_payload_size(source));
+		return;
+	}
+
+	bool const disjunctive = (source[0] & trigger::is_disjunctive_scope) != 0;
+	// a generic scope with the same combining rule as its parent adds nothing, so its members are moved into the parent
+	uint16_t const same_kind_generic = uint16_t(trigger::generic_scope | (disjunctive ? trigger::is_disjunctive_scope : 0));
+
+	std::vector<std::vector<uint16_t>> members;
+	auto const source_size = 1 + trigger::get_trigger_scope_payload_size(source);
+	auto const data_size = trigger::trigger_scope_data_payload(source[0]);
+	auto sub_units_start = source + 2 + data_size;
+	while(sub_units_start < source + source_size) {
+		std::vector<uint16_t> member;
+		optimize_trigger_into(sub_units_start, member);
+		if(member[0] == same_kind_generic) {
+			auto const member_size = int32_t(member.size());
+			auto inner = member.data() + 2;
+			while(inner < member.data() + member_size) {
+				auto const inner_size = 1 + trigger::get_trigger_payload_size(inner);
+				members.emplace_back(inner, inner + inner_size);
+				inner += inner_size;
+			}
+		} else {
+			members.push_back(std::move(member));
+		}
+		sub_units_start += 1 + trigger::get_trigger_payload_size(sub_units_start);
+	}
+
+	// true is the identity of a conjunction and false absorbs it; the reverse for a disjunction
+	int32_t const identity = disjunctive ? 0 : 1;
+	int32_t const absorbing = disjunctive ? 1 : 0;
+	std::vector<uint16_t> const* absorbed_by = nullptr;
+	for(auto& m : members) {
+		if(constant_trigger_value(m.data()) == absorbing) {
+			absorbed_by = &m;
+			break;
+		}
+	}
+	if(absorbed_by) {
+		if(code == trigger::generic_scope) {
+			out.push_back(uint16_t(trigger::always | trigger::no_payload | (absorbing == 1 ? trigger::association_eq : trigger::association_ne)));
+			return;
+		}
+		// other scopes still have to be tested, since it matters whether they have anything to test the member against
+		auto constant = std::move(*absorbed_by);
+		members.clear();
+		members.push_back(std::move(constant));
+	} else {
+		std::vector<std::vector<uint16_t>> kept;
+		for(auto& m : members) {
+			if(constant_trigger_value(m.data()) == identity)
+				continue;
+			if(std::find(kept.begin(), kept.end(), m) != kept.end())
+				continue; // the same condition twice is redundant either way
+			kept.push_back(std::move(m));
+		}
+		if(kept.empty()) { // everything was the identity, which is what remains
+			kept.push_back(std::vector<uint16_t>{ uint16_t(trigger::always | trigger::no_payload | (identity == 1 ? trigger::association_eq : trigger::association_ne)) });
+		}
+		members = std::move(kept);
+		// cheap members first, so that the more expensive ones can be skipped more often
+		std::stable_sort(members.begin(), members.end(), [](std::vector<uint16_t> const& a, std::vector<uint16_t> const& b) {
+			return trigger_cost(a.data()) < trigger_cost(b.data());
+		});
+	}
+
+	if(code == trigger::generic_scope && members.size() == 1) {
+		out.insert(out.end(), members[0].begin(), members[0].end());
+		return;
+	}
+
+	auto const start = out.size();
+	out.insert(out.end(), source, source + 2 + data_size);
+	for(auto& m : members)
+		out.insert(out.end(), m.begin(), m.end());
+	out[start + 1] = uint16_t(out.size() - start - 1);
+}
+
+// yields new source size; run after simplify_trigger, the result is never larger than the source
+int32_t optimize_trigger(uint16_t* source) {
+	std::vector<uint16_t> optimized;
+	optimize_trigger_into(source, optimized);
+	std::copy(optimized.begin(), optimized.end(), source);
+	return int32_t(optimized.size());
+}
+
 dcon::trigger_key make_trigger(token_generator& gen, error_handler& err, trigger_building_context& context) {
 	tr_scope_and(gen, err, context);
 
-	auto const new_size = simplify_trigger(context.compiled_trigger.data());
+	auto new_size = simplify_trigger(context.compiled_trigger.data());
+	if(new_size > 0)
+		new_size = optimize_trigger(context.compiled_trigger.data());
 	context.compiled_trigger.resize(static_cast<size_t>(new_size));
 
 	return context.outer_context.state.commit_trigger_data(context.compiled_trigger);
@@ -885,7 +1011,9 @@ void make_stored_trigger(std::string_view name, token_generator& gen, error_hand
 
 	tcontext.compiled_trigger[payload_size_offset] = uint16_t(tcontext.compiled_trigger.size() - payload_size_offset);
 
-	auto const new_size = simplify_trigger(tcontext.compiled_trigger.data());
+	auto new_size = simplify_trigger(tcontext.compiled_trigger.data());
+	if(new_size > 0)
+		new_size = optimize_trigger(tcontext.compiled_trigger.data());
 	tcontext.compiled_trigger.resize(static_cast<size_t>(new_size));
 
 	auto by_name = context.map_of_stored_triggers.find(std::string(name));
@@ -927,7 +1055,9 @@ void make_value_modifier_segment(token_generator& gen, error_handler& err, trigg
 	auto new_factor = context.factor;
 	context.factor = old_factor;
 
-	auto const new_size = simplify_trigger(context.compiled_trigger.data());
+	auto new_size = simplify_trigger(context.compiled_trigger.data());
+	if(new_size > 0)
+		new_size = optimize_trigger(context.compiled_trigger.data());
 	context.compiled_trigger.resize(static_cast<size_t>(new_size));
 
 	auto tkey = context.outer_context.state.commit_trigger_data(context.compiled_trigger);
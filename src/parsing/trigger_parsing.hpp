@@ -5918,6 +5918,8 @@ void invert_trigger(uint16_t* source);
 bool scope_is_empty(uint16_t const* source);
 bool scope_has_single_member(uint16_t const* source);
 int32_t simplify_trigger(uint16_t* source);
+uint32_t trigger_cost(uint16_t const* source);
+int32_t optimize_trigger(uint16_t* source);
 dcon::trigger_key make_trigger(token_generator& gen, error_handler& err, trigger_building_context& context);
 
 struct value_modifier_definition {
@@ -5133,17 +5133,78 @@ inline constexpr uint32_t(*effect_functions[])(EFFECT_PARAMTERS) = {
 
 uint32_t internal_execute_effect(EFFECT_PARAMTERS) {
 	assert(0 <= (*tval & effect::code_mask) && (*tval & effect::code_mask) < effect::first_invalid_code);
+	// limits are tested against the state as the effect has left it so far, never against remembered results
+	trigger::memoization_suspension no_memo;
 	return effect_functions[*tval & effect::code_mask](tval, ws, primary_slot, this_slot, from_slot, r_lo, r_hi, els);
 }
 
+namespace {
+
+bool is_local_leaf(uint16_t code) {
+	switch(code) {
+	// plain values belonging to the nation in the primary slot
+	case effect::treasury:
+	case effect::war_exhaustion:
+	case effect::prestige:
+	case effect::badboy:
+	case effect::research_points:
+	case effect::years_of_research:
+	case effect::leadership:
+	case effect::plurality:
+	// the pops in its provinces
+	case effect::consciousness_nation:
+	case effect::militancy_nation:
+	case effect::scaled_consciousness_nation_issue:
+	case effect::scaled_consciousness_nation_ideology:
+	case effect::scaled_militancy_nation_issue:
+	case effect::scaled_militancy_nation_ideology:
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool is_local_to_primary_nation(sys::state& state, uint16_t const* data) {
+	auto const code = uint16_t(data[0] & effect::code_mask);
+	if(code < effect::first_scope_code)
+		return is_local_leaf(code);
+
+	auto const end = data + 1 + effect::get_effect_scope_payload_size(data);
+	if(code == effect::random_list_scope) {
+		for(auto sub = data + 3; sub < end; sub += 2 + effect::get_generic_effect_payload_size(sub + 1)) {
+			if(!is_local_to_primary_nation(state, sub + 1))
+				return false;
+		}
+		return true;
+	}
+	if(code != effect::generic_scope && code != effect::if_scope && code != effect::else_if_scope && code != effect::random_scope)
+		return false;
+	auto const data_payload = effect::effect_scope_data_payload(data[0]);
+	if((data[0] & effect::scope_has_limit) != 0 && !trigger::is_local_to_primary_nation(state, trigger::payload(data[2]).tr_id))
+		return false;
+	for(auto sub = data + 2 + data_payload; sub < end; sub += 1 + effect::get_generic_effect_payload_size(sub)) {
+		if(!is_local_to_primary_nation(state, sub))
+			return false;
+	}
+	return true;
+}
+
+} // namespace
+
+bool is_local_to_primary_nation(sys::state& state, dcon::effect_key key) {
+	return !key || is_local_to_primary_nation(state, state.effect_data.data() + state.effect_data_indices[key.index() + 1]);
+}
+
 void execute(sys::state& state, dcon::effect_key key, int32_t primary, int32_t this_slot, int32_t from_slot, uint32_t r_lo,
 		uint32_t r_hi) {
+	trigger::discard_memoized_results(state);
 	bool els = false;
 	internal_execute_effect(state.effect_data.data() + state.effect_data_indices[key.index() + 1], state, primary, this_slot, from_slot, r_lo, r_hi, els);
 }
 
 void execute(sys::state& state, uint16_t const* data, int32_t primary, int32_t this_slot, int32_t from_slot, uint32_t r_lo,
 		uint32_t r_hi) {
+	trigger::discard_memoized_results(state);
 	bool els = false;
 	internal_execute_effect(data, state, primary, this_slot, from_slot, r_lo, r_hi, els);
 }
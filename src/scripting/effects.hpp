@@ -11,4 +11,10 @@ void execute(sys::state& state, dcon::effect_key key, int32_t primary, int32_t t
 void execute(sys::state& state, uint16_t const* data, int32_t primary, int32_t this_slot, int32_t from_slot, uint32_t r_lo,
 		uint32_t r_hi);
 
+// whether the effect, executed with a nation in its primary and this slots, changes only plain values of that nation and of its
+// pops, and reads (in its limits) only what trigger::is_local_to_primary_nation allows. Such effects for different nations can
+// be executed in any order, or at the same time, with the same outcome. Anything not known to be local, including every scope
+// other than the grouping, conditional and random ones, is treated as not local.
+bool is_local_to_primary_nation(sys::state& state, dcon::effect_key key);
+
 } // namespace effect
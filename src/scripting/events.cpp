@@ -193,11 +193,14 @@ void trigger_national_event(sys::state& state, dcon::national_event_id e, dcon::
 void trigger_national_event(sys::state& state, dcon::national_event_id e, dcon::nation_id n, uint32_t r_hi, uint32_t r_lo, int32_t from_slot, slot_type ft) {
 	trigger_national_event(state, e, n, r_hi, r_lo, trigger::to_generic(n), slot_type::nation, from_slot, ft);
 }
-void trigger_national_event(sys::state& state, dcon::free_national_event_id e, dcon::nation_id n, uint32_t r_lo, uint32_t r_hi) {
+namespace {
+
+// the part of firing a free national event that must be done in order: returns false if it should not be fired after all
+bool begin_free_national_event(sys::state& state, dcon::free_national_event_id e, dcon::nation_id n, uint32_t r_lo, uint32_t r_hi) {
 	if(state.world.free_national_event_get_only_once(e) && state.world.free_national_event_get_has_been_triggered(e))
-		return;
+		return false;
 	if(!state.world.free_national_event_get_name(e) && !state.world.free_national_event_get_immediate_effect(e) && !event_has_options(state, e))
-		return; // event without data
+		return false; // event without data
 
 	state.world.free_national_event_set_has_been_triggered(e, true);
 	if(state.world.free_national_event_get_is_major(e)) {
@@ -245,6 +248,10 @@ void trigger_national_event(sys::state& state, dcon::free_national_event_id e, d
 			sys::message_base_type::national_event
 		});
 	}
+	return true;
+}
+
+void resolve_free_national_event(sys::state& state, dcon::free_national_event_id e, dcon::nation_id n, uint32_t r_lo, uint32_t r_hi) {
 	if(auto immediate = state.world.free_national_event_get_immediate_effect(e); immediate) {
 		effect::execute(state, immediate, trigger::to_generic(n), trigger::to_generic(n), 0, r_lo, r_hi);
 	}
@@ -284,6 +291,13 @@ void trigger_national_event(sys::state& state, dcon::free_national_event_id e, d
 		}
 	}
 }
+
+} // namespace
+
+void trigger_national_event(sys::state& state, dcon::free_national_event_id e, dcon::nation_id n, uint32_t r_lo, uint32_t r_hi) {
+	if(begin_free_national_event(state, e, n, r_lo, r_hi))
+		resolve_free_national_event(state, e, n, r_lo, r_hi);
+}
 void trigger_provincial_event(sys::state& state, dcon::provincial_event_id e, dcon::province_id p, uint32_t r_hi, uint32_t r_lo, int32_t from_slot, slot_type ft) {
 	if(!state.world.provincial_event_get_name(e) && !state.world.provincial_event_get_immediate_effect(e) && !event_has_options(state, e))
 		return; // event without data
@@ -425,6 +439,25 @@ void trigger_provincial_event(sys::state& state, dcon::free_provincial_event_id
 	}
 }
 
+template<typename T>
+bool is_local_event(sys::state& state, T id) {
+	auto fat_id = dcon::fatten(state.world, id);
+	if(fat_id.get_is_major() || !effect::is_local_to_primary_nation(state, fat_id.get_immediate_effect()))
+		return false;
+	for(auto const& opt : fat_id.get_options()) {
+		if(!effect::is_local_to_primary_nation(state, opt.effect) || !trigger::is_local_to_primary_nation(state, opt.ai_chance))
+			return false;
+	}
+	return true;
+}
+
+bool is_local_to_nation(sys::state& state, dcon::free_national_event_id e) {
+	return is_local_event(state, e);
+}
+bool is_local_to_nation(sys::state& state, dcon::national_event_id e) {
+	return is_local_event(state, e);
+}
+
 struct event_nation_pair {
 	dcon::nation_id n;
 	dcon::free_national_event_id e;
@@ -448,6 +481,153 @@ struct event_prov_pair {
 	}
 };
 
+namespace {
+
+bool holds_as_written(uint16_t code) { // the condition must itself be true, rather than false, for the trigger to hold
+	auto const association = code & trigger::association_mask;
+	return association == 0 || association == trigger::association_eq || association == trigger::association_ge ||
+		association == trigger::association_le;
+}
+
+int32_t selectivity(candidate_type t) {
+	switch(t) {
+	case candidate_type::all:
+		return 0;
+	case candidate_type::country_flag:
+		return 1;
+	case candidate_type::provinces_of_holder:
+		return 2;
+	default:
+		return 3;
+	}
+}
+
+void narrow_to(candidate_gate& gate, candidate_type t, uint16_t value) {
+	if(selectivity(t) > selectivity(gate.type)) {
+		gate.type = t;
+		gate.value = value;
+	}
+}
+
+void consider_member(candidate_gate& gate, int32_t& global_count, uint16_t const* trigger_data, uint16_t const* member, bool provincial) {
+	auto const code = uint16_t(member[0] & trigger::code_mask);
+	if(code >= trigger::first_scope_code) {
+		if(provincial && code == trigger::owner_scope_province && (member[0] & trigger::is_disjunctive_scope) == 0) {
+			auto const end = member + 1 + trigger::get_trigger_scope_payload_size(member);
+			for(auto sub = member + 2; sub < end; sub += 1 + trigger::get_trigger_payload_size(sub)) {
+				if((sub[0] & trigger::code_mask) == trigger::tag_tag && holds_as_written(sub[0]))
+					narrow_to(gate, candidate_type::provinces_of_holder, sub[1]);
+			}
+		}
+		return;
+	}
+
+	switch(code) {
+	case trigger::year:
+	case trigger::month:
+	case trigger::has_global_flag:
+		if(global_count < max_global_conditions) {
+			gate.global_conditions[global_count] = int32_t(member - trigger_data);
+			++global_count;
+		}
+		break;
+	case trigger::tag_tag:
+		if(!provincial && holds_as_written(member[0]))
+			narrow_to(gate, candidate_type::identity_holder, member[1]);
+		break;
+	case trigger::owns:
+		if(!provincial && holds_as_written(member[0]))
+			narrow_to(gate, candidate_type::province_owner, member[1]);
+		break;
+	case trigger::has_country_flag:
+		if(!provincial && holds_as_written(member[0]))
+			narrow_to(gate, candidate_type::country_flag, member[1]);
+		break;
+	case trigger::province_id:
+		if(provincial && holds_as_written(member[0]))
+			narrow_to(gate, candidate_type::province, member[1]);
+		break;
+	default:
+		break;
+	}
+}
+
+bool global_conditions_hold(sys::state& state, candidate_gate const& gate) {
+	for(auto offset : gate.global_conditions) {
+		if(offset != 0 && !trigger::evaluate(state, state.trigger_data.data() + offset, 0, 0, 0))
+			return false;
+	}
+	return true;
+}
+
+float chance_of_not_firing(float chances, float base) { // as computed lane by lane in update_events
+	auto const adj_chance = 1.0f - (chances <= base ? 1.0f : base / chances);
+	auto const adj_chance_2 = adj_chance * adj_chance;
+	auto const adj_chance_4 = adj_chance_2 * adj_chance_2;
+	auto const adj_chance_8 = adj_chance_4 * adj_chance_4;
+	return adj_chance_8 * adj_chance_8;
+}
+
+} // namespace
+
+candidate_gate extract_candidate_gate(uint16_t const* trigger_data, int32_t root_offset, bool provincial) {
+	candidate_gate gate;
+	if(root_offset == 0)
+		return gate;
+
+	int32_t global_count = 0;
+	auto const root = trigger_data + root_offset;
+	if((root[0] & trigger::code_mask) == trigger::generic_scope) {
+		if((root[0] & trigger::is_disjunctive_scope) != 0)
+			return gate;
+		auto const end = root + 1 + trigger::get_trigger_scope_payload_size(root);
+		for(auto member = root + 2; member < end; member += 1 + trigger::get_trigger_payload_size(member)) {
+			consider_member(gate, global_count, trigger_data, member, provincial);
+		}
+	} else {
+		consider_member(gate, global_count, trigger_data, root, provincial);
+	}
+	return gate;
+}
+
+int32_t scheduled_day(uint32_t event_index, uint32_t event_count) {
+	// as many events on each day, with the remainder on the last
+	auto const per_day = event_count / uint32_t(schedule_days);
+	return per_day == 0 ? schedule_days - 1 : std::min(int32_t(event_index / per_day), schedule_days - 1);
+}
+
+void build_event_schedules(sys::state& state) {
+	for(auto& d : state.free_national_event_schedule.days)
+		d.clear();
+	for(auto e : state.world.in_free_national_event) {
+		if(e.get_only_once() && e.get_has_been_triggered())
+			continue;
+		scheduled_event s;
+		s.trigger = e.get_trigger();
+		s.mtth = e.get_mtth();
+		s.id = uint16_t(e.id.index());
+		s.only_once = e.get_only_once();
+		if(s.trigger)
+			s.gate = extract_candidate_gate(state.trigger_data.data(), state.trigger_data_indices[s.trigger.index() + 1], false);
+		state.free_national_event_schedule.days[scheduled_day(e.id.index(), state.world.free_national_event_size())].push_back(s);
+	}
+
+	for(auto& d : state.free_provincial_event_schedule.days)
+		d.clear();
+	for(auto e : state.world.in_free_provincial_event) {
+		if(e.get_only_once() && e.get_has_been_triggered())
+			continue;
+		scheduled_event s;
+		s.trigger = e.get_trigger();
+		s.mtth = e.get_mtth();
+		s.id = uint16_t(e.id.index());
+		s.only_once = e.get_only_once();
+		if(s.trigger)
+			s.gate = extract_candidate_gate(state.trigger_data.data(), state.trigger_data_indices[s.trigger.index() + 1], true);
+		state.free_provincial_event_schedule.days[scheduled_day(e.id.index(), state.world.free_provincial_event_size())].push_back(s);
+	}
+}
+
 bool would_be_duplicate_instance(sys::state& state, dcon::national_event_id e, dcon::nation_id n, sys::date date) {
 	if(state.world.national_event_get_allow_multiple_instances(e))
 		return false;
@@ -506,21 +686,100 @@ void update_future_events(sys::state& state) {
 	}
 }
 
+namespace {
+
+// fires the events in order, except that runs of events that are local to ai controlled nations are collected and then fired
+// concurrently, with the events of any one nation still fired in order; the outcome is the same as firing them all in order
+void fire_free_national_events(sys::state& state, std::vector<event_nation_pair> const& events) {
+	std::vector<event_nation_pair> batch;
+	std::vector<uint32_t> nation_starts;
+	auto fire_batch = [&]() {
+		nation_starts.clear();
+		for(uint32_t j = 0; j < uint32_t(batch.size()); ++j) {
+			if(j == 0 || batch[j].n != batch[j - 1].n)
+				nation_starts.push_back(j);
+		}
+		nation_starts.push_back(uint32_t(batch.size()));
+		concurrency::parallel_for(uint32_t(0), uint32_t(nation_starts.size() - 1), [&](uint32_t k) {
+			for(uint32_t j = nation_starts[k]; j < nation_starts[k + 1]; ++j) {
+				auto const& v = batch[j];
+				resolve_free_national_event(state, v.e, v.n, uint32_t((state.current_date.value) ^ (v.e.value << 3)), uint32_t(v.n.value));
+			}
+		});
+		batch.clear();
+	};
+
+	for(auto& v : events) {
+		auto const r_lo = uint32_t((state.current_date.value) ^ (v.e.value << 3));
+		auto const r_hi = uint32_t(v.n.value);
+		if(!state.world.nation_get_is_player_controlled(v.n) && v.n != state.local_player_nation && is_local_event(state, v.e)) {
+			if(begin_free_national_event(state, v.e, v.n, r_lo, r_hi))
+				batch.push_back(v);
+		} else {
+			if(!batch.empty())
+				fire_batch();
+			event::trigger_national_event(state, v.e, v.n, r_lo, r_hi);
+		}
+	}
+	if(!batch.empty())
+		fire_batch();
+}
+
+} // namespace
+
 void update_events(sys::state& state) {
-	uint32_t n_block_size = state.world.free_national_event_size() / 32;
-	uint32_t p_block_size = state.world.free_provincial_event_size() / 32;
+	trigger::memoization_window memo{ state };
+	auto const day = int32_t(state.current_date.value & (schedule_days - 1));
 
-	uint32_t block_index = (state.current_date.value & 31);
+	auto& n_today = state.free_national_event_schedule.days[day];
+	n_today.erase(std::remove_if(n_today.begin(), n_today.end(), [&](scheduled_event const& s) {
+		return s.only_once && state.world.free_national_event_get_has_been_triggered(dcon::free_national_event_id{ dcon::free_national_event_id::value_base_t(s.id) });
+	}), n_today.end());
 
 	concurrency::combinable<std::vector<event_nation_pair>> events_triggered;
 
-	auto n_block_end = block_index == 31 ? state.world.free_national_event_size() : n_block_size * (block_index + 1);
-	concurrency::parallel_for(n_block_size * block_index, n_block_end, [&](uint32_t i) {
-		dcon::free_national_event_id id{dcon::national_event_id::value_base_t(i)};
-		auto mod = state.world.free_national_event_get_mtth(id);
-		auto t = state.world.free_national_event_get_trigger(id);
+	concurrency::parallel_for(uint32_t(0), uint32_t(n_today.size()), [&](uint32_t k) {
+		auto const& s = n_today[k];
+		uint32_t const i = s.id;
+		dcon::free_national_event_id id{ dcon::free_national_event_id::value_base_t(i) };
+		auto const mod = s.mtth;
+		auto const t = s.trigger;
+		auto const& gate = s.gate;
+
+		if(!global_conditions_hold(state, gate))
+			return;
 
-		if(state.world.free_national_event_get_only_once(id) == false || state.world.free_national_event_get_has_been_triggered(id) == false) {
+		if(gate.type != candidate_type::all) {
+			auto test_candidate = [&](dcon::nation_id n) {
+				if(state.world.nation_get_owned_province_count(n) == 0)
+					return;
+				if(t && !trigger::evaluate(state, t, trigger::to_generic(n), trigger::to_generic(n), 0))
+					return;
+				auto chances = mod ? trigger::evaluate_multiplicative_modifier(state, mod, trigger::to_generic(n), trigger::to_generic(n), 0) : 1.0f;
+				if(float(rng::get_random(state, uint32_t((i << 1) ^ n.index())) & 0xFFFFFF) / float(0xFFFFFF + 1) >= chance_of_not_firing(chances, 1.0f)) {
+					events_triggered.local().push_back(event_nation_pair{ n, id });
+				}
+			};
+			switch(gate.type) {
+			case candidate_type::identity_holder:
+				if(auto n = state.world.national_identity_get_nation_from_identity_holder(trigger::payload(gate.value).tag_id); n)
+					test_candidate(n);
+				break;
+			case candidate_type::province_owner:
+				if(auto n = state.world.province_get_nation_from_province_ownership(trigger::payload(gate.value).prov_id); n)
+					test_candidate(n);
+				break;
+			case candidate_type::country_flag:
+				for(uint32_t j = 0; j < state.world.nation_size(); ++j) {
+					dcon::nation_id n{ dcon::nation_id::value_base_t(j) };
+					if(state.world.nation_get_flag_variables(n, trigger::payload(gate.value).natf_id))
+						test_candidate(n);
+				}
+				break;
+			default:
+				break;
+			}
+		} else {
 			ve::execute_serial_fast<dcon::nation_id>(state.world.nation_size(), [&](auto ids) {
 				/*
 				For national events: the base factor (scaled to days) is multiplied with all modifiers that hold. If the value is
@@ -532,26 +791,31 @@ void update_events(sys::state& state) {
 					: (state.world.nation_get_owned_province_count(ids) != 0);
 				if(ve::compress_mask(some_exist).v != 0) {
 					auto chances = mod ?
-						trigger::evaluate_multiplicative_modifier(state, mod, trigger::to_generic(ids), trigger::to_generic(ids), 0) : ve::fp_vector{ 1.0f };
+						trigger::evaluate_multiplicative_modifier(state, mod, trigger::to_generic(ids), trigger::to_generic(ids), 0, some_exist) : ve::fp_vector{ 1.0f };
 					auto adj_chance = 1.0f - ve::select(chances <= 1.0f, 1.0f, 1.0f / (chances));
 					auto adj_chance_2 = adj_chance * adj_chance;
 					auto adj_chance_4 = adj_chance_2 * adj_chance_2;
 					auto adj_chance_8 = adj_chance_4 * adj_chance_4;
 					auto adj_chance_16 = adj_chance_8 * adj_chance_8;
 
+					// the same numbers as rng::get_random(state, (i << 1) ^ n) for each nation n, generated for the lanes together
+					uint32_t keys[ve::vector_size];
+					uint32_t rolls[ve::vector_size];
+					for(int32_t j = 0; j < int32_t(ve::vector_size); ++j)
+						keys[j] = uint32_t((i << 1) ^ uint32_t(ids.value + j));
+					rng::get_random_lanes(state, keys, rolls, uint32_t(ve::vector_size));
+
 					ve::apply(
 							[&](dcon::nation_id n, float c, bool condition) {
-								auto owned_range = state.world.nation_get_province_ownership(n);
-								if(condition && owned_range.begin() != owned_range.end()) {
-									if(float(rng::get_random(state, uint32_t((i << 1) ^ n.index())) & 0xFFFFFF) / float(0xFFFFFF + 1) >= c) {
+								if(condition && float(rolls[n.index() - ids.value] & 0xFFFFFF) / float(0xFFFFFF + 1) >= c) {
+									auto owned_range = state.world.nation_get_province_ownership(n);
+									if(owned_range.begin() != owned_range.end())
 										events_triggered.local().push_back(event_nation_pair{n, id});
-									}
 								}
 							},
 							ids, adj_chance_16, some_exist);
 				}
 			});
-			
 		}
 	});
 
@@ -561,19 +825,59 @@ void update_events(sys::state& state) {
 		return result;
 	});
 	std::sort(total_vector.begin(), total_vector.end());
-	for(auto& v : total_vector) {
-		event::trigger_national_event(state, v.e, v.n, uint32_t((state.current_date.value) ^ (v.e.value << 3)), uint32_t(v.n.value));
+	if(state.cheat_data.parallel_effects) {
+		fire_free_national_events(state, total_vector);
+	} else {
+		for(auto& v : total_vector) {
+			event::trigger_national_event(state, v.e, v.n, uint32_t((state.current_date.value) ^ (v.e.value << 3)), uint32_t(v.n.value));
+		}
 	}
 
+	auto& p_today = state.free_provincial_event_schedule.days[day];
+	p_today.erase(std::remove_if(p_today.begin(), p_today.end(), [&](scheduled_event const& s) {
+		return s.only_once && state.world.free_provincial_event_get_has_been_triggered(dcon::free_provincial_event_id{ dcon::free_provincial_event_id::value_base_t(s.id) });
+	}), p_today.end());
+
 	concurrency::combinable<std::vector<event_prov_pair>> p_events_triggered;
 
-	auto p_block_end = block_index == 31 ? state.world.free_provincial_event_size() : p_block_size * (block_index + 1);
-	concurrency::parallel_for(p_block_size * block_index, p_block_end, [&](uint32_t i) {
-		dcon::free_provincial_event_id id{dcon::free_provincial_event_id::value_base_t(i)};
-		auto mod = state.world.free_provincial_event_get_mtth(id);
-		auto t = state.world.free_provincial_event_get_trigger(id);
+	concurrency::parallel_for(uint32_t(0), uint32_t(p_today.size()), [&](uint32_t k) {
+		auto const& s = p_today[k];
+		uint32_t const i = s.id;
+		dcon::free_provincial_event_id id{ dcon::free_provincial_event_id::value_base_t(i) };
+		auto const mod = s.mtth;
+		auto const t = s.trigger;
+		auto const& gate = s.gate;
 
-		if(state.world.free_provincial_event_get_only_once(id) == false || state.world.free_provincial_event_get_has_been_triggered(id) == false) {
+		if(!global_conditions_hold(state, gate))
+			return;
+
+		if(gate.type != candidate_type::all) {
+			auto test_candidate = [&](dcon::province_id p) {
+				if(!p || p.index() >= state.province_definitions.first_sea_province.index())
+					return;
+				if(!state.world.province_get_nation_from_province_ownership(p))
+					return;
+				if(t && !trigger::evaluate(state, t, trigger::to_generic(p), trigger::to_generic(p), 0))
+					return;
+				auto chances = mod ? trigger::evaluate_multiplicative_modifier(state, mod, trigger::to_generic(p), trigger::to_generic(p), 0) : 2.0f;
+				if(float(rng::get_random(state, uint32_t((i << 1) ^ p.index())) & 0xFFFFFF) / float(0xFFFFFF + 1) >= chance_of_not_firing(chances, 2.0f)) {
+					p_events_triggered.local().push_back(event_prov_pair{ p, id });
+				}
+			};
+			switch(gate.type) {
+			case candidate_type::province:
+				test_candidate(trigger::payload(gate.value).prov_id);
+				break;
+			case candidate_type::provinces_of_holder:
+				if(auto n = state.world.national_identity_get_nation_from_identity_holder(trigger::payload(gate.value).tag_id); n) {
+					for(auto o : state.world.nation_get_province_ownership(n))
+						test_candidate(o.get_province());
+				}
+				break;
+			default:
+				break;
+			}
+		} else {
 			ve::execute_serial_fast<dcon::province_id>(uint32_t(state.province_definitions.first_sea_province.index()),
 					[&](ve::contiguous_tags<dcon::province_id> ids) {
 						/*
@@ -586,7 +890,7 @@ void update_events(sys::state& state) {
 							: (owners != dcon::nation_id{});
 						if(ve::compress_mask(some_exist).v != 0) {
 							auto chances = mod
-								? trigger::evaluate_multiplicative_modifier(state, mod, trigger::to_generic(ids), trigger::to_generic(ids), 0)
+								? trigger::evaluate_multiplicative_modifier(state, mod, trigger::to_generic(ids), trigger::to_generic(ids), 0, some_exist)
 								: ve::fp_vector{ 2.0f };
 							auto adj_chance = 1.0f - ve::select(chances <= 2.0f, 1.0f, 2.0f / chances);
 							auto adj_chance_2 = adj_chance * adj_chance;
@@ -594,15 +898,19 @@ void update_events(sys::state& state) {
 							auto adj_chance_8 = adj_chance_4 * adj_chance_4;
 							auto adj_chance_16 = adj_chance_8 * adj_chance_8;
 
+							uint32_t keys[ve::vector_size];
+							uint32_t rolls[ve::vector_size];
+							for(int32_t j = 0; j < int32_t(ve::vector_size); ++j)
+								keys[j] = uint32_t((i << 1) ^ uint32_t(ids.value + j));
+							rng::get_random_lanes(state, keys, rolls, uint32_t(ve::vector_size));
+
 							ve::apply(
-									[&](dcon::province_id p, dcon::nation_id o, float c, bool condition) {
-										if(condition) {
-											if(float(rng::get_random(state, uint32_t((i << 1) ^ p.index())) & 0xFFFFFF) / float(0xFFFFFF + 1) >= c) {
-												p_events_triggered.local().push_back(event_prov_pair{ p, id });
-											}
+									[&](dcon::province_id p, float c, bool condition) {
+										if(condition && float(rolls[p.index() - ids.value] & 0xFFFFFF) / float(0xFFFFFF + 1) >= c) {
+											p_events_triggered.local().push_back(event_prov_pair{ p, id });
 										}
 									},
-									ids, owners, adj_chance_16, some_exist);
+									ids, adj_chance_16, some_exist);
 						}
 					});
 		}
@@ -695,7 +1003,7 @@ struct internal_n_epair {
 };
 
 void fire_fixed_event(sys::state& state, std::vector<nations::fixed_event> const& v, int32_t primary_slot, slot_type pt, dcon::nation_id this_slot, int32_t from_slot, slot_type ft) {
-	static std::vector<internal_n_epair> valid_list;
+	thread_local std::vector<internal_n_epair> valid_list;
 	valid_list.clear();
 	int32_t total_chances = 0;
 	for(auto& fe : v) {
@@ -716,8 +1024,26 @@ void fire_fixed_event(sys::state& state, std::vector<nations::fixed_event> const
 	}
 }
 
+void fire_pulse(sys::state& state, std::vector<nations::fixed_event> const& v) {
+	bool local = state.cheat_data.parallel_effects;
+	for(auto& fe : v) {
+		local = local && trigger::is_local_to_primary_nation(state, fe.condition) && is_local_event(state, fe.id);
+	}
+	if(local) { // no nation can see the effects of the events fired for any other, so they may all be fired at once
+		concurrency::parallel_for(uint32_t(0), state.world.nation_size(), [&](uint32_t i) {
+			dcon::nation_id n{ dcon::nation_id::value_base_t(i) };
+			if(state.world.nation_get_owned_province_count(n) > 0 && !state.world.nation_get_is_player_controlled(n) && n != state.local_player_nation)
+				fire_fixed_event(state, v, trigger::to_generic(n), slot_type::nation, n, -1, slot_type::none);
+		});
+	}
+	for(auto n : state.world.in_nation) {
+		if(n.get_owned_province_count() > 0 && (!local || n.get_is_player_controlled() || n.id == state.local_player_nation))
+			fire_fixed_event(state, v, trigger::to_generic(n.id), slot_type::nation, n.id, -1, slot_type::none);
+	}
+}
+
 void fire_fixed_event(sys::state& state, std::vector<nations::fixed_election_event> const& v, int32_t primary_slot, slot_type pt, dcon::nation_id this_slot, int32_t from_slot, slot_type ft) {
-	static std::vector<internal_n_epair> valid_list;
+	thread_local std::vector<internal_n_epair> valid_list;
 	valid_list.clear();
 	int32_t total_chances = 0;
 	for(auto& fe : v) {
@@ -81,6 +81,51 @@ static_assert(sizeof(pending_human_f_p_event) ==
 	+ sizeof(pending_human_f_p_event::p)
 	+ sizeof(pending_human_f_p_event::padding));
 
+// Necessary conditions taken from the trigger of a free event, so that update_events can skip the event entirely on days when
+// it cannot fire, and otherwise visit only the nations or provinces that could satisfy its trigger rather than all of them.
+// Only the direct members of a top level "and" (or a lone top level condition) are considered, and only when they are not
+// negated, since anything else would not be necessary for the trigger to hold.
+enum class candidate_type : uint8_t {
+	all, // no usable gate: every nation or land province must be tested
+	identity_holder, // the nation holding the identity in value
+	province_owner, // the owner of the province in value
+	country_flag, // the nations with the national flag in value set
+	province, // the province in value
+	provinces_of_holder // the provinces owned by the holder of the identity in value
+};
+
+inline constexpr int32_t max_global_conditions = 4;
+
+struct candidate_gate {
+	// offsets into trigger_data of conditions that do not depend on the slots (the date and global flags); zero when unused
+	int32_t global_conditions[max_global_conditions] = { 0 };
+	uint16_t value = 0;
+	candidate_type type = candidate_type::all;
+};
+
+candidate_gate extract_candidate_gate(uint16_t const* trigger_data, int32_t root_offset, bool provincial);
+
+// Each free event is rolled for on one day of a 32 day cycle. The schedule keeps, for each day, the events rolled for on it
+// with the fields the roll needs packed together, so that update_events reads one compact array rather than gathering the
+// fields of every event from the data container. Only once events that have fired are pruned from their day the next time it
+// comes up.
+inline constexpr int32_t schedule_days = 32;
+
+struct scheduled_event {
+	candidate_gate gate;
+	dcon::trigger_key trigger;
+	dcon::value_modifier_key mtth;
+	uint16_t id = 0; // index of the free national or provincial event
+	bool only_once = false;
+};
+
+struct event_schedule {
+	std::vector<scheduled_event> days[schedule_days];
+};
+
+int32_t scheduled_day(uint32_t event_index, uint32_t event_count);
+void build_event_schedules(sys::state& state); // called once the scenario, or a save, has been loaded
+
 void trigger_national_event(sys::state& state, dcon::national_event_id e, dcon::nation_id n, uint32_t r_hi, uint32_t r_lo,
 		int32_t from_slot = 0, slot_type ft = slot_type::none);
 void trigger_national_event(sys::state& state, dcon::national_event_id e, dcon::nation_id n, uint32_t r_hi, uint32_t r_lo,
@@ -95,6 +140,15 @@ void fire_fixed_event(sys::state& state, std::vector<nations::fixed_event> const
 void fire_fixed_event(sys::state& state, std::vector<nations::fixed_election_event> const& v, int32_t primary_slot, slot_type pt, dcon::nation_id this_slot, int32_t from_slot, slot_type ft);
 void fire_fixed_event(sys::state& state, std::vector<nations::fixed_province_event> const& v, dcon::province_id prov, int32_t from_slot, slot_type ft);
 
+// fires one of the events (or none) for every nation that owns provinces, as for on_quarterly_pulse and on_yearly_pulse
+void fire_pulse(sys::state& state, std::vector<nations::fixed_event> const& v);
+
+// whether firing the event for an ai controlled nation posts no notification and executes only effects that are
+// effect::is_local_to_primary_nation for that nation, choosing between its options using only triggers that are local to it;
+// with cheat_data.parallel_effects set, such events are fired for different nations concurrently
+bool is_local_to_nation(sys::state& state, dcon::free_national_event_id e);
+bool is_local_to_nation(sys::state& state, dcon::national_event_id e);
+
 void take_option(sys::state& state, pending_human_n_event const& e, uint8_t opt);
 void take_option(sys::state& state, pending_human_f_n_event const& e, uint8_t opt);
 void take_option(sys::state& state, pending_human_p_event const& e, uint8_t opt);
@@ -1426,6 +1426,12 @@ constexpr inline uint16_t first_invalid_code = first_scope_code + 0x0034;
 
 constexpr inline uint16_t placeholder_not_scope = code_mask;
 
+// scopes that test their members against a whole set of objects, rather than against a single one
+constexpr bool scope_iterates(uint16_t code) {
+	return (code >= x_neighbor_province_scope && code <= x_provinces_in_variable_region) || code == x_country_scope ||
+		code == x_neighbor_province_scope_state || code == x_provinces_in_variable_region_proper;
+}
+
 // variable
 //  region name = 1 variant, x type, payload 1
 //  tag = 1 variant, payload 1
@@ -0,0 +1,1320 @@
+#include <algorithm>
+#include <cstdio>
+#include "script_inspection.hpp"
+#include "script_constants.hpp"
+#include "system_state.hpp"
+#include "triggers.hpp"
+#include "nations.hpp"
+#include "text.hpp"
+
+namespace script_inspection {
+
+namespace {
+
+char const* trigger_leaf_names[] = {
+	"none",
+#define TRIGGER_BYTECODE_ELEMENT(code, name, arg) #name,
+	TRIGGER_BYTECODE_LIST
+#undef TRIGGER_BYTECODE_ELEMENT
+};
+static_assert(sizeof(trigger_leaf_names) / sizeof(trigger_leaf_names[0]) == trigger::first_scope_code);
+
+char const* trigger_scope_names[] = {
+	"generic_scope",
+	"x_neighbor_province_scope",
+	"x_neighbor_country_scope_nation",
+	"x_neighbor_country_scope_pop",
+	"x_war_countries_scope_nation",
+	"x_war_countries_scope_pop",
+	"x_greater_power_scope",
+	"x_owned_province_scope_state",
+	"x_owned_province_scope_nation",
+	"x_core_scope_province",
+	"x_core_scope_nation",
+	"x_state_scope",
+	"x_substate_scope",
+	"x_sphere_member_scope",
+	"x_pop_scope_province",
+	"x_pop_scope_state",
+	"x_pop_scope_nation",
+	"x_provinces_in_variable_region",
+	"owner_scope_state",
+	"owner_scope_province",
+	"controller_scope",
+	"location_scope",
+	"country_scope_state",
+	"country_scope_pop",
+	"capital_scope",
+	"this_scope_pop",
+	"this_scope_nation",
+	"this_scope_state",
+	"this_scope_province",
+	"from_scope_pop",
+	"from_scope_nation",
+	"from_scope_state",
+	"from_scope_province",
+	"sea_zone_scope",
+	"cultural_union_scope",
+	"overlord_scope",
+	"sphere_owner_scope",
+	"independence_scope",
+	"flashpoint_tag_scope",
+	"crisis_state_scope",
+	"state_scope_pop",
+	"state_scope_province",
+	"tag_scope",
+	"integer_scope",
+	"country_scope_nation",
+	"country_scope_province",
+	"cultural_union_scope_pop",
+	"capital_scope_province",
+	"capital_scope_pop",
+	"x_country_scope",
+	"x_neighbor_province_scope_state",
+	"x_provinces_in_variable_region_proper",
+};
+static_assert(sizeof(trigger_scope_names) / sizeof(trigger_scope_names[0]) == trigger::first_invalid_code - trigger::first_scope_code);
+
+char const* effect_leaf_names[] = {
+	"none",
+#define EFFECT_BYTECODE_ELEMENT(code, name, arg) #name,
+	EFFECT_BYTECODE_LIST
+#undef EFFECT_BYTECODE_ELEMENT
+};
+static_assert(sizeof(effect_leaf_names) / sizeof(effect_leaf_names[0]) == effect::first_scope_code);
+
+char const* effect_scope_names[] = {
+	"generic_scope",
+	"x_neighbor_province_scope",
+	"x_neighbor_country_scope",
+	"x_country_scope",
+	"x_country_scope_nation",
+	"x_empty_neighbor_province_scope",
+	"x_greater_power_scope",
+	"poor_strata_scope_nation",
+	"poor_strata_scope_state",
+	"poor_strata_scope_province",
+	"middle_strata_scope_nation",
+	"middle_strata_scope_state",
+	"middle_strata_scope_province",
+	"rich_strata_scope_nation",
+	"rich_strata_scope_state",
+	"rich_strata_scope_province",
+	"x_pop_scope_nation",
+	"x_pop_scope_state",
+	"x_pop_scope_province",
+	"x_owned_scope_nation",
+	"x_owned_scope_state",
+	"x_core_scope",
+	"x_state_scope",
+	"random_list_scope",
+	"random_scope",
+	"owner_scope_state",
+	"owner_scope_province",
+	"controller_scope",
+	"location_scope",
+	"country_scope_pop",
+	"country_scope_state",
+	"capital_scope",
+	"this_scope_nation",
+	"this_scope_state",
+	"this_scope_province",
+	"this_scope_pop",
+	"from_scope_nation",
+	"from_scope_state",
+	"from_scope_province",
+	"from_scope_pop",
+	"sea_zone_scope",
+	"cultural_union_scope",
+	"overlord_scope",
+	"sphere_owner_scope",
+	"independence_scope",
+	"flashpoint_tag_scope",
+	"crisis_state_scope",
+	"state_scope_pop",
+	"state_scope_province",
+	"x_substate_scope",
+	"capital_scope_province",
+	"x_core_scope_province",
+	"tag_scope",
+	"integer_scope",
+	"pop_type_scope_nation",
+	"pop_type_scope_state",
+	"pop_type_scope_province",
+	"region_proper_scope",
+	"region_scope",
+	"if_scope",
+	"else_if_scope",
+	"x_event_country_scope",
+	"x_decision_country_scope",
+	"x_event_country_scope_nation",
+	"x_decision_country_scope_nation",
+	"from_bounce_scope",
+	"this_bounce_scope",
+};
+static_assert(sizeof(effect_scope_names) / sizeof(effect_scope_names[0]) == effect::first_invalid_code - effect::first_scope_code);
+
+// stored triggers may refer to other stored triggers; this only guards against a cycle
+constexpr int32_t max_stored_trigger_depth = 16;
+
+uint16_t const* trigger_data_of(sys::state& state, dcon::trigger_key key) {
+	return state.trigger_data.data() + state.trigger_data_indices[key.index() + 1];
+}
+
+void indent(std::string& out, int32_t depth) {
+	out.append(size_t(depth), '\t');
+}
+
+void append_words(std::string& out, uint16_t const* words, int32_t count) {
+	for(int32_t i = 0; i < count; ++i) {
+		char buffer[16];
+		std::snprintf(buffer, sizeof(buffer), " 0x%04X", uint32_t(words[i]));
+		out += buffer;
+	}
+}
+
+enum class payload_kind : uint8_t {
+	raw, integer, signed_integer, decimal, tag, province, modifier, commodity
+};
+
+// how the trigger function for the code reads the payload word at the given offset (1 being the word after the code)
+payload_kind trigger_payload_kind(uint16_t code, int32_t offset) {
+	switch(offset) {
+	case 1:
+		switch(code) {
+		case trigger::year:
+		case trigger::month:
+		case trigger::rank:
+		case trigger::num_of_revolts:
+		case trigger::num_of_cities_int:
+		case trigger::num_of_ports:
+		case trigger::num_of_allies:
+		case trigger::num_of_vassals:
+		case trigger::units_in_province_value:
+		case trigger::total_amount_of_divisions:
+		case trigger::total_amount_of_ships:
+		case trigger::nationalism:
+		case trigger::is_canal_enabled:
+		case trigger::total_num_of_ports:
+		case trigger::industrial_score_value:
+		case trigger::military_score_value:
+		case trigger::num_of_substates:
+		case trigger::num_of_vassals_no_substates:
+		case trigger::number_of_states:
+		case trigger::has_recent_imigration:
+		case trigger::province_control_days:
+		case trigger::diplomatic_influence_tag:
+		case trigger::diplomatic_influence_this_nation:
+		case trigger::diplomatic_influence_this_province:
+		case trigger::diplomatic_influence_from_nation:
+		case trigger::diplomatic_influence_from_province:
+			return payload_kind::integer;
+		case trigger::life_rating_province:
+		case trigger::life_rating_state:
+		case trigger::rich_tax:
+		case trigger::middle_tax:
+		case trigger::poor_tax:
+		case trigger::social_spending_nation:
+		case trigger::social_spending_pop:
+		case trigger::social_spending_province:
+		case trigger::military_spending_pop:
+		case trigger::military_spending_province:
+		case trigger::military_spending_state:
+		case trigger::military_spending_nation:
+		case trigger::administration_spending_pop:
+		case trigger::administration_spending_province:
+		case trigger::administration_spending_state:
+		case trigger::administration_spending_nation:
+		case trigger::education_spending_pop:
+		case trigger::education_spending_province:
+		case trigger::education_spending_state:
+		case trigger::education_spending_nation:
+		case trigger::relation_tag:
+		case trigger::relation_this_nation:
+		case trigger::relation_this_province:
+		case trigger::relation_from_nation:
+		case trigger::relation_from_province:
+		case trigger::party_loyalty_nation_from_province:
+		case trigger::party_loyalty_from_nation_scope_province:
+		case trigger::party_loyalty_from_province_scope_province:
+		case trigger::party_loyalty_generic:
+		case trigger::rich_tax_pop:
+		case trigger::middle_tax_pop:
+		case trigger::poor_tax_pop:
+		case trigger::relation_this_pop:
+			return payload_kind::signed_integer;
+		case trigger::cash_reserves:
+		case trigger::unemployment_nation:
+		case trigger::unemployment_state:
+		case trigger::unemployment_province:
+		case trigger::unemployment_pop:
+		case trigger::war_exhaustion_nation:
+		case trigger::blockade:
+		case trigger::revolt_percentage:
+		case trigger::prestige_value:
+		case trigger::badboy:
+		case trigger::money:
+		case trigger::lost_national:
+		case trigger::political_reform_want_nation:
+		case trigger::political_reform_want_pop:
+		case trigger::social_reform_want_nation:
+		case trigger::social_reform_want_pop:
+		case trigger::plurality:
+		case trigger::corruption:
+		case trigger::average_militancy_nation:
+		case trigger::average_militancy_state:
+		case trigger::average_militancy_province:
+		case trigger::average_consciousness_nation:
+		case trigger::average_consciousness_state:
+		case trigger::average_consciousness_province:
+		case trigger::recruited_percentage_nation:
+		case trigger::recruited_percentage_pop:
+		case trigger::total_pops_nation:
+		case trigger::total_pops_state:
+		case trigger::total_pops_province:
+		case trigger::total_pops_pop:
+		case trigger::mobilisation_size:
+		case trigger::agree_with_ruling_party:
+		case trigger::national_provinces_occupied:
+		case trigger::poor_strata_militancy_nation:
+		case trigger::poor_strata_militancy_state:
+		case trigger::poor_strata_militancy_province:
+		case trigger::poor_strata_militancy_pop:
+		case trigger::middle_strata_militancy_nation:
+		case trigger::middle_strata_militancy_state:
+		case trigger::middle_strata_militancy_province:
+		case trigger::middle_strata_militancy_pop:
+		case trigger::rich_strata_militancy_nation:
+		case trigger::rich_strata_militancy_state:
+		case trigger::rich_strata_militancy_province:
+		case trigger::rich_strata_militancy_pop:
+		case trigger::revanchism_nation:
+		case trigger::revanchism_pop:
+		case trigger::brigades_compare_this:
+		case trigger::brigades_compare_from:
+		case trigger::constructing_cb_progress:
+		case trigger::civilization_progress:
+		case trigger::social_movement_strength:
+		case trigger::political_movement_strength:
+		case trigger::life_needs:
+		case trigger::everyday_needs:
+		case trigger::luxury_needs:
+		case trigger::consciousness_pop:
+		case trigger::consciousness_province:
+		case trigger::consciousness_state:
+		case trigger::consciousness_nation:
+		case trigger::literacy_pop:
+		case trigger::literacy_province:
+		case trigger::literacy_state:
+		case trigger::literacy_nation:
+		case trigger::militancy_pop:
+		case trigger::militancy_province:
+		case trigger::militancy_state:
+		case trigger::militancy_nation:
+		case trigger::flashpoint_tension:
+		case trigger::crisis_temperature:
+		case trigger::rich_strata_life_needs_nation:
+		case trigger::rich_strata_life_needs_state:
+		case trigger::rich_strata_life_needs_province:
+		case trigger::rich_strata_everyday_needs_nation:
+		case trigger::rich_strata_everyday_needs_state:
+		case trigger::rich_strata_everyday_needs_province:
+		case trigger::rich_strata_luxury_needs_nation:
+		case trigger::rich_strata_luxury_needs_state:
+		case trigger::rich_strata_luxury_needs_province:
+		case trigger::middle_strata_life_needs_nation:
+		case trigger::middle_strata_life_needs_state:
+		case trigger::middle_strata_life_needs_province:
+		case trigger::middle_strata_everyday_needs_nation:
+		case trigger::middle_strata_everyday_needs_state:
+		case trigger::middle_strata_everyday_needs_province:
+		case trigger::middle_strata_luxury_needs_nation:
+		case trigger::middle_strata_luxury_needs_state:
+		case trigger::middle_strata_luxury_needs_province:
+		case trigger::poor_strata_life_needs_nation:
+		case trigger::poor_strata_life_needs_state:
+		case trigger::poor_strata_life_needs_province:
+		case trigger::poor_strata_everyday_needs_nation:
+		case trigger::poor_strata_everyday_needs_state:
+		case trigger::poor_strata_everyday_needs_province:
+		case trigger::poor_strata_luxury_needs_nation:
+		case trigger::poor_strata_luxury_needs_state:
+		case trigger::poor_strata_luxury_needs_province:
+		case trigger::pop_unemployment_nation:
+		case trigger::pop_unemployment_state:
+		case trigger::pop_unemployment_province:
+		case trigger::pop_unemployment_pop:
+		case trigger::pop_unemployment_nation_this_pop:
+		case trigger::pop_unemployment_state_this_pop:
+		case trigger::pop_unemployment_province_this_pop:
+		case trigger::check_variable:
+		case trigger::upper_house:
+		case trigger::war_exhaustion_pop:
+		case trigger::war_exhaustion_province:
+		case trigger::brigades_compare_province_this:
+		case trigger::brigades_compare_province_from:
+		case trigger::plurality_pop:
+		case trigger::flashpoint_tension_province:
+		case trigger::money_province:
+			return payload_kind::decimal;
+		case trigger::is_cultural_union_tag_nation:
+		case trigger::is_cultural_union_tag_this_pop:
+		case trigger::is_cultural_union_tag_this_state:
+		case trigger::is_cultural_union_tag_this_province:
+		case trigger::is_cultural_union_tag_this_nation:
+		case trigger::is_core_tag:
+		case trigger::owned_by_tag:
+		case trigger::exists_tag:
+		case trigger::casus_belli_tag:
+		case trigger::military_access_tag:
+		case trigger::tag_tag:
+		case trigger::neighbour_tag:
+		case trigger::war_with_tag:
+		case trigger::in_sphere_tag:
+		case trigger::controlled_by_tag:
+		case trigger::truce_with_tag:
+		case trigger::is_possible_vassal:
+		case trigger::vassal_of_tag:
+		case trigger::alliance_with_tag:
+		case trigger::in_default_tag:
+		case trigger::this_culture_union_tag:
+		case trigger::constructing_cb_tag:
+		case trigger::is_our_vassal_tag:
+		case trigger::substate_of_tag:
+		case trigger::is_sphere_leader_of_tag:
+		case trigger::tag_pop:
+		case trigger::owned_by_state_tag:
+		case trigger::units_in_province_tag:
+		case trigger::have_core_in_nation_tag:
+		case trigger::stronger_army_than_tag:
+		case trigger::is_core_state_tag:
+		case trigger::country_units_in_state_tag:
+		case trigger::is_core_pop_tag:
+		case trigger::is_our_vassal_province_tag:
+		case trigger::vassal_of_province_tag:
+		case trigger::military_score_tag:
+		case trigger::industrial_score_tag:
+			return payload_kind::tag;
+		case trigger::state_id_province:
+		case trigger::state_id_state:
+		case trigger::capital:
+		case trigger::owns:
+		case trigger::controls:
+		case trigger::is_core_integer:
+		case trigger::province_id:
+		case trigger::party_loyalty_nation_province_id:
+		case trigger::party_loyalty_from_nation_province_id:
+		case trigger::party_loyalty_province_province_id:
+		case trigger::party_loyalty_from_province_province_id:
+		case trigger::owns_province:
+			return payload_kind::province;
+		case trigger::tech_school:
+		case trigger::terrain_province:
+		case trigger::terrain_pop:
+		case trigger::continent_nation:
+		case trigger::continent_state:
+		case trigger::continent_province:
+		case trigger::continent_pop:
+		case trigger::has_country_modifier:
+		case trigger::has_province_modifier:
+		case trigger::nationalvalue_nation:
+		case trigger::nationalvalue_pop:
+		case trigger::nationalvalue_province:
+		case trigger::has_country_modifier_province:
+			return payload_kind::modifier;
+		case trigger::trade_goods:
+		case trigger::produces_nation:
+		case trigger::produces_state:
+		case trigger::produces_province:
+		case trigger::produces_pop:
+		case trigger::trade_goods_in_state_state:
+		case trigger::trade_goods_in_state_province:
+		case trigger::variable_good_name:
+			return payload_kind::commodity;
+		default:
+			return payload_kind::raw;
+		}
+	case 2:
+		switch(code) {
+		case trigger::party_loyalty_nation_province_id:
+		case trigger::party_loyalty_from_nation_province_id:
+		case trigger::party_loyalty_province_province_id:
+		case trigger::party_loyalty_from_province_province_id:
+			return payload_kind::signed_integer;
+		case trigger::variable_ideology_name_nation:
+		case trigger::variable_ideology_name_state:
+		case trigger::variable_ideology_name_province:
+		case trigger::variable_ideology_name_pop:
+		case trigger::variable_issue_name_nation:
+		case trigger::variable_issue_name_state:
+		case trigger::variable_issue_name_province:
+		case trigger::variable_issue_name_pop:
+		case trigger::variable_pop_type_name_nation:
+		case trigger::variable_pop_type_name_state:
+		case trigger::variable_pop_type_name_province:
+		case trigger::variable_pop_type_name_pop:
+		case trigger::variable_good_name:
+			return payload_kind::decimal;
+		case trigger::diplomatic_influence_tag:
+		case trigger::relation_tag:
+			return payload_kind::tag;
+		default:
+			return payload_kind::raw;
+		}
+	default:
+		return payload_kind::raw;
+	}
+}
+
+// how the effect function for the code reads the payload word at the given offset (1 being the word after the code)
+payload_kind effect_payload_kind(uint16_t code, int32_t offset) {
+	switch(offset) {
+	case 1:
+		switch(code) {
+		case effect::enable_canal:
+		case effect::remove_random_military_reforms:
+		case effect::remove_random_economic_reforms:
+		case effect::add_truce_this_nation:
+		case effect::add_truce_this_state:
+		case effect::add_truce_this_province:
+		case effect::add_truce_this_pop:
+		case effect::add_truce_from_nation:
+		case effect::add_truce_from_province:
+			return payload_kind::integer;
+		case effect::life_rating:
+		case effect::research_points:
+		case effect::infrastructure:
+		case effect::leadership:
+		case effect::rgo_size:
+		case effect::fort:
+		case effect::naval_base:
+		case effect::diplomatic_influence_this_nation:
+		case effect::diplomatic_influence_this_province:
+		case effect::diplomatic_influence_from_nation:
+		case effect::diplomatic_influence_from_province:
+		case effect::relation_this_nation:
+		case effect::relation_this_province:
+		case effect::relation_from_nation:
+		case effect::relation_from_province:
+		case effect::relation_reb:
+		case effect::life_rating_state:
+		case effect::infrastructure_state:
+		case effect::fort_state:
+		case effect::naval_base_state:
+		case effect::bank:
+		case effect::bank_state:
+		case effect::university:
+		case effect::university_state:
+			return payload_kind::signed_integer;
+		case effect::treasury:
+		case effect::war_exhaustion:
+		case effect::prestige:
+		case effect::badboy:
+		case effect::money:
+		case effect::plurality:
+		case effect::add_tax_relative_income:
+		case effect::reduce_pop:
+		case effect::years_of_research:
+		case effect::prestige_factor_positive:
+		case effect::prestige_factor_negative:
+		case effect::literacy:
+		case effect::flashpoint_tension:
+		case effect::add_crisis_temperature:
+		case effect::consciousness:
+		case effect::militancy:
+		case effect::scaled_militancy_unemployment:
+		case effect::scaled_consciousness_unemployment:
+		case effect::scaled_militancy_nation_unemployment:
+		case effect::scaled_consciousness_nation_unemployment:
+		case effect::scaled_militancy_state_unemployment:
+		case effect::scaled_consciousness_state_unemployment:
+		case effect::scaled_militancy_province_unemployment:
+		case effect::scaled_consciousness_province_unemployment:
+		case effect::reduce_pop_province:
+		case effect::reduce_pop_state:
+		case effect::reduce_pop_nation:
+		case effect::consciousness_province:
+		case effect::consciousness_state:
+		case effect::consciousness_nation:
+		case effect::militancy_province:
+		case effect::militancy_state:
+		case effect::militancy_nation:
+		case effect::flashpoint_tension_province:
+			return payload_kind::decimal;
+		case effect::add_core_tag:
+		case effect::remove_core_tag:
+		case effect::change_tag:
+		case effect::change_tag_no_core_switch:
+		case effect::military_access:
+		case effect::secede_province:
+		case effect::inherit:
+		case effect::annex_to:
+		case effect::release:
+		case effect::change_controller:
+		case effect::create_vassal:
+		case effect::end_military_access:
+		case effect::leave_alliance:
+		case effect::end_war:
+		case effect::create_alliance:
+		case effect::release_vassal:
+		case effect::diplomatic_influence:
+		case effect::relation:
+		case effect::war_tag:
+		case effect::war_no_ally_tag:
+		case effect::add_core_tag_state:
+		case effect::remove_core_tag_state:
+		case effect::secede_province_state:
+		case effect::change_controller_state:
+		case effect::remove_core_tag_nation:
+		case effect::add_truce_tag:
+			return payload_kind::tag;
+		case effect::capital:
+		case effect::add_core_int:
+		case effect::remove_core_int:
+		case effect::move_pop:
+		case effect::party_loyalty:
+			return payload_kind::province;
+		case effect::tech_school:
+		case effect::remove_province_modifier:
+		case effect::remove_country_modifier:
+		case effect::nationalvalue_province:
+		case effect::nationalvalue_nation:
+		case effect::add_province_modifier:
+		case effect::add_province_modifier_no_duration:
+		case effect::add_country_modifier:
+		case effect::add_country_modifier_no_duration:
+		case effect::add_province_modifier_state:
+		case effect::add_province_modifier_state_no_duration:
+		case effect::remove_province_modifier_state:
+		case effect::change_terrain_pop:
+		case effect::change_terrain_province:
+			return payload_kind::modifier;
+		case effect::trade_goods:
+		case effect::variable_good_name:
+		case effect::variable_good_name_province:
+			return payload_kind::commodity;
+		default:
+			return payload_kind::raw;
+		}
+	case 2:
+		switch(code) {
+		case effect::country_event_this_nation:
+		case effect::province_event_this_nation:
+		case effect::country_event_this_state:
+		case effect::province_event_this_state:
+		case effect::country_event_this_province:
+		case effect::province_event_this_province:
+		case effect::country_event_this_pop:
+		case effect::province_event_this_pop:
+		case effect::add_truce_tag:
+			return payload_kind::integer;
+		case effect::diplomatic_influence:
+		case effect::relation:
+		case effect::add_province_modifier:
+		case effect::add_country_modifier:
+		case effect::casus_belli_tag:
+		case effect::casus_belli_int:
+		case effect::casus_belli_this_nation:
+		case effect::casus_belli_this_state:
+		case effect::casus_belli_this_province:
+		case effect::casus_belli_this_pop:
+		case effect::casus_belli_from_nation:
+		case effect::casus_belli_from_province:
+		case effect::add_casus_belli_tag:
+		case effect::add_casus_belli_int:
+		case effect::add_casus_belli_this_nation:
+		case effect::add_casus_belli_this_state:
+		case effect::add_casus_belli_this_province:
+		case effect::add_casus_belli_this_pop:
+		case effect::add_casus_belli_from_nation:
+		case effect::add_casus_belli_from_province:
+		case effect::party_loyalty_province:
+		case effect::add_province_modifier_state:
+			return payload_kind::signed_integer;
+		case effect::set_variable:
+		case effect::change_variable:
+		case effect::ideology:
+		case effect::upper_house:
+		case effect::scaled_militancy_issue:
+		case effect::scaled_militancy_ideology:
+		case effect::scaled_consciousness_issue:
+		case effect::scaled_consciousness_ideology:
+		case effect::dominant_issue:
+		case effect::variable_good_name:
+		case effect::dominant_issue_nation:
+		case effect::scaled_militancy_nation_issue:
+		case effect::scaled_militancy_nation_ideology:
+		case effect::scaled_consciousness_nation_issue:
+		case effect::scaled_consciousness_nation_ideology:
+		case effect::scaled_militancy_state_issue:
+		case effect::scaled_militancy_state_ideology:
+		case effect::scaled_consciousness_state_issue:
+		case effect::scaled_consciousness_state_ideology:
+		case effect::scaled_militancy_province_issue:
+		case effect::scaled_militancy_province_ideology:
+		case effect::scaled_consciousness_province_issue:
+		case effect::scaled_consciousness_province_ideology:
+		case effect::variable_good_name_province:
+			return payload_kind::decimal;
+		case effect::remove_casus_belli_tag:
+		case effect::this_remove_casus_belli_tag:
+			return payload_kind::tag;
+		case effect::remove_casus_belli_int:
+		case effect::this_remove_casus_belli_int:
+		case effect::war_this_nation:
+		case effect::war_no_ally_this_nation:
+			return payload_kind::province;
+		default:
+			return payload_kind::raw;
+		}
+	case 3:
+		switch(code) {
+		case effect::party_loyalty:
+			return payload_kind::signed_integer;
+		case effect::move_issue_percentage_nation:
+		case effect::move_issue_percentage_state:
+		case effect::move_issue_percentage_province:
+		case effect::move_issue_percentage_pop:
+			return payload_kind::decimal;
+		case effect::casus_belli_tag:
+		case effect::add_casus_belli_tag:
+		case effect::war_this_nation:
+		case effect::war_no_ally_this_nation:
+			return payload_kind::tag;
+		case effect::casus_belli_int:
+		case effect::add_casus_belli_int:
+		case effect::war_tag:
+		case effect::war_no_ally_tag:
+		case effect::fop_change_province_name:
+			return payload_kind::province;
+		default:
+			return payload_kind::raw;
+		}
+	case 4:
+		switch(code) {
+		case effect::war_tag:
+		case effect::war_no_ally_tag:
+			return payload_kind::tag;
+		default:
+			return payload_kind::raw;
+		}
+	case 5:
+		switch(code) {
+		case effect::war_this_nation:
+		case effect::war_no_ally_this_nation:
+			return payload_kind::province;
+		default:
+			return payload_kind::raw;
+		}
+	case 6:
+		switch(code) {
+		case effect::war_this_nation:
+		case effect::war_no_ally_this_nation:
+			return payload_kind::tag;
+		case effect::war_tag:
+		case effect::war_no_ally_tag:
+			return payload_kind::province;
+		default:
+			return payload_kind::raw;
+		}
+	case 7:
+		switch(code) {
+		case effect::war_tag:
+		case effect::war_no_ally_tag:
+			return payload_kind::tag;
+		default:
+			return payload_kind::raw;
+		}
+	default:
+		return payload_kind::raw;
+	}
+}
+
+// payload words are named or printed as numbers where the code says what they hold, and printed in hex otherwise
+template<typename F>
+void append_payload(sys::state& state, std::string& out, uint16_t const* words, int32_t count, F const& kind_at) {
+	for(int32_t i = 0; i < count; ++i) {
+		auto const p = trigger::payload(words[i]);
+		switch(kind_at(i + 1)) {
+		case payload_kind::integer:
+			out += " " + std::to_string(words[i]);
+			continue;
+		case payload_kind::signed_integer:
+			out += " " + std::to_string(p.signed_value);
+			continue;
+		case payload_kind::decimal:
+			if(i + 1 < count) {
+				out += " " + text::format_float(trigger::read_float_from_payload(words + i), 3);
+				++i;
+				continue;
+			}
+			break;
+		case payload_kind::tag:
+			if(state.world.national_identity_is_valid(p.tag_id)) {
+				out += " " + nations::int_to_tag(state.world.national_identity_get_identifying_int(p.tag_id));
+				continue;
+			}
+			break;
+		case payload_kind::province:
+			if(state.world.province_is_valid(p.prov_id)) {
+				out += " " + text::produce_simple_string(state, state.world.province_get_name(p.prov_id));
+				continue;
+			}
+			break;
+		case payload_kind::modifier:
+			if(state.world.modifier_is_valid(p.mod_id)) {
+				out += " " + text::produce_simple_string(state, state.world.modifier_get_name(p.mod_id));
+				continue;
+			}
+			break;
+		case payload_kind::commodity:
+			if(state.world.commodity_is_valid(p.com_id)) {
+				out += " " + text::produce_simple_string(state, state.world.commodity_get_name(p.com_id));
+				continue;
+			}
+			break;
+		case payload_kind::raw:
+			break;
+		}
+		append_words(out, words + i, 1);
+	}
+}
+
+char const* association_name(uint16_t code) {
+	switch(code & trigger::association_mask) {
+	case trigger::association_eq:
+		return " ==";
+	case trigger::association_gt:
+		return " >";
+	case trigger::association_ge:
+		return " >=";
+	case trigger::association_lt:
+		return " <";
+	case trigger::association_le:
+		return " <=";
+	case trigger::association_ne:
+		return " !=";
+	default:
+		return "";
+	}
+}
+
+void disassemble_trigger_node(sys::state& state, std::string& out, uint16_t const* data, int32_t depth) {
+	auto const code = uint16_t(data[0] & trigger::code_mask);
+	indent(out, depth);
+	if(code >= trigger::first_invalid_code) {
+		out += "invalid";
+		append_words(out, data, 1);
+		out += "\n";
+		return;
+	}
+	if(code < trigger::first_scope_code) {
+		out += trigger_leaf_names[code];
+		out += association_name(data[0]);
+		append_payload(state, out, data + 1, trigger::get_trigger_non_scope_payload_size(data),
+				[code](int32_t offset) { return trigger_payload_kind(code, offset); });
+		if(code == trigger::test) {
+			out += " (";
+			out += text::produce_simple_string(state, state.world.stored_trigger_get_name(trigger::payload(data[1]).str_id));
+			out += ")";
+		}
+		out += "\n";
+		return;
+	}
+
+	bool const disjunctive = (data[0] & trigger::is_disjunctive_scope) != 0;
+	if(code == trigger::generic_scope) {
+		out += disjunctive ? "or" : "and";
+	} else {
+		out += trigger_scope_names[code - trigger::first_scope_code];
+		if((data[0] & trigger::is_existence_scope) != 0)
+			out += " (any)";
+		if(disjunctive)
+			out += " or";
+	}
+	append_words(out, data + 2, trigger::trigger_scope_data_payload(data[0]));
+	out += "\n";
+
+	auto const end = data + 1 + trigger::get_trigger_scope_payload_size(data);
+	for(auto sub = data + 2 + trigger::trigger_scope_data_payload(data[0]); sub < end; sub += 1 + trigger::get_trigger_payload_size(sub)) {
+		disassemble_trigger_node(state, out, sub, depth + 1);
+	}
+}
+
+void disassemble_effect_node(sys::state& state, std::string& out, uint16_t const* data, int32_t depth) {
+	auto const code = uint16_t(data[0] & effect::code_mask);
+	indent(out, depth);
+	if(code >= effect::first_invalid_code) {
+		out += "invalid";
+		append_words(out, data, 1);
+		out += "\n";
+		return;
+	}
+	if(code < effect::first_scope_code) {
+		out += effect_leaf_names[code];
+		append_payload(state, out, data + 1, effect::get_effect_non_scope_payload_size(data),
+				[code](int32_t offset) { return effect_payload_kind(code, offset); });
+		out += "\n";
+		return;
+	}
+
+	out += effect_scope_names[code - effect::first_scope_code];
+	auto const end = data + 1 + effect::get_effect_scope_payload_size(data);
+	if(code == effect::random_list_scope) {
+		out += " of";
+		append_words(out, data + 2, 1);
+		out += "\n";
+		for(auto sub = data + 3; sub < end; sub += 2 + effect::get_generic_effect_payload_size(sub + 1)) {
+			indent(out, depth + 1);
+			out += "chance " + std::to_string(sub[0]) + "\n";
+			disassemble_effect_node(state, out, sub + 1, depth + 2);
+		}
+		return;
+	}
+
+	if((data[0] & effect::is_random_scope) != 0)
+		out += " (random)";
+	bool const has_limit = (data[0] & effect::scope_has_limit) != 0;
+	auto const data_payload = effect::effect_scope_data_payload(data[0]);
+	append_words(out, data + 2 + (has_limit ? 1 : 0), data_payload - (has_limit ? 1 : 0));
+	out += "\n";
+	if(has_limit) {
+		if(auto limit = trigger::payload(data[2]).tr_id; limit) {
+			indent(out, depth + 1);
+			out += "limit\n";
+			disassemble_trigger_node(state, out, trigger_data_of(state, limit), depth + 2);
+		}
+	}
+	for(auto sub = data + 2 + data_payload; sub < end; sub += 1 + effect::get_generic_effect_payload_size(sub)) {
+		disassemble_effect_node(state, out, sub, depth + 1);
+	}
+}
+
+// how many objects an iterating scope visits; zero for scopes that move to a single object (or to none)
+float trigger_fanout(scenario_sizes const& sizes, uint16_t code) {
+	switch(code) {
+	case trigger::x_neighbor_province_scope:
+		return sizes.province_neighbors;
+	case trigger::x_neighbor_province_scope_state:
+		return sizes.province_neighbors * sizes.provinces_per_state;
+	case trigger::x_neighbor_country_scope_nation:
+	case trigger::x_neighbor_country_scope_pop:
+		return sizes.nation_neighbors;
+	case trigger::x_war_countries_scope_nation:
+	case trigger::x_war_countries_scope_pop:
+		return sizes.war_participants;
+	case trigger::x_greater_power_scope:
+		return sizes.great_powers;
+	case trigger::x_owned_province_scope_state:
+		return sizes.provinces_per_state;
+	case trigger::x_owned_province_scope_nation:
+		return sizes.provinces_per_nation;
+	case trigger::x_core_scope_province:
+		return sizes.cores_per_province;
+	case trigger::x_core_scope_nation:
+		return sizes.cores_per_nation;
+	case trigger::x_state_scope:
+		return sizes.states_per_nation;
+	case trigger::x_substate_scope:
+		return sizes.substates_per_nation;
+	case trigger::x_sphere_member_scope:
+		return sizes.sphere_members;
+	case trigger::x_pop_scope_province:
+		return sizes.pops_per_province;
+	case trigger::x_pop_scope_state:
+		return sizes.pops_per_state;
+	case trigger::x_pop_scope_nation:
+		return sizes.pops_per_nation;
+	case trigger::x_provinces_in_variable_region:
+		return sizes.provinces_per_state_definition;
+	case trigger::x_provinces_in_variable_region_proper:
+		return sizes.provinces_per_region;
+	case trigger::x_country_scope:
+		return sizes.nations;
+	default:
+		return 0.0f;
+	}
+}
+
+float effect_fanout(scenario_sizes const& sizes, uint16_t code) {
+	switch(code) {
+	case effect::x_neighbor_province_scope:
+	case effect::x_empty_neighbor_province_scope:
+		return sizes.province_neighbors;
+	case effect::x_neighbor_country_scope:
+		return sizes.nation_neighbors;
+	case effect::x_country_scope:
+	case effect::x_country_scope_nation:
+	case effect::x_event_country_scope:
+	case effect::x_decision_country_scope:
+	case effect::x_event_country_scope_nation:
+	case effect::x_decision_country_scope_nation:
+		return sizes.nations;
+	case effect::x_greater_power_scope:
+		return sizes.great_powers;
+	case effect::poor_strata_scope_nation:
+	case effect::middle_strata_scope_nation:
+	case effect::rich_strata_scope_nation:
+	case effect::x_pop_scope_nation:
+	case effect::pop_type_scope_nation:
+		return sizes.pops_per_nation;
+	case effect::poor_strata_scope_state:
+	case effect::middle_strata_scope_state:
+	case effect::rich_strata_scope_state:
+	case effect::x_pop_scope_state:
+	case effect::pop_type_scope_state:
+		return sizes.pops_per_state;
+	case effect::poor_strata_scope_province:
+	case effect::middle_strata_scope_province:
+	case effect::rich_strata_scope_province:
+	case effect::x_pop_scope_province:
+	case effect::pop_type_scope_province:
+		return sizes.pops_per_province;
+	case effect::x_owned_scope_nation:
+		return sizes.provinces_per_nation;
+	case effect::x_owned_scope_state:
+		return sizes.provinces_per_state;
+	case effect::x_core_scope:
+		return sizes.cores_per_nation;
+	case effect::x_core_scope_province:
+		return sizes.cores_per_province;
+	case effect::x_state_scope:
+		return sizes.states_per_nation;
+	case effect::x_substate_scope:
+		return sizes.substates_per_nation;
+	case effect::region_scope:
+		return sizes.provinces_per_state_definition;
+	case effect::region_proper_scope:
+		return sizes.provinces_per_region;
+	default:
+		return 0.0f;
+	}
+}
+
+void add_sequential(cost_estimate& total, cost_estimate const& part, double weight) {
+	total.evaluations += part.evaluations * weight;
+	total.iterating_scopes += part.iterating_scopes;
+	total.deepest_nesting = std::max(total.deepest_nesting, part.deepest_nesting);
+}
+
+cost_estimate trigger_node_cost(sys::state& state, scenario_sizes const& sizes, uint16_t const* data, int32_t stored_depth) {
+	cost_estimate result;
+	auto const code = uint16_t(data[0] & trigger::code_mask);
+	if(code >= trigger::first_invalid_code)
+		return result;
+	if(code < trigger::first_scope_code) {
+		result.evaluations = 1.0;
+		if(code == trigger::test && stored_depth < max_stored_trigger_depth) {
+			if(auto key = state.world.stored_trigger_get_function(trigger::payload(data[1]).str_id); key)
+				add_sequential(result, trigger_node_cost(state, sizes, trigger_data_of(state, key), stored_depth + 1), 1.0);
+		}
+		return result;
+	}
+
+	cost_estimate members;
+	auto const end = data + 1 + trigger::get_trigger_scope_payload_size(data);
+	for(auto sub = data + 2 + trigger::trigger_scope_data_payload(data[0]); sub < end; sub += 1 + trigger::get_trigger_payload_size(sub)) {
+		add_sequential(members, trigger_node_cost(state, sizes, sub, stored_depth), 1.0);
+	}
+	if(auto fanout = trigger_fanout(sizes, code); fanout > 0.0f) {
+		result.evaluations = members.evaluations * fanout;
+		result.iterating_scopes = members.iterating_scopes + 1;
+		result.deepest_nesting = members.deepest_nesting + 1;
+		return result;
+	}
+	return members;
+}
+
+cost_estimate effect_node_cost(sys::state& state, scenario_sizes const& sizes, uint16_t const* data) {
+	cost_estimate result;
+	auto const code = uint16_t(data[0] & effect::code_mask);
+	if(code >= effect::first_invalid_code)
+		return result;
+	if(code < effect::first_scope_code) {
+		result.evaluations = 1.0;
+		return result;
+	}
+
+	auto const end = data + 1 + effect::get_effect_scope_payload_size(data);
+	if(code == effect::random_list_scope) {
+		// only one member is executed, in proportion to its chance
+		double const total_chance = std::max(double(data[2]), 1.0);
+		for(auto sub = data + 3; sub < end; sub += 2 + effect::get_generic_effect_payload_size(sub + 1)) {
+			add_sequential(result, effect_node_cost(state, sizes, sub + 1), double(sub[0]) / total_chance);
+		}
+		return result;
+	}
+
+	bool const has_limit = (data[0] & effect::scope_has_limit) != 0;
+	cost_estimate limit;
+	if(has_limit) {
+		if(auto key = trigger::payload(data[2]).tr_id; key)
+			limit = trigger_node_cost(state, sizes, trigger_data_of(state, key), 0);
+	}
+	cost_estimate members;
+	for(auto sub = data + 2 + effect::effect_scope_data_payload(data[0]); sub < end; sub += 1 + effect::get_generic_effect_payload_size(sub)) {
+		add_sequential(members, effect_node_cost(state, sizes, sub), 1.0);
+	}
+
+	if(code == effect::random_scope) {
+		auto const chance = double(data[2 + (has_limit ? 1 : 0)]) / 100.0;
+		add_sequential(result, limit, 1.0);
+		add_sequential(result, members, std::clamp(chance, 0.0, 1.0));
+		return result;
+	}
+	auto const fanout = effect_fanout(sizes, code);
+	if(fanout <= 0.0f) {
+		add_sequential(result, limit, 1.0);
+		add_sequential(result, members, 1.0);
+		return result;
+	}
+	if((data[0] & effect::is_random_scope) != 0) {
+		// the limit is tested against every candidate, but the effects are applied to only one of them
+		add_sequential(result, limit, fanout);
+		add_sequential(result, members, 1.0);
+	} else {
+		add_sequential(result, limit, fanout);
+		add_sequential(result, members, fanout);
+	}
+	result.iterating_scopes += 1;
+	result.deepest_nesting += 1;
+	return result;
+}
+
+float average(double total, double count) {
+	return count > 0.0 ? std::max(float(total / count), 1.0f) : 1.0f;
+}
+
+void add_owner(std::vector<std::string>& owners, uint32_t index, std::string const& owner) {
+	auto& o = owners[index];
+	if(!o.empty())
+		o += "; ";
+	o += owner;
+}
+void add_owner(std::vector<std::string>& owners, dcon::effect_key key, std::string const& owner) {
+	if(key)
+		add_owner(owners, uint32_t(key.index()), owner);
+}
+void add_owner(std::vector<std::string>& owners, dcon::value_modifier_key key, std::string const& owner) {
+	if(key)
+		add_owner(owners, uint32_t(key.index()), owner);
+}
+
+} // namespace
+
+scenario_sizes measure_sizes(sys::state& state) {
+	scenario_sizes result;
+
+	double owning_nations = 0.0;
+	double nations_with_subjects = 0.0;
+	for(auto n : state.world.in_nation) {
+		if(n.get_owned_province_count() != 0)
+			owning_nations += 1.0;
+		for(auto o : n.get_overlord_as_ruler()) {
+			(void)o;
+			nations_with_subjects += 1.0;
+			break;
+		}
+	}
+	double owned_provinces = 0.0;
+	double pops_in_owned_provinces = 0.0;
+	for(auto p : state.world.in_province) {
+		if(p.get_nation_from_province_ownership()) {
+			owned_provinces += 1.0;
+			for(auto pl : p.get_pop_location()) {
+				(void)pl;
+				pops_in_owned_provinces += 1.0;
+			}
+		}
+	}
+	double sphere_members = 0.0;
+	for(auto n : state.world.in_nation) {
+		if(n.get_in_sphere_of())
+			sphere_members += 1.0;
+	}
+
+	auto const owned_states = double(state.world.state_instance_size());
+	result.nations = std::max(float(owning_nations), 1.0f);
+	result.great_powers = std::max(float(state.great_nations.size()), 1.0f);
+	result.provinces_per_nation = average(owned_provinces, owning_nations);
+	result.states_per_nation = average(owned_states, owning_nations);
+	result.provinces_per_state = average(owned_provinces, owned_states);
+	result.province_neighbors = average(2.0 * double(state.world.province_adjacency_size()), double(state.world.province_size()));
+	result.nation_neighbors = average(2.0 * double(state.world.nation_adjacency_size()), owning_nations);
+	result.pops_per_province = average(pops_in_owned_provinces, owned_provinces);
+	result.pops_per_state = average(pops_in_owned_provinces, owned_states);
+	result.pops_per_nation = average(pops_in_owned_provinces, owning_nations);
+	result.cores_per_province = average(double(state.world.core_size()), double(state.world.province_size()));
+	result.cores_per_nation = average(double(state.world.core_size()), owning_nations);
+	result.substates_per_nation = average(double(state.world.overlord_size()), nations_with_subjects);
+	result.sphere_members = average(sphere_members, double(state.great_nations.size()));
+	result.war_participants = average(double(state.world.war_participant_size()), double(state.world.war_size()));
+	result.provinces_per_state_definition = average(double(state.world.abstract_state_membership_size()), double(state.world.state_definition_size()));
+	result.provinces_per_region = average(double(state.world.region_membership_size()), double(state.world.region_size()));
+	return result;
+}
+
+std::string disassemble_trigger(sys::state& state, uint16_t const* data) {
+	std::string out;
+	disassemble_trigger_node(state, out, data, 0);
+	return out;
+}
+
+std::string disassemble_effect(sys::state& state, uint16_t const* data) {
+	std::string out;
+	disassemble_effect_node(state, out, data, 0);
+	return out;
+}
+
+std::string disassemble_value_modifier(sys::state& state, dcon::value_modifier_key modifier) {
+	auto const& d = state.value_modifiers[modifier];
+	std::string out = "factor " + std::to_string(d.factor) + " base " + std::to_string(d.base) + "\n";
+	for(uint32_t i = 0; i < d.segments_count; ++i) {
+		auto const& seg = state.value_modifier_segments[d.first_segment_offset + i];
+		out += "\tsegment factor " + std::to_string(seg.factor) + "\n";
+		if(seg.condition)
+			disassemble_trigger_node(state, out, trigger_data_of(state, seg.condition), 2);
+	}
+	return out;
+}
+
+cost_estimate estimate_trigger_cost(sys::state& state, scenario_sizes const& sizes, uint16_t const* data) {
+	return trigger_node_cost(state, sizes, data, 0);
+}
+
+cost_estimate estimate_effect_cost(sys::state& state, scenario_sizes const& sizes, uint16_t const* data) {
+	return effect_node_cost(state, sizes, data);
+}
+
+cost_estimate estimate_value_modifier_cost(sys::state& state, scenario_sizes const& sizes, dcon::value_modifier_key modifier) {
+	// every segment is tested each time the modifier is evaluated
+	cost_estimate result;
+	auto const& d = state.value_modifiers[modifier];
+	for(uint32_t i = 0; i < d.segments_count; ++i) {
+		if(auto c = state.value_modifier_segments[d.first_segment_offset + i].condition; c)
+			add_sequential(result, trigger_node_cost(state, sizes, trigger_data_of(state, c), 0), 1.0);
+	}
+	return result;
+}
+
+std::vector<std::string> effect_owners(sys::state& state) {
+	std::vector<std::string> owners(state.effect_data_indices.empty() ? size_t(0) : state.effect_data_indices.size() - 1);
+
+	for(auto e : state.world.in_national_event) {
+		auto name = "fixed national event (" + text::produce_simple_string(state, e.get_name()) + ")";
+		add_owner(owners, e.get_immediate_effect(), name + " immediate");
+		for(auto& o : e.get_options())
+			add_owner(owners, o.effect, name + " option");
+	}
+	for(auto e : state.world.in_provincial_event) {
+		auto name = "fixed province event (" + text::produce_simple_string(state, e.get_name()) + ")";
+		add_owner(owners, e.get_immediate_effect(), name + " immediate");
+		for(auto& o : e.get_options())
+			add_owner(owners, o.effect, name + " option");
+	}
+	for(auto e : state.world.in_free_national_event) {
+		auto name = "national event " + std::to_string(e.get_legacy_id()) + " (" + text::produce_simple_string(state, e.get_name()) + ")";
+		add_owner(owners, e.get_immediate_effect(), name + " immediate");
+		for(auto& o : e.get_options())
+			add_owner(owners, o.effect, name + " option");
+	}
+	for(auto e : state.world.in_free_provincial_event) {
+		auto name = "province event (" + text::produce_simple_string(state, e.get_name()) + ")";
+		add_owner(owners, e.get_immediate_effect(), name + " immediate");
+		for(auto& o : e.get_options())
+			add_owner(owners, o.effect, name + " option");
+	}
+	for(auto d : state.world.in_decision) {
+		add_owner(owners, d.get_effect(), "decision " + text::produce_simple_string(state, d.get_name()) + " effect");
+	}
+	for(auto i : state.world.in_issue_option) {
+		add_owner(owners, i.get_on_execute_effect(), "issue option " + text::produce_simple_string(state, i.get_name()) + " on_execute");
+	}
+	for(auto r : state.world.in_reform_option) {
+		add_owner(owners, r.get_on_execute_effect(), "reform option " + text::produce_simple_string(state, r.get_name()) + " on_execute");
+	}
+	for(auto c : state.world.in_cb_type) {
+		auto name = "casus belli " + text::produce_simple_string(state, c.get_name());
+		add_owner(owners, c.get_on_add(), name + " on_add");
+		add_owner(owners, c.get_on_po_accepted(), name + " on_po_accepted");
+	}
+	for(auto r : state.world.in_rebel_type) {
+		auto name = "rebel type " + text::produce_simple_string(state, r.get_name());
+		add_owner(owners, r.get_siege_won_effect(), name + " siege_won_effect");
+		add_owner(owners, r.get_demands_enforced_effect(), name + " demands_enforced_effect");
+	}
+	return owners;
+}
+
+std::vector<std::string> value_modifier_owners(sys::state& state) {
+	std::vector<std::string> owners(state.value_modifiers.size());
+
+	for(auto e : state.world.in_national_event) {
+		auto name = "fixed national event (" + text::produce_simple_string(state, e.get_name()) + ")";
+		for(auto& o : e.get_options())
+			add_owner(owners, o.ai_chance, name + " ai_chance");
+	}
+	for(auto e : state.world.in_provincial_event) {
+		auto name = "fixed province event (" + text::produce_simple_string(state, e.get_name()) + ")";
+		for(auto& o : e.get_options())
+			add_owner(owners, o.ai_chance, name + " ai_chance");
+	}
+	for(auto e : state.world.in_free_national_event) {
+		auto name = "national event " + std::to_string(e.get_legacy_id()) + " (" + text::produce_simple_string(state, e.get_name()) + ")";
+		add_owner(owners, e.get_mtth(), name + " mtth");
+		for(auto& o : e.get_options())
+			add_owner(owners, o.ai_chance, name + " ai_chance");
+	}
+	for(auto e : state.world.in_free_provincial_event) {
+		auto name = "province event (" + text::produce_simple_string(state, e.get_name()) + ")";
+		add_owner(owners, e.get_mtth(), name + " mtth");
+		for(auto& o : e.get_options())
+			add_owner(owners, o.ai_chance, name + " ai_chance");
+	}
+	for(auto d : state.world.in_decision) {
+		add_owner(owners, d.get_ai_will_do(), "decision " + text::produce_simple_string(state, d.get_name()) + " ai_will_do");
+	}
+	for(auto r : state.world.in_rebel_type) {
+		auto name = "rebel type " + text::produce_simple_string(state, r.get_name());
+		add_owner(owners, r.get_will_rise(), name + " will_rise");
+		add_owner(owners, r.get_spawn_chance(), name + " spawn_chance");
+		add_owner(owners, r.get_movement_evaluation(), name + " movement_evaluation");
+	}
+	for(auto i : state.world.in_ideology) {
+		auto name = "ideology " + text::produce_simple_string(state, i.get_name());
+		add_owner(owners, i.get_add_political_reform(), name + " add_political_reform");
+		add_owner(owners, i.get_remove_political_reform(), name + " remove_political_reform");
+		add_owner(owners, i.get_add_social_reform(), name + " add_social_reform");
+		add_owner(owners, i.get_remove_social_reform(), name + " remove_social_reform");
+		add_owner(owners, i.get_add_military_reform(), name + " add_military_reform");
+		add_owner(owners, i.get_add_economic_reform(), name + " add_economic_reform");
+	}
+	for(auto t : state.world.in_technology) {
+		add_owner(owners, t.get_ai_chance(), "technology " + text::produce_simple_string(state, t.get_name()) + " ai_chance");
+	}
+	for(auto i : state.world.in_invention) {
+		add_owner(owners, i.get_chance(), "invention " + text::produce_simple_string(state, i.get_name()) + " chance");
+	}
+	for(auto p : state.world.in_pop_type) {
+		auto name = "pop type " + text::produce_simple_string(state, p.get_name());
+		add_owner(owners, p.get_migration_target(), name + " migration_target");
+		add_owner(owners, p.get_country_migration_target(), name + " country_migration_target");
+		for(auto o : state.world.in_issue_option)
+			add_owner(owners, state.world.pop_type_get_issues(p, o), name + " issues");
+		for(auto i : state.world.in_ideology)
+			add_owner(owners, state.world.pop_type_get_ideology(p, i), name + " ideology");
+		for(auto q : state.world.in_pop_type)
+			add_owner(owners, state.world.pop_type_get_promotion(p, q), name + " promotion");
+	}
+	auto const& c = state.culture_definitions;
+	add_owner(owners, c.promotion_chance, "pop types promotion_chance");
+	add_owner(owners, c.demotion_chance, "pop types demotion_chance");
+	add_owner(owners, c.migration_chance, "pop types migration_chance");
+	add_owner(owners, c.colonialmigration_chance, "pop types colonialmigration_chance");
+	add_owner(owners, c.emigration_chance, "pop types emigration_chance");
+	add_owner(owners, c.assimilation_chance, "pop types assimilation_chance");
+	add_owner(owners, c.conversion_chance, "pop types conversion_chance");
+	return owners;
+}
+
+} // namespace script_inspection
@@ -0,0 +1,57 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "dcon_generated.hpp"
+
+namespace sys {
+struct state;
+}
+
+// Static inspection of the trigger, effect and value modifier bytecode of a loaded scenario: a readable disassembly, and an
+// estimate of how much work one evaluation does, based on how many objects the scopes that iterate will typically visit in
+// this scenario. Used by the script_inspector tool to flag scripts that will be expensive before they are ever run.
+namespace script_inspection {
+
+// the average number of objects that each kind of iterating scope visits, measured from the scenario (never less than one)
+struct scenario_sizes {
+	float nations = 1.0f; // that own provinces
+	float great_powers = 1.0f;
+	float provinces_per_nation = 1.0f;
+	float states_per_nation = 1.0f;
+	float provinces_per_state = 1.0f;
+	float province_neighbors = 1.0f;
+	float nation_neighbors = 1.0f;
+	float pops_per_province = 1.0f;
+	float pops_per_state = 1.0f;
+	float pops_per_nation = 1.0f;
+	float cores_per_province = 1.0f;
+	float cores_per_nation = 1.0f;
+	float substates_per_nation = 1.0f;
+	float sphere_members = 1.0f;
+	float war_participants = 1.0f; // per war
+	float provinces_per_state_definition = 1.0f;
+	float provinces_per_region = 1.0f;
+};
+
+struct cost_estimate {
+	double evaluations = 0.0; // expected number of conditions tested (and effects applied), assuming no early exits
+	int32_t iterating_scopes = 0;
+	int32_t deepest_nesting = 0; // of iterating scopes within one another
+};
+
+scenario_sizes measure_sizes(sys::state& state);
+
+std::string disassemble_trigger(sys::state& state, uint16_t const* data);
+std::string disassemble_effect(sys::state& state, uint16_t const* data);
+std::string disassemble_value_modifier(sys::state& state, dcon::value_modifier_key modifier);
+
+cost_estimate estimate_trigger_cost(sys::state& state, scenario_sizes const& sizes, uint16_t const* data);
+cost_estimate estimate_effect_cost(sys::state& state, scenario_sizes const& sizes, uint16_t const* data);
+cost_estimate estimate_value_modifier_cost(sys::state& state, scenario_sizes const& sizes, dcon::value_modifier_key modifier);
+
+// what each effect and value modifier belongs to, indexed by key, as trigger_profile::trigger_owners does for triggers
+std::vector<std::string> effect_owners(sys::state& state);
+std::vector<std::string> value_modifier_owners(sys::state& state);
+
+} // namespace script_inspection
@@ -0,0 +1,98 @@
+#include <cstdio>
+#include "trigger_compiler.hpp"
+#include "system_state.hpp"
+#include "script_constants.hpp"
+#include "simple_fs.hpp"
+
+namespace trigger {
+
+namespace {
+
+void indent(std::string& out, int32_t depth) {
+	out.append(size_t(depth), '\t');
+}
+
+std::string hex(uint32_t v) {
+	char buffer[16];
+	std::snprintf(buffer, sizeof(buffer), "0x%04X", v);
+	return buffer;
+}
+
+// appends an expression evaluating the trigger at the given offset
+void compile_node(std::string& out, uint16_t const* data, int32_t offset, int32_t depth) {
+	auto const code = uint16_t(data[offset] & trigger::code_mask);
+	if(code < trigger::first_scope_code) {
+		out += "CT_LEAF(" + hex(code) + ", " + std::to_string(offset) + ")";
+		return;
+	}
+	if(code != trigger::generic_scope) {
+		out += "CT_SCOPE(" + std::to_string(offset) + ")";
+		return;
+	}
+
+	// the same sequence of tests, in the same order and with the same early exits, as apply_subtriggers
+	bool const disjunctive = (data[offset] & trigger::is_disjunctive_scope) != 0;
+	auto const source_size = 1 + get_trigger_scope_payload_size(data + offset);
+	auto sub_unit = offset + 2 + trigger_scope_data_payload(data[offset]);
+
+	out += "[&]() -> return_type {\n";
+	indent(out, depth + 1);
+	out += disjunctive ? "auto r = return_type(false);\n" : "auto r = return_type(true);\n";
+	while(sub_unit < offset + source_size) {
+		indent(out, depth + 1);
+		out += disjunctive ? "r = r | " : "r = r & ";
+		compile_node(out, data, sub_unit, depth + 1);
+		out += ";\n";
+		indent(out, depth + 1);
+		out += disjunctive ? "if(CT_ALL_TRUE(r)) return r;\n" : "if(CT_ALL_FALSE(r)) return r;\n";
+		sub_unit += 1 + get_trigger_payload_size(data + sub_unit);
+	}
+	indent(out, depth + 1);
+	out += "return r;\n";
+	indent(out, depth);
+	out += "}()";
+}
+
+} // namespace
+
+uint64_t bytecode_checksum(sys::state const& state) {
+	uint64_t hashes[2] = {
+		ankerl::unordered_dense::detail::wyhash::hash(state.trigger_data.data(), sizeof(uint16_t) * state.trigger_data.size()),
+		ankerl::unordered_dense::detail::wyhash::hash(state.trigger_data_indices.data(), sizeof(int32_t) * state.trigger_data_indices.size())
+	};
+	return ankerl::unordered_dense::detail::wyhash::hash(hashes, sizeof(hashes));
+}
+
+std::string compile_to_cpp(sys::state const& state) {
+	auto const count = state.trigger_data_indices.empty() ? int32_t(0) : int32_t(state.trigger_data_indices.size() - 1);
+	char checksum[32];
+	std::snprintf(checksum, sizeof(checksum), "0x%016llXull", (unsigned long long)bytecode_checksum(state));
+
+	std::string out;
+	out += "// Generated by trigger::compile_to_cpp, see trigger_compiler.hpp. Do not edit.\n";
+	out += "inline constexpr uint64_t compiled_triggers_checksum = ";
+	out += checksum;
+	out += ";\n";
+	out += "inline constexpr int32_t compiled_triggers_count = " + std::to_string(count) + ";\n\n";
+
+	for(int32_t i = 0; i < count; ++i) {
+		out += "COMPILED_TRIGGER(" + std::to_string(i) + ") {\n\treturn ";
+		compile_node(out, state.trigger_data.data(), state.trigger_data_indices[i + 1], 1);
+		out += ";\n}\n";
+	}
+
+	out += "\nCOMPILED_TRIGGER_TABLE_BEGIN\n";
+	for(int32_t i = 0; i < count; ++i) {
+		out += "\tCOMPILED_TRIGGER_ENTRY(" + std::to_string(i) + ")\n";
+	}
+	out += "COMPILED_TRIGGER_TABLE_END\n";
+	return out;
+}
+
+void write_compiled_triggers(sys::state& state) {
+	auto source = compile_to_cpp(state);
+	auto sdir = simple_fs::get_or_create_oos_directory();
+	simple_fs::write_file(sdir, NATIVE("compiled_triggers.hpp"), source.data(), uint32_t(source.size()));
+}
+
+} // namespace trigger
@@ -0,0 +1,22 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+
+namespace sys {
+struct state;
+}
+
+// Ahead of time compilation of a scenario's triggers to C++. The generated file is built into the game by configuring it
+// with -DALICE_COMPILED_TRIGGERS=<path>, after which any scenario with the same trigger bytecode evaluates its triggers by key
+// through the compiled functions instead of the interpreter (which remains the reference, and is still used for everything
+// else). Generic scopes are unrolled into straight-line code and every leaf is called directly; other scopes are handed back
+// to the interpreter, which then continues to interpret their members.
+namespace trigger {
+
+// identifies the trigger bytecode that a compiled file was generated from
+uint64_t bytecode_checksum(sys::state const& state);
+
+std::string compile_to_cpp(sys::state const& state);
+void write_compiled_triggers(sys::state& state); // writes compiled_triggers.hpp to the oos dump directory
+
+} // namespace trigger
@@ -0,0 +1,234 @@
+#include <algorithm>
+#include "trigger_profiler.hpp"
+#include "system_state.hpp"
+#include "simple_fs.hpp"
+#include "text.hpp"
+
+namespace trigger_profile {
+
+namespace {
+
+trigger_record triggers[max_triggers];
+thread_local uint32_t sample_countdown = 0;
+
+void add_owner(std::vector<std::string>& owners, dcon::trigger_key key, std::string const& owner) {
+	if(!key)
+		return;
+	auto& o = owners[key.index()];
+	if(!o.empty())
+		o += "; ";
+	o += owner;
+}
+
+// a value modifier evaluates the condition of each of its segments
+void add_owner(sys::state& state, std::vector<std::string>& owners, dcon::value_modifier_key key, std::string const& owner) {
+	if(!key)
+		return;
+	auto const& d = state.value_modifiers[key];
+	for(uint32_t i = 0; i < d.segments_count; ++i) {
+		add_owner(owners, state.value_modifier_segments[d.first_segment_offset + i].condition, owner);
+	}
+}
+
+std::string csv_field(std::string const& s) {
+	if(s.find_first_of(",\"\n") == std::string::npos)
+		return s;
+	std::string out = "\"";
+	for(auto c : s) {
+		if(c == '"')
+			out += '"';
+		out += c;
+	}
+	out += '"';
+	return out;
+}
+
+} // namespace
+
+void record_call(dcon::trigger_key key) {
+	triggers[key.index()].calls.fetch_add(1, std::memory_order::relaxed);
+}
+
+bool should_sample() {
+	if(sample_countdown == 0) {
+		sample_countdown = sample_interval - 1;
+		return true;
+	}
+	--sample_countdown;
+	return false;
+}
+
+void record_sample(dcon::trigger_key key, int64_t nanoseconds) {
+	auto& t = triggers[key.index()];
+	t.samples.fetch_add(1, std::memory_order::relaxed);
+	t.sampled_nanoseconds.fetch_add(uint64_t(std::max(nanoseconds, int64_t(0))), std::memory_order::relaxed);
+}
+
+std::vector<trigger_summary> summarize() {
+	std::vector<trigger_summary> result;
+	for(size_t i = 0; i < max_triggers; ++i) {
+		auto samples = triggers[i].samples.load(std::memory_order::relaxed);
+		if(samples == 0)
+			continue;
+		trigger_summary s;
+		s.key = dcon::trigger_key{ dcon::trigger_key::value_base_t(i) };
+		s.calls = triggers[i].calls.load(std::memory_order::relaxed);
+		s.samples = samples;
+		s.mean_us = double(triggers[i].sampled_nanoseconds.load(std::memory_order::relaxed)) / double(samples) / 1000.0;
+		s.estimated_total_ms = s.mean_us * double(s.calls) / 1000.0;
+		result.push_back(s);
+	}
+	// ties are broken by the key, so that the order does not depend on the sort
+	std::sort(result.begin(), result.end(), [](trigger_summary const& a, trigger_summary const& b) {
+		if(a.estimated_total_ms != b.estimated_total_ms)
+			return a.estimated_total_ms > b.estimated_total_ms;
+		return a.key.index() < b.key.index();
+	});
+	return result;
+}
+
+void reset() {
+	for(auto& t : triggers) {
+		t.calls.store(0, std::memory_order::relaxed);
+		t.samples.store(0, std::memory_order::relaxed);
+		t.sampled_nanoseconds.store(0, std::memory_order::relaxed);
+	}
+}
+
+std::vector<std::string> trigger_owners(sys::state& state) {
+	std::vector<std::string> owners(max_triggers);
+
+	for(auto e : state.world.in_free_national_event) {
+		auto name = "national event " + std::to_string(e.get_legacy_id()) + " (" + text::produce_simple_string(state, e.get_name()) + ")";
+		add_owner(owners, e.get_trigger(), name + " trigger");
+		add_owner(state, owners, e.get_mtth(), name + " mtth");
+		for(auto& o : e.get_options()) {
+			add_owner(state, owners, o.ai_chance, name + " ai_chance");
+		}
+	}
+	for(auto e : state.world.in_free_provincial_event) {
+		auto name = "province event (" + text::produce_simple_string(state, e.get_name()) + ")";
+		add_owner(owners, e.get_trigger(), name + " trigger");
+		add_owner(state, owners, e.get_mtth(), name + " mtth");
+		for(auto& o : e.get_options()) {
+			add_owner(state, owners, o.ai_chance, name + " ai_chance");
+		}
+	}
+	// fixed events are only ever fired from the on_actions, whose conditions are listed below
+	for(auto e : state.world.in_national_event) {
+		auto name = "national event (" + text::produce_simple_string(state, e.get_name()) + ")";
+		for(auto& o : e.get_options()) {
+			add_owner(state, owners, o.ai_chance, name + " ai_chance");
+		}
+	}
+	for(auto e : state.world.in_provincial_event) {
+		auto name = "province event (" + text::produce_simple_string(state, e.get_name()) + ")";
+		for(auto& o : e.get_options()) {
+			add_owner(state, owners, o.ai_chance, name + " ai_chance");
+		}
+	}
+	auto add_on_action = [&](std::vector<nations::fixed_event> const& events, char const* on_action) {
+		for(auto& e : events) {
+			add_owner(owners, e.condition, std::string(on_action) + " (" + text::produce_simple_string(state, state.world.national_event_get_name(e.id)) + ")");
+		}
+	};
+	auto add_province_on_action = [&](std::vector<nations::fixed_province_event> const& events, char const* on_action) {
+		for(auto& e : events) {
+			add_owner(owners, e.condition, std::string(on_action) + " (" + text::produce_simple_string(state, state.world.provincial_event_get_name(e.id)) + ")");
+		}
+	};
+	auto& nd = state.national_definitions;
+	add_on_action(nd.on_yearly_pulse, "on_yearly_pulse");
+	add_on_action(nd.on_quarterly_pulse, "on_quarterly_pulse");
+	add_province_on_action(nd.on_battle_won, "on_battle_won");
+	add_province_on_action(nd.on_battle_lost, "on_battle_lost");
+	add_on_action(nd.on_surrender, "on_surrender");
+	add_on_action(nd.on_new_great_nation, "on_new_great_nation");
+	add_on_action(nd.on_lost_great_nation, "on_lost_great_nation");
+	for(auto& e : nd.on_election_tick) {
+		add_owner(owners, e.condition, "on_election_tick (" + text::produce_simple_string(state, state.world.national_event_get_name(e.id)) + ")");
+	}
+	add_on_action(nd.on_colony_to_state, "on_colony_to_state");
+	add_on_action(nd.on_state_conquest, "on_state_conquest");
+	add_on_action(nd.on_colony_to_state_free_slaves, "on_colony_to_state_free_slaves");
+	add_on_action(nd.on_debtor_default, "on_debtor_default");
+	add_on_action(nd.on_debtor_default_small, "on_debtor_default_small");
+	add_on_action(nd.on_debtor_default_second, "on_debtor_default_second");
+	add_on_action(nd.on_civilize, "on_civilize");
+	add_on_action(nd.on_my_factories_nationalized, "on_my_factories_nationalized");
+	add_on_action(nd.on_crisis_declare_interest, "on_crisis_declare_interest");
+	add_on_action(nd.on_election_started, "on_election_started");
+	add_on_action(nd.on_election_finished, "on_election_finished");
+	for(auto d : state.world.in_decision) {
+		auto name = "decision " + text::produce_simple_string(state, d.get_name());
+		add_owner(owners, d.get_potential(), name + " potential");
+		add_owner(owners, d.get_allow(), name + " allow");
+		add_owner(state, owners, d.get_ai_will_do(), name + " ai_will_do");
+	}
+	for(auto& m : state.national_definitions.triggered_modifiers) {
+		add_owner(owners, m.trigger_condition, "triggered modifier " + text::produce_simple_string(state, state.world.modifier_get_name(m.linked_modifier)));
+	}
+	for(auto f : state.world.in_national_focus) {
+		add_owner(owners, f.get_limit(), "national focus " + text::produce_simple_string(state, f.get_name()) + " limit");
+	}
+	for(auto c : state.world.in_cb_type) {
+		add_owner(owners, c.get_can_use(), "casus belli " + text::produce_simple_string(state, c.get_name()) + " can_use");
+	}
+	for(auto i : state.world.in_invention) {
+		add_owner(owners, i.get_limit(), "invention " + text::produce_simple_string(state, i.get_name()) + " limit");
+	}
+	for(auto pt : state.world.in_pop_type) {
+		auto name = "pop type " + text::produce_simple_string(state, pt.get_name());
+		for(auto i : state.world.in_ideology) {
+			add_owner(state, owners, pt.get_ideology(i), name + " ideology " + text::produce_simple_string(state, i.get_name()));
+		}
+		for(auto i : state.world.in_issue_option) {
+			add_owner(state, owners, pt.get_issues(i), name + " issue " + text::produce_simple_string(state, i.get_name()));
+		}
+		for(auto t : state.world.in_pop_type) {
+			add_owner(state, owners, pt.get_promotion(t), name + " promotion to " + text::produce_simple_string(state, t.get_name()));
+		}
+		add_owner(state, owners, pt.get_migration_target(), name + " migration_target");
+		add_owner(state, owners, pt.get_country_migration_target(), name + " country_migration_target");
+	}
+	for(auto r : state.world.in_rebel_type) {
+		auto name = "rebel type " + text::produce_simple_string(state, r.get_name());
+		add_owner(state, owners, r.get_will_rise(), name + " will_rise");
+		add_owner(state, owners, r.get_spawn_chance(), name + " spawn_chance");
+		add_owner(state, owners, r.get_movement_evaluation(), name + " movement_evaluation");
+		add_owner(owners, r.get_siege_won_trigger(), name + " siege_won_trigger");
+		add_owner(owners, r.get_demands_enforced_trigger(), name + " demands_enforced_trigger");
+	}
+	for(auto s : state.world.in_stored_trigger) {
+		add_owner(owners, s.get_function(), "scripted trigger " + text::produce_simple_string(state, s.get_name()));
+	}
+	return owners;
+}
+
+std::string to_csv(sys::state& state) {
+	auto owners = trigger_owners(state);
+	std::string out = "trigger,estimated total (ms),calls,samples,mean (us),used by\n";
+	for(auto& s : summarize()) {
+		out += std::to_string(s.key.index());
+		out += ",";
+		out += std::to_string(s.estimated_total_ms);
+		out += ",";
+		out += std::to_string(s.calls);
+		out += ",";
+		out += std::to_string(s.samples);
+		out += ",";
+		out += std::to_string(s.mean_us);
+		out += ",";
+		out += csv_field(owners[s.key.index()]);
+		out += "\n";
+	}
+	return out;
+}
+
+void write_csv(sys::state& state) {
+	auto csv = to_csv(state);
+	auto sdir = simple_fs::get_or_create_oos_directory();
+	simple_fs::write_file(sdir, NATIVE("trigger_profile.csv"), csv.data(), uint32_t(csv.size()));
+}
+
+} // namespace trigger_profile
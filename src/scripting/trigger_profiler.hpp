@@ -0,0 +1,60 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "dcon_generated.hpp"
+
+namespace sys {
+struct state;
+}
+
+// Opt-in profiling of trigger evaluation. While enabled, every evaluation of a trigger by key is counted, and one in every
+// sample_interval evaluations on each thread is timed; the total time of a trigger is estimated from its samples. Triggers are
+// attributed back to the events, decisions, modifiers, etc. that use them for the console listing and the csv export.
+namespace trigger_profile {
+
+inline constexpr uint32_t sample_interval = 16;
+inline constexpr size_t max_triggers = size_t(1) << 16; // trigger keys are 16 bits
+
+struct trigger_record {
+	std::atomic<uint64_t> calls = 0;
+	std::atomic<uint64_t> samples = 0;
+	std::atomic<uint64_t> sampled_nanoseconds = 0;
+};
+
+struct trigger_summary {
+	dcon::trigger_key key;
+	uint64_t calls = 0;
+	uint64_t samples = 0;
+	double estimated_total_ms = 0.0; // calls times the mean sampled time
+	double mean_us = 0.0;
+};
+
+void record_call(dcon::trigger_key key);
+bool should_sample();
+void record_sample(dcon::trigger_key key, int64_t nanoseconds);
+
+template<typename F>
+auto measure(dcon::trigger_key key, F const& f) {
+	record_call(key);
+	if(!should_sample())
+		return f();
+	auto start = std::chrono::steady_clock::now();
+	auto result = f();
+	auto end = std::chrono::steady_clock::now();
+	record_sample(key, std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+	return result;
+}
+
+// triggers that were never sampled are omitted; sorted from the largest to the smallest estimated total
+std::vector<trigger_summary> summarize();
+void reset();
+
+// what each trigger belongs to, indexed by key; shared triggers list all of their users
+std::vector<std::string> trigger_owners(sys::state& state);
+std::string to_csv(sys::state& state);
+void write_csv(sys::state& state); // writes trigger_profile.csv to the oos dump directory
+
+} // namespace trigger_profile
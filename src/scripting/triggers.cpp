@@ -1,3 +1,4 @@
+#include <bit>
 #include "triggers.hpp"
 #include "system_state.hpp"
 #include "demographics.hpp"
@@ -7,6 +8,8 @@
 #include "province_templates.hpp"
 #include "ve_scalar_extensions.hpp"
 #include "script_constants.hpp"
+#include "trigger_profiler.hpp"
+#include "trigger_compiler.hpp"
 
 namespace trigger {
 
@@ -170,6 +173,9 @@ using gathered_t = typename gathered_s<T>::type;
 template<typename return_type, typename primary_type, typename this_type, typename from_type>
 return_type CALLTYPE test_trigger_generic(uint16_t const* tval, sys::state& ws, primary_type primary_slot, this_type this_slot,
 		from_type from_slot);
+template<typename return_type, typename primary_type, typename this_type, typename from_type>
+return_type test_trigger_key(dcon::trigger_key key, sys::state& ws, primary_type primary_slot, this_type this_slot,
+		from_type from_slot);
 
 #define TRIGGER_FUNCTION(function_name)                                                                                          \
 	template<typename return_type, typename primary_type, typename this_type, typename from_type>                                  \
@@ -5768,7 +5774,7 @@ TRIGGER_FUNCTION(tf_invention_pop) {
 TRIGGER_FUNCTION(tf_test) {
 	auto sid = trigger::payload(tval[1]).str_id;
 	auto tid = ws.world.stored_trigger_get_function(sid);
-	auto test_result = test_trigger_generic<return_type>(ws.trigger_data.data() + ws.trigger_data_indices[tid.index() + 1], ws, primary_slot, this_slot, from_slot);
+	auto test_result = test_trigger_key<return_type>(tid, ws, primary_slot, this_slot, from_slot);
 	return compare_to_true(tval[0], test_result);
 }
 
@@ -5845,13 +5851,116 @@ struct trigger_container {
 	};
 };
 
+struct memo_key {
+	int32_t offset = 0; // of the scope within trigger_data
+	int32_t primary_slot = 0;
+	int32_t this_slot = 0;
+	int32_t from_slot = 0;
+
+	bool operator==(memo_key const&) const = default;
+};
+struct memo_key_hash {
+	using is_avalanching = void;
+
+	auto operator()(memo_key const& k) const noexcept -> uint64_t {
+		return ankerl::unordered_dense::detail::wyhash::hash(&k, sizeof(memo_key));
+	}
+};
+struct memo_results {
+	sys::state const* owner = nullptr;
+	uint32_t generation = 0;
+	ankerl::unordered_dense::map<memo_key, bool, memo_key_hash> results;
+};
+
+// each thread keeps its own results so that evaluating triggers in parallel needs no synchronization
+thread_local memo_results local_memo;
+// set while the current thread is executing an effect
+thread_local bool memo_suspended = false;
+
+bool memoized_scope(uint16_t const* tval, sys::state& ws, int32_t primary_slot, int32_t this_slot, int32_t from_slot) {
+	auto const generation = ws.trigger_memo_generation.load(std::memory_order::acquire);
+	if(local_memo.owner != &ws || local_memo.generation != generation) {
+		local_memo.results.clear();
+		local_memo.owner = &ws;
+		local_memo.generation = generation;
+	}
+	memo_key const key{ int32_t(tval - ws.trigger_data.data()), primary_slot, this_slot, from_slot };
+	if(auto it = local_memo.results.find(key); it != local_memo.results.end())
+		return it->second;
+
+	auto result = trigger_container<bool, int32_t, int32_t, int32_t>::trigger_functions[*tval & trigger::code_mask](tval, ws,
+			primary_slot, this_slot, from_slot);
+	if(local_memo.generation == generation) // members of the scope may have found the results discarded
+		local_memo.results.insert_or_assign(key, result);
+	return result;
+}
+
 template<typename return_type, typename primary_type, typename this_type, typename from_type>
 return_type CALLTYPE test_trigger_generic(uint16_t const* tval, sys::state& ws, primary_type primary_slot, this_type this_slot,
 		from_type from_slot) {
+	if(ws.trigger_memo_open && !memo_suspended && trigger::scope_iterates(uint16_t(*tval & trigger::code_mask)) && ws.trigger_data.data() <= tval &&
+			tval < ws.trigger_data.data() + ws.trigger_data.size()) {
+		return ve::apply(
+				[&ws, tval](int32_t p, int32_t t, int32_t f) { return memoized_scope(tval, ws, p, t, f); },
+				primary_slot, this_slot, from_slot);
+	}
 	return trigger_container<return_type, primary_type, this_type, from_type>::trigger_functions[*tval & trigger::code_mask](tval,
 			ws, primary_slot, this_slot, from_slot);
 }
 
+#ifdef ALICE_COMPILED_TRIGGERS
+
+#define COMPILED_TRIGGER(index) \
+	template<typename return_type, typename primary_type, typename this_type, typename from_type> \
+	return_type CALLTYPE compiled_trigger_##index(uint16_t const* d, sys::state& ws, primary_type primary_slot, this_type this_slot, \
+			from_type from_slot)
+#define COMPILED_TRIGGER_TABLE_BEGIN \
+	template<typename return_type, typename primary_type, typename this_type, typename from_type> \
+	struct compiled_container { \
+		constexpr static return_type(CALLTYPE* functions[])(uint16_t const*, sys::state&, primary_type, this_type, from_type) = {
+#define COMPILED_TRIGGER_ENTRY(index) compiled_trigger_##index<return_type, primary_type, this_type, from_type>,
+#define COMPILED_TRIGGER_TABLE_END \
+		}; \
+	};
+// the index is a constant, so these compile to direct calls
+#define CT_LEAF(code, offset) trigger_container<return_type, primary_type, this_type, from_type>::trigger_functions[code](d + (offset), \
+		ws, primary_slot, this_slot, from_slot)
+#define CT_SCOPE(offset) test_trigger_generic<return_type, primary_type, this_type, from_type>(d + (offset), ws, primary_slot, \
+		this_slot, from_slot)
+#define CT_ALL_TRUE(r) compare(ve::compress_mask(r), full_mask<decltype(ve::compress_mask(r))>::value)
+#define CT_ALL_FALSE(r) compare(ve::compress_mask(r), empty_mask<decltype(ve::compress_mask(r))>::value)
+
+#include ALICE_COMPILED_TRIGGERS
+
+#undef COMPILED_TRIGGER
+#undef COMPILED_TRIGGER_TABLE_BEGIN
+#undef COMPILED_TRIGGER_ENTRY
+#undef COMPILED_TRIGGER_TABLE_END
+#undef CT_LEAF
+#undef CT_SCOPE
+#undef CT_ALL_TRUE
+#undef CT_ALL_FALSE
+
+#endif
+
+template<typename return_type, typename primary_type, typename this_type, typename from_type>
+return_type test_trigger_key(dcon::trigger_key key, sys::state& ws, primary_type primary_slot, this_type this_slot,
+		from_type from_slot) {
+	auto test = [&]() {
+#ifdef ALICE_COMPILED_TRIGGERS
+		if(ws.compiled_triggers_active) {
+			return compiled_container<return_type, primary_type, this_type, from_type>::functions[key.index()](ws.trigger_data.data(), ws,
+					primary_slot, this_slot, from_slot);
+		}
+#endif
+		return test_trigger_generic<return_type>(ws.trigger_data.data() + ws.trigger_data_indices[key.index() + 1], ws, primary_slot,
+				this_slot, from_slot);
+	};
+	if(ws.cheat_data.trigger_profile)
+		return trigger_profile::measure(key, test);
+	return test();
+}
+
 #undef CALLTYPE
 #undef TRIGGER_FUNCTION
 
@@ -5862,8 +5971,7 @@ float evaluate_multiplicative_modifier(sys::state& state, dcon::value_modifier_k
 	for(uint32_t i = 0; i < base.segments_count && product != 0; ++i) {
 		auto seg = state.value_modifier_segments[base.first_segment_offset + i];
 		if(seg.condition) {
-			if(test_trigger_generic<bool>(state.trigger_data.data() + state.trigger_data_indices[seg.condition.index() + 1], state, primary,
-						 this_slot, from_slot)) {
+			if(test_trigger_key<bool>(seg.condition, state, primary, this_slot, from_slot)) {
 				product *= seg.factor;
 			}
 		}
@@ -5877,8 +5985,7 @@ float evaluate_additive_modifier(sys::state& state, dcon::value_modifier_key mod
 	for(uint32_t i = 0; i < base.segments_count; ++i) {
 		auto seg = state.value_modifier_segments[base.first_segment_offset + i];
 		if(seg.condition) {
-			if(test_trigger_generic<bool>(state.trigger_data.data() + state.trigger_data_indices[seg.condition.index() + 1], state, primary,
-						 this_slot, from_slot)) {
+			if(test_trigger_key<bool>(seg.condition, state, primary, this_slot, from_slot)) {
 				sum += seg.factor;
 			}
 		}
@@ -5886,67 +5993,132 @@ float evaluate_additive_modifier(sys::state& state, dcon::value_modifier_key mod
 	return sum * base.factor;
 }
 
-ve::fp_vector evaluate_multiplicative_modifier(sys::state& state, dcon::value_modifier_key modifier,
-		ve::contiguous_tags<int32_t> primary, ve::tagged_vector<int32_t> this_slot, int32_t from_slot) {
+// Tests the conditions of the segments of a value modifier for a vector of slots. Lanes outside of the active mask, as well
+// as lanes of a product that has already reached zero, are decided: once no undecided lane is left nothing more is tested, and
+// while only a few are left their conditions are tested one lane at a time. Segments that share a condition (identical
+// conditions share a key) test it only once. The values of lanes that are not active are unspecified.
+template<bool multiplicative, typename this_type>
+ve::fp_vector evaluate_vector_modifier(sys::state& state, dcon::value_modifier_key modifier, ve::contiguous_tags<int32_t> primary,
+		this_type this_slot, int32_t from_slot, ve::mask_vector active) {
+	constexpr uint32_t max_shared_conditions = 32;
+	constexpr int lanes_tested_individually = int(ve::vector_size / 4);
+
 	auto base = state.value_modifiers[modifier];
-	ve::fp_vector product = base.factor;
+	ve::fp_vector value = multiplicative ? ve::fp_vector{ base.factor } : ve::fp_vector{ base.base };
+	dcon::trigger_key tested_conditions[max_shared_conditions];
+	ve::mask_vector tested_results[max_shared_conditions];
+	uint32_t tested_count = 0;
+
 	for(uint32_t i = 0; i < base.segments_count; ++i) {
 		auto seg = state.value_modifier_segments[base.first_segment_offset + i];
-		if(seg.condition) {
-			auto res = test_trigger_generic<ve::mask_vector>(
-					state.trigger_data.data() + state.trigger_data_indices[seg.condition.index() + 1], state, primary, this_slot, from_slot);
-			product = ve::select(res, product * seg.factor, product);
+		if(!seg.condition)
+			continue;
+
+		ve::mask_vector undecided = active;
+		if constexpr(multiplicative) {
+			undecided = undecided && (value != 0.0f);
+		}
+		auto const undecided_lanes = uint32_t(ve::compress_mask(undecided).v);
+		if(undecided_lanes == 0)
+			break;
+
+		ve::mask_vector res;
+		uint32_t j = 0;
+		for(; j < tested_count; ++j) {
+			if(tested_conditions[j] == seg.condition)
+				break;
+		}
+		if(j < tested_count) {
+			res = tested_results[j];
+		} else {
+			if(std::popcount(undecided_lanes) <= lanes_tested_individually) {
+				res = ve::apply([&](int32_t p, int32_t t, bool u) {
+					return u && test_trigger_key<bool>(seg.condition, state, p, t, from_slot);
+				}, primary, this_slot, undecided);
+			} else {
+				res = test_trigger_key<ve::mask_vector>(seg.condition, state, primary, this_slot, from_slot);
+			}
+			// a lane that was skipped here stays decided for the rest of the segments, so the result can be reused as it is
+			if(tested_count < max_shared_conditions) {
+				tested_conditions[tested_count] = seg.condition;
+				tested_results[tested_count] = res;
+				++tested_count;
+			}
+		}
+		if constexpr(multiplicative) {
+			value = ve::select(res, value * seg.factor, value);
+		} else {
+			value = ve::select(res, value + seg.factor, value);
 		}
 	}
-	return product;
+	if constexpr(multiplicative) {
+		return value;
+	} else {
+		return value * base.factor;
+	}
+}
+
+ve::fp_vector evaluate_multiplicative_modifier(sys::state& state, dcon::value_modifier_key modifier,
+		ve::contiguous_tags<int32_t> primary, ve::tagged_vector<int32_t> this_slot, int32_t from_slot) {
+	return evaluate_vector_modifier<true>(state, modifier, primary, this_slot, from_slot, ve::mask_vector(true));
+}
+ve::fp_vector evaluate_multiplicative_modifier(sys::state& state, dcon::value_modifier_key modifier,
+		ve::contiguous_tags<int32_t> primary, ve::tagged_vector<int32_t> this_slot, int32_t from_slot, ve::mask_vector active) {
+	return evaluate_vector_modifier<true>(state, modifier, primary, this_slot, from_slot, active);
 }
 ve::fp_vector evaluate_additive_modifier(sys::state& state, dcon::value_modifier_key modifier,
 		ve::contiguous_tags<int32_t> primary, ve::tagged_vector<int32_t> this_slot, int32_t from_slot) {
-	auto base = state.value_modifiers[modifier];
-	ve::fp_vector sum = base.base;
-	for(uint32_t i = 0; i < base.segments_count; ++i) {
-		auto seg = state.value_modifier_segments[base.first_segment_offset + i];
-		if(seg.condition) {
-			auto res = test_trigger_generic<ve::mask_vector>(
-					state.trigger_data.data() + state.trigger_data_indices[seg.condition.index() + 1], state, primary, this_slot, from_slot);
-			sum = ve::select(res, sum + seg.factor, sum);
-		}
-	}
-	return sum * base.factor;
+	return evaluate_vector_modifier<false>(state, modifier, primary, this_slot, from_slot, ve::mask_vector(true));
+}
+ve::fp_vector evaluate_additive_modifier(sys::state& state, dcon::value_modifier_key modifier,
+		ve::contiguous_tags<int32_t> primary, ve::tagged_vector<int32_t> this_slot, int32_t from_slot, ve::mask_vector active) {
+	return evaluate_vector_modifier<false>(state, modifier, primary, this_slot, from_slot, active);
 }
 
 ve::fp_vector evaluate_multiplicative_modifier(sys::state& state, dcon::value_modifier_key modifier,
 		ve::contiguous_tags<int32_t> primary, ve::contiguous_tags<int32_t> this_slot, int32_t from_slot) {
-	auto base = state.value_modifiers[modifier];
-	ve::fp_vector product = base.factor;
-	for(uint32_t i = 0; i < base.segments_count; ++i) {
-		auto seg = state.value_modifier_segments[base.first_segment_offset + i];
-		if(seg.condition) {
-			auto res = test_trigger_generic<ve::mask_vector>(
-					state.trigger_data.data() + state.trigger_data_indices[seg.condition.index() + 1], state, primary, this_slot, from_slot);
-			product = ve::select(res, product * seg.factor, product);
-		}
-	}
-	return product;
+	return evaluate_vector_modifier<true>(state, modifier, primary, this_slot, from_slot, ve::mask_vector(true));
+}
+ve::fp_vector evaluate_multiplicative_modifier(sys::state& state, dcon::value_modifier_key modifier,
+		ve::contiguous_tags<int32_t> primary, ve::contiguous_tags<int32_t> this_slot, int32_t from_slot, ve::mask_vector active) {
+	return evaluate_vector_modifier<true>(state, modifier, primary, this_slot, from_slot, active);
 }
 ve::fp_vector evaluate_additive_modifier(sys::state& state, dcon::value_modifier_key modifier,
 		ve::contiguous_tags<int32_t> primary, ve::contiguous_tags<int32_t> this_slot, int32_t from_slot) {
-	auto base = state.value_modifiers[modifier];
-	ve::fp_vector sum = base.base;
-	for(uint32_t i = 0; i < base.segments_count; ++i) {
-		auto seg = state.value_modifier_segments[base.first_segment_offset + i];
-		if(seg.condition) {
-			auto res = test_trigger_generic<ve::mask_vector>(
-					state.trigger_data.data() + state.trigger_data_indices[seg.condition.index() + 1], state, primary, this_slot, from_slot);
-			sum = ve::select(res, sum + seg.factor, sum);
-		}
-	}
-	return sum * base.factor;
+	return evaluate_vector_modifier<false>(state, modifier, primary, this_slot, from_slot, ve::mask_vector(true));
+}
+ve::fp_vector evaluate_additive_modifier(sys::state& state, dcon::value_modifier_key modifier,
+		ve::contiguous_tags<int32_t> primary, ve::contiguous_tags<int32_t> this_slot, int32_t from_slot, ve::mask_vector active) {
+	return evaluate_vector_modifier<false>(state, modifier, primary, this_slot, from_slot, active);
+}
+
+template<bool multiplicative>
+void evaluate_modifier_range(sys::state& state, dcon::value_modifier_key modifier, dcon::trigger_key filter, uint32_t count,
+		std::vector<float>& out) {
+	out.resize(count);
+	ve::execute_serial_fast<int32_t>(count, [&](ve::contiguous_tags<int32_t> ids) {
+		ve::mask_vector active = filter ? test_trigger_key<ve::mask_vector>(filter, state, ids, ids, 0) : ve::mask_vector(true);
+		ve::fp_vector values = ve::compress_mask(active).v != 0
+			? evaluate_vector_modifier<multiplicative>(state, modifier, ids, ids, 0, active)
+			: ve::fp_vector{ 0.0f };
+		ve::apply([&](int32_t id, float v, bool a) {
+			if(uint32_t(id) < count)
+				out[id] = a ? v : 0.0f;
+		}, ids, values, active);
+	});
+}
+
+void evaluate_multiplicative_modifier(sys::state& state, dcon::value_modifier_key modifier, dcon::trigger_key filter, uint32_t count,
+		std::vector<float>& out) {
+	evaluate_modifier_range<true>(state, modifier, filter, count, out);
+}
+void evaluate_additive_modifier(sys::state& state, dcon::value_modifier_key modifier, dcon::trigger_key filter, uint32_t count,
+		std::vector<float>& out) {
+	evaluate_modifier_range<false>(state, modifier, filter, count, out);
 }
 
 bool evaluate(sys::state& state, dcon::trigger_key key, int32_t primary, int32_t this_slot, int32_t from_slot) {
-	return test_trigger_generic<bool>(state.trigger_data.data() + state.trigger_data_indices[key.index() + 1], state, primary,
-			this_slot, from_slot);
+	return test_trigger_key<bool>(key, state, primary, this_slot, from_slot);
 }
 bool evaluate(sys::state& state, uint16_t const* data, int32_t primary, int32_t this_slot, int32_t from_slot) {
 	return test_trigger_generic<bool>(data, state, primary, this_slot, from_slot);
@@ -5954,8 +6126,7 @@ bool evaluate(sys::state& state, uint16_t const* data, int32_t primary, int32_t
 
 ve::mask_vector evaluate(sys::state& state, dcon::trigger_key key, ve::contiguous_tags<int32_t> primary,
 		ve::tagged_vector<int32_t> this_slot, int32_t from_slot) {
-	return test_trigger_generic<ve::mask_vector>(state.trigger_data.data() + state.trigger_data_indices[key.index() + 1], state,
-			primary, this_slot, from_slot);
+	return test_trigger_key<ve::mask_vector>(key, state, primary, this_slot, from_slot);
 }
 ve::mask_vector evaluate(sys::state& state, uint16_t const* data, ve::contiguous_tags<int32_t> primary,
 		ve::tagged_vector<int32_t> this_slot, int32_t from_slot) {
@@ -5964,8 +6135,7 @@ ve::mask_vector evaluate(sys::state& state, uint16_t const* data, ve::contiguous
 
 ve::mask_vector evaluate(sys::state& state, dcon::trigger_key key, ve::tagged_vector<int32_t> primary,
 		ve::tagged_vector<int32_t> this_slot, int32_t from_slot) {
-	return test_trigger_generic<ve::mask_vector>(state.trigger_data.data() + state.trigger_data_indices[key.index() + 1], state,
-			primary, this_slot, from_slot);
+	return test_trigger_key<ve::mask_vector>(key, state, primary, this_slot, from_slot);
 }
 ve::mask_vector evaluate(sys::state& state, uint16_t const* data, ve::tagged_vector<int32_t> primary,
 		ve::tagged_vector<int32_t> this_slot, int32_t from_slot) {
@@ -5974,12 +6144,128 @@ ve::mask_vector evaluate(sys::state& state, uint16_t const* data, ve::tagged_vec
 
 ve::mask_vector evaluate(sys::state& state, dcon::trigger_key key, ve::contiguous_tags<int32_t> primary,
 		ve::contiguous_tags<int32_t> this_slot, int32_t from_slot) {
-	return test_trigger_generic<ve::mask_vector>(state.trigger_data.data() + state.trigger_data_indices[key.index() + 1], state,
-			primary, this_slot, from_slot);
+	return test_trigger_key<ve::mask_vector>(key, state, primary, this_slot, from_slot);
 }
 ve::mask_vector evaluate(sys::state& state, uint16_t const* data, ve::contiguous_tags<int32_t> primary,
 		ve::contiguous_tags<int32_t> this_slot, int32_t from_slot) {
 	return test_trigger_generic<ve::mask_vector>(data, state, primary, this_slot, from_slot);
 }
 
+memoization_window::memoization_window(sys::state& s) : state(s), was_open(s.trigger_memo_open) {
+	if(!was_open && state.cheat_data.trigger_memoization) {
+		discard_memoized_results(state);
+		state.trigger_memo_open = true;
+	}
+}
+memoization_window::~memoization_window() {
+	if(!was_open && state.trigger_memo_open) {
+		state.trigger_memo_open = false;
+		discard_memoized_results(state);
+	}
+}
+
+void discard_memoized_results(sys::state& state) {
+	state.trigger_memo_generation.fetch_add(1, std::memory_order::acq_rel);
+}
+
+memoization_suspension::memoization_suspension() : was_suspended(memo_suspended) {
+	memo_suspended = true;
+}
+memoization_suspension::~memoization_suspension() {
+	memo_suspended = was_suspended;
+}
+
+namespace {
+
+bool is_local_leaf(uint16_t code) {
+	switch(code) {
+	// the date and values that only the daily update changes
+	case trigger::year:
+	case trigger::month:
+	case trigger::always:
+	case trigger::has_global_flag:
+	case trigger::great_wars_enabled:
+	case trigger::world_wars_enabled:
+	case trigger::crisis_exist:
+	case trigger::rank:
+	case trigger::exists_tag:
+	case trigger::owns:
+	// the nation in the primary slot
+	case trigger::tag_tag:
+	case trigger::exists_bool:
+	case trigger::ai:
+	case trigger::capital:
+	case trigger::technology:
+	case trigger::tech_school:
+	case trigger::government_nation:
+	case trigger::ruling_party_ideology_nation:
+	case trigger::has_country_flag:
+	case trigger::has_country_modifier:
+	case trigger::civilized_nation:
+	case trigger::is_greater_power_nation:
+	case trigger::is_secondary_power_nation:
+	case trigger::is_vassal:
+	case trigger::is_substate:
+	case trigger::is_mobilised:
+	case trigger::has_recently_lost_war:
+	case trigger::war_nation:
+	case trigger::num_of_cities_int:
+	case trigger::number_of_states:
+	case trigger::prestige_value:
+	case trigger::badboy:
+	case trigger::money:
+	case trigger::plurality:
+	case trigger::war_exhaustion_nation:
+	case trigger::total_pops_nation:
+	case trigger::average_militancy_nation:
+	case trigger::average_consciousness_nation:
+	case trigger::militancy_nation:
+	case trigger::consciousness_nation:
+	case trigger::literacy_nation:
+	case trigger::upper_house:
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool is_local_to_primary_nation(uint16_t const* data) {
+	auto const code = uint16_t(data[0] & trigger::code_mask);
+	if(code < trigger::first_scope_code)
+		return is_local_leaf(code);
+	if(code != trigger::generic_scope)
+		return false;
+	auto const end = data + 1 + get_trigger_scope_payload_size(data);
+	for(auto sub = data + 2; sub < end; sub += 1 + get_trigger_payload_size(sub)) {
+		if(!is_local_to_primary_nation(sub))
+			return false;
+	}
+	return true;
+}
+
+} // namespace
+
+bool is_local_to_primary_nation(sys::state& state, dcon::trigger_key key) {
+	return !key || is_local_to_primary_nation(state.trigger_data.data() + state.trigger_data_indices[key.index() + 1]);
+}
+bool is_local_to_primary_nation(sys::state& state, dcon::value_modifier_key modifier) {
+	if(!modifier)
+		return true;
+	auto const& base = state.value_modifiers[modifier];
+	for(uint32_t i = 0; i < base.segments_count; ++i) {
+		if(!is_local_to_primary_nation(state, state.value_modifier_segments[base.first_segment_offset + i].condition))
+			return false;
+	}
+	return true;
+}
+
+void enable_compiled_triggers(sys::state& state) {
+#ifdef ALICE_COMPILED_TRIGGERS
+	state.compiled_triggers_active = int32_t(state.trigger_data_indices.size()) == compiled_triggers_count + 1
+		&& bytecode_checksum(state) == compiled_triggers_checksum;
+#else
+	state.compiled_triggers_active = false;
+#endif
+}
+
 } // namespace trigger
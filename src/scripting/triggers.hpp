@@ -173,6 +173,18 @@ ve::fp_vector evaluate_additive_modifier(sys::state& state, dcon::value_modifier
 float evaluate_additive_modifier(sys::state& state, dcon::value_modifier_key modifier, int32_t primary, int32_t this_slot, int32_t from_slot);
 ve::fp_vector evaluate_additive_modifier(sys::state& state, dcon::value_modifier_key modifier, ve::contiguous_tags<int32_t> primary, ve::contiguous_tags<int32_t> this_slot, int32_t from_slot);
 
+// as above, but only the lanes in active are needed: the values of the others are unspecified, and their conditions are not
+// tested when that can be avoided
+ve::fp_vector evaluate_multiplicative_modifier(sys::state& state, dcon::value_modifier_key modifier, ve::contiguous_tags<int32_t> primary, ve::tagged_vector<int32_t> this_slot, int32_t from_slot, ve::mask_vector active);
+ve::fp_vector evaluate_multiplicative_modifier(sys::state& state, dcon::value_modifier_key modifier, ve::contiguous_tags<int32_t> primary, ve::contiguous_tags<int32_t> this_slot, int32_t from_slot, ve::mask_vector active);
+ve::fp_vector evaluate_additive_modifier(sys::state& state, dcon::value_modifier_key modifier, ve::contiguous_tags<int32_t> primary, ve::tagged_vector<int32_t> this_slot, int32_t from_slot, ve::mask_vector active);
+ve::fp_vector evaluate_additive_modifier(sys::state& state, dcon::value_modifier_key modifier, ve::contiguous_tags<int32_t> primary, ve::contiguous_tags<int32_t> this_slot, int32_t from_slot, ve::mask_vector active);
+
+// evaluates the modifier for every id in [0, count) (of nations, provinces, etc.), with the id in both the primary and this
+// slots; ids for which the filter trigger (if any) does not hold are skipped and get a value of zero
+void evaluate_multiplicative_modifier(sys::state& state, dcon::value_modifier_key modifier, dcon::trigger_key filter, uint32_t count, std::vector<float>& out);
+void evaluate_additive_modifier(sys::state& state, dcon::value_modifier_key modifier, dcon::trigger_key filter, uint32_t count, std::vector<float>& out);
+
 ve::fp_vector evaluate_purely_additive_modifier(sys::state& state, dcon::value_modifier_key modifier, ve::contiguous_tags<int32_t> primary, ve::tagged_vector<int32_t> this_slot, int32_t from_slot);
 float evaluate_purely_additive_modifier(sys::state& state, dcon::value_modifier_key modifier, int32_t primary, int32_t this_slot, int32_t from_slot);
 ve::fp_vector evaluate_purely_additive_modifier(sys::state& state, dcon::value_modifier_key modifier, ve::contiguous_tags<int32_t> primary, ve::contiguous_tags<int32_t> this_slot, int32_t from_slot);
@@ -192,4 +204,40 @@ ve::mask_vector evaluate(sys::state& state, dcon::trigger_key key, ve::contiguou
 		ve::contiguous_tags<int32_t> this_slot, int32_t from_slot);
 ve::mask_vector evaluate(sys::state& state, uint16_t const* data, ve::contiguous_tags<int32_t> primary,
 		ve::contiguous_tags<int32_t> this_slot, int32_t from_slot);
+
+// While a window is open (and the trigger_memoization cheat toggle is on), the result of each scope that iterates over a set
+// of objects is remembered for the slots it was evaluated with, and reused when the same part of the same trigger is
+// evaluated again. Whoever opens a window must ensure that nothing triggers can see changes while it is open, other than by
+// executing effects or commands, both of which discard the remembered results.
+class memoization_window {
+	sys::state& state;
+	bool was_open = false;
+public:
+	memoization_window(sys::state& s);
+	memoization_window(memoization_window const&) = delete;
+	memoization_window& operator=(memoization_window const&) = delete;
+	~memoization_window();
+};
+void discard_memoized_results(sys::state& state);
+// Effects change the state as they go, so a limit tested partway through one could be answered with a result remembered from
+// before an earlier part of the same effect ran. While one of these exists, nothing evaluated on the current thread is memoized.
+// It is per thread so that effects executing concurrently (see effect::is_local_to_primary_nation) do not disturb one another.
+class memoization_suspension {
+	bool was_suspended = false;
+public:
+	memoization_suspension();
+	memoization_suspension(memoization_suspension const&) = delete;
+	memoization_suspension& operator=(memoization_suspension const&) = delete;
+	~memoization_suspension();
+};
+
+// whether the trigger (or every condition of the value modifier), evaluated with a nation in its primary and this slots, reads
+// only the data of that nation and values that no effect::is_local_to_primary_nation effect can change; anything that is not
+// known to be local, including every scope, is treated as not local
+bool is_local_to_primary_nation(sys::state& state, dcon::trigger_key key);
+bool is_local_to_primary_nation(sys::state& state, dcon::value_modifier_key modifier);
+
+// uses the triggers built in with ALICE_COMPILED_TRIGGERS (see trigger_compiler.hpp) if they were compiled from this scenario
+void enable_compiled_triggers(sys::state& state);
+
 } // namespace trigger
@@ -1,6 +1,7 @@
 extern "C" {
 #define XXH_NAMESPACE ZSTD_
 #define ZSTD_DISABLE_ASM
+#define ZSTD_MULTITHREAD 1
 
 #include "zstd/common/xxhash.c"
 #include "zstd/decompress/zstd_decompress_block.c"
@@ -9,6 +10,8 @@ extern "C" {
 #include "zstd/compress/fse_compress.c"
 #include "zstd/decompress/huf_decompress.c"
 #include "zstd/common/zstd_common.c"
+#include "zstd/common/pool.c"
+#include "zstd/common/threading.c"
 #include "zstd/common/entropy_common.c"
 #include "zstd/common/fse_decompress.c"
 #include "zstd/compress/hist.c"
@@ -23,4 +26,5 @@ extern "C" {
 #include "zstd/common/error_private.c"
 #include "zstd/decompress/zstd_decompress.c"
 #include "zstd/compress/zstd_compress.c"
+#include "zstd/compress/zstdmt_compress.c"
 };
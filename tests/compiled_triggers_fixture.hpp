@@ -0,0 +1,51 @@
+// Generated by trigger::compile_to_cpp, see trigger_compiler.hpp. Do not edit.
+inline constexpr uint64_t compiled_triggers_checksum = 0xBAAFC10253137E04ull;
+inline constexpr int32_t compiled_triggers_count = 4;
+
+COMPILED_TRIGGER(0) {
+	return [&]() -> return_type {
+		auto r = return_type(true);
+		r = r & CT_LEAF(0x0145, 3);
+		if(CT_ALL_FALSE(r)) return r;
+		r = r & CT_LEAF(0x0091, 4);
+		if(CT_ALL_FALSE(r)) return r;
+		return r;
+	}();
+}
+COMPILED_TRIGGER(1) {
+	return [&]() -> return_type {
+		auto r = return_type(false);
+		r = r | CT_LEAF(0x0149, 9);
+		if(CT_ALL_TRUE(r)) return r;
+		r = r | [&]() -> return_type {
+			auto r = return_type(true);
+			r = r & CT_LEAF(0x0145, 12);
+			if(CT_ALL_FALSE(r)) return r;
+			r = r & CT_LEAF(0x0108, 13);
+			if(CT_ALL_FALSE(r)) return r;
+			return r;
+		}();
+		if(CT_ALL_TRUE(r)) return r;
+		return r;
+	}();
+}
+COMPILED_TRIGGER(2) {
+	return [&]() -> return_type {
+		auto r = return_type(true);
+		r = r & CT_SCOPE(18);
+		if(CT_ALL_FALSE(r)) return r;
+		r = r & CT_LEAF(0x0145, 23);
+		if(CT_ALL_FALSE(r)) return r;
+		return r;
+	}();
+}
+COMPILED_TRIGGER(3) {
+	return CT_LEAF(0x0149, 24);
+}
+
+COMPILED_TRIGGER_TABLE_BEGIN
+	COMPILED_TRIGGER_ENTRY(0)
+	COMPILED_TRIGGER_ENTRY(1)
+	COMPILED_TRIGGER_ENTRY(2)
+	COMPILED_TRIGGER_ENTRY(3)
+COMPILED_TRIGGER_TABLE_END
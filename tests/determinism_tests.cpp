@@ -7,6 +7,11 @@
 #include "system_state.hpp"
 #include "serialization.hpp"
 #include "prng.hpp"
+#ifdef PREFER_ONE_TBB
+#include <oneapi/tbb/global_control.h>
+#else
+#include <concrt.h>
+#endif
 
 TEST_CASE("prng_simple", "[determinism]") {
 	std::unique_ptr<sys::state> game_state = std::make_unique<sys::state>(); // too big for the stack
@@ -26,6 +31,19 @@ TEST_CASE("prng_low_entropy", "[determinism]") {
 	REQUIRE(r1 == r2);
 }
 
+TEST_CASE("prng_lanes", "[determinism]") {
+	std::unique_ptr<sys::state> game_state = std::make_unique<sys::state>(); // too big for the stack
+	game_state->game_seed = 64273;
+	game_state->current_date.value = 49963;
+	uint32_t values[37];
+	uint32_t lanes[37];
+	for(uint32_t i = 0; i < 37; ++i)
+		values[i] = (i * 2654435761u) ^ 0x6a3f;
+	rng::get_random_lanes(*game_state, values, lanes, 37);
+	for(uint32_t i = 0; i < 37; ++i)
+		REQUIRE(lanes[i] == uint32_t(rng::get_random(*game_state, values[i])));
+}
+
 #define UNOPTIMIZABLE_FLOAT(name, value) \
 	char name##_storage[sizeof(float)]; \
 	new (&name##_storage) float(value); \
@@ -713,3 +731,302 @@ TEST_CASE("sim_year", "[determinism]") {
 		checked_single_tick(*game_state_1, *game_state_2);
 	}
 }
+
+TEST_CASE("sim_parallel_effects", "[determinism]") {
+	// Test that firing the events local to their nations concurrently gives the same game state as firing them in order
+	std::unique_ptr<sys::state> game_state_1 = load_testing_scenario_file();
+	std::unique_ptr<sys::state> game_state_2 = load_testing_scenario_file();
+	game_state_2->game_seed = game_state_1->game_seed = 808080;
+	game_state_2->cheat_data.parallel_effects = true;
+
+	// a pulse is only fired concurrently if all of its events are local, so the local ones are also fired as a pulse of their own
+	auto& nd = game_state_2->national_definitions;
+	std::vector<nations::fixed_event> local_events;
+	for(auto* pulse : { &nd.on_quarterly_pulse, &nd.on_yearly_pulse }) {
+		for(auto& fe : *pulse) {
+			if(trigger::is_local_to_primary_nation(*game_state_2, fe.condition) && event::is_local_to_nation(*game_state_2, fe.id))
+				local_events.push_back(fe);
+		}
+	}
+	REQUIRE(!local_events.empty());
+
+	event::fire_pulse(*game_state_1, local_events);
+	event::fire_pulse(*game_state_2, local_events);
+	compare_game_states(*game_state_1, *game_state_2);
+	event::fire_pulse(*game_state_1, game_state_1->national_definitions.on_quarterly_pulse);
+	event::fire_pulse(*game_state_2, game_state_2->national_definitions.on_quarterly_pulse);
+	compare_game_states(*game_state_1, *game_state_2);
+	event::fire_pulse(*game_state_1, game_state_1->national_definitions.on_yearly_pulse);
+	event::fire_pulse(*game_state_2, game_state_2->national_definitions.on_yearly_pulse);
+	compare_game_states(*game_state_1, *game_state_2);
+
+	for(int i = 0; i < 31; i++) {
+		checked_single_tick(*game_state_1, *game_state_2);
+	}
+}
+
+TEST_CASE("save_checksum_reuse", "[determinism]") {
+	// Test that reusing the digests of unchanged data gives the same checksum as hashing everything again
+	std::unique_ptr<sys::state> game_state = load_testing_scenario_file();
+	auto first = game_state->get_save_checksum();
+	auto second = game_state->get_save_checksum();
+	REQUIRE(first.is_equal(second));
+
+	auto n = dcon::nation_id{ 0 };
+	auto prestige = game_state->world.nation_get_prestige(n);
+	game_state->world.nation_set_prestige(n, prestige + 1.0f);
+	auto changed = game_state->get_save_checksum();
+	REQUIRE(!first.is_equal(changed));
+
+	game_state->world.nation_set_prestige(n, prestige);
+	auto restored = game_state->get_save_checksum();
+	REQUIRE(first.is_equal(restored));
+}
+
+TEST_CASE("demographics_single_pass", "[determinism]") {
+	// Test that summing every key in one sweep over the pops gives the same totals as summing each key on its own
+	std::unique_ptr<sys::state> game_state = load_testing_scenario_file();
+	auto& state = *game_state;
+	demographics::regenerate_from_pop_data_full(state);
+
+	auto first_culture = dcon::culture_id{ 0 };
+	auto ideology = dcon::ideology_id{ 0 };
+	dcon::demographics_key keys[] = { demographics::total, demographics::employed, demographics::poor_total,
+		demographics::to_key(state, first_culture), demographics::to_key(state, ideology) };
+	auto pop_value = [&](dcon::pop_id p, dcon::demographics_key k) {
+		if(k == demographics::total)
+			return state.world.pop_get_size(p);
+		if(k == demographics::employed)
+			return state.world.pop_get_employment(p);
+		if(k == demographics::poor_total)
+			return state.world.pop_type_get_strata(state.world.pop_get_poptype(p)) == uint8_t(culture::pop_strata::poor) ? state.world.pop_get_size(p) : 0.0f;
+		if(k == demographics::to_key(state, first_culture))
+			return state.world.pop_get_culture(p) == first_culture ? state.world.pop_get_size(p) : 0.0f;
+		return state.world.pop_get_demographics(p, pop_demographics::to_key(state, ideology)) * state.world.pop_get_size(p);
+	};
+
+	for(auto k : keys) {
+		std::vector<float> by_state(state.world.state_instance_size(), 0.0f);
+		std::vector<float> by_nation(state.world.nation_size(), 0.0f);
+		province::for_each_land_province(state, [&](dcon::province_id p) {
+			float sum = 0.0f;
+			for(auto pl : state.world.province_get_pop_location(p))
+				sum += pop_value(pl.get_pop(), k);
+			REQUIRE(state.world.province_get_demographics(p, k) == Approx(sum));
+			if(auto s = state.world.province_get_state_membership(p); s) {
+				by_state[s.index()] += sum;
+				if(auto n = state.world.state_instance_get_nation_from_state_ownership(s); n)
+					by_nation[n.index()] += sum;
+			}
+		});
+		for(auto s : state.world.in_state_instance)
+			REQUIRE(state.world.state_instance_get_demographics(s, k) == Approx(by_state[s.id.index()]).epsilon(0.001));
+		for(auto n : state.world.in_nation)
+			REQUIRE(state.world.nation_get_demographics(n, k) == Approx(by_nation[n.id.index()]).epsilon(0.001));
+	}
+}
+
+TEST_CASE("pop_sorting", "[determinism]") {
+	// Test that renumbering the pops by location keeps every pop, with its properties and the things that refer to it
+	std::unique_ptr<sys::state> game_state = load_testing_scenario_file();
+	auto& state = *game_state;
+
+	// remember each regiment's pop by what it is, since its id is about to change
+	std::vector<std::pair<dcon::province_id, float>> backers(state.world.regiment_size());
+	for(auto r : state.world.in_regiment) {
+		if(auto p = r.get_pop_from_regiment_source(); p)
+			backers[r.id.index()] = std::make_pair(p.get_province_from_pop_location().id, p.get_size());
+	}
+	std::vector<float> sizes(state.world.province_size(), 0.0f);
+	for(auto p : state.world.in_pop)
+		sizes[p.get_province_from_pop_location().id.index()] += p.get_size();
+	auto const count = state.world.pop_size();
+
+	// queue events on the last pop, which is the least likely to keep its id
+	dcon::pop_id queued{ dcon::pop_id::value_base_t(count - 1) };
+	auto queued_location = state.world.pop_get_province_from_pop_location(queued);
+	auto queued_size = state.world.pop_get_size(queued);
+	auto queued_owner = state.world.province_get_nation_from_province_ownership(queued_location);
+	state.future_n_event.push_back(event::pending_human_n_event{ 1, 0, trigger::to_generic(queued_owner), trigger::to_generic(queued),
+			state.current_date, dcon::national_event_id{ 0 }, queued_owner, event::slot_type::nation, event::slot_type::pop });
+	state.future_p_event.push_back(event::pending_human_p_event{ 1, 0, trigger::to_generic(queued), state.current_date,
+			dcon::provincial_event_id{ 0 }, queued_location, event::slot_type::pop });
+
+	demographics::sort_pops_by_location(state);
+
+	REQUIRE(state.world.pop_size() == count);
+	for(auto from_slot : { state.future_n_event.back().from_slot, state.future_p_event.back().from_slot }) {
+		auto p = trigger::to_pop(from_slot);
+		REQUIRE(state.world.pop_get_province_from_pop_location(p) == queued_location);
+		REQUIRE(state.world.pop_get_size(p) == queued_size);
+	}
+	REQUIRE(state.future_n_event.back().primary_slot == trigger::to_generic(queued_owner));
+	state.future_n_event.pop_back();
+	state.future_p_event.pop_back();
+	for(uint32_t i = 1; i < count; ++i) {
+		dcon::pop_id a{ dcon::pop_id::value_base_t(i - 1) };
+		dcon::pop_id b{ dcon::pop_id::value_base_t(i) };
+		auto la = state.world.pop_get_province_from_pop_location(a);
+		auto lb = state.world.pop_get_province_from_pop_location(b);
+		REQUIRE(la.index() <= lb.index());
+		if(la == lb)
+			REQUIRE(state.world.pop_get_poptype(a).index() <= state.world.pop_get_poptype(b).index());
+	}
+	std::vector<float> sorted_sizes(state.world.province_size(), 0.0f);
+	for(auto p : state.world.in_province) {
+		dcon::pop_id last;
+		for(auto pl : p.get_pop_location()) {
+			REQUIRE(pl.get_pop().id.index() > last.index());
+			last = pl.get_pop().id;
+			sorted_sizes[p.id.index()] += pl.get_pop().get_size();
+		}
+	}
+	for(size_t i = 0; i < sizes.size(); ++i)
+		REQUIRE(sorted_sizes[i] == Approx(sizes[i]));
+	for(auto r : state.world.in_regiment) {
+		if(auto p = r.get_pop_from_regiment_source(); p) {
+			REQUIRE(p.get_province_from_pop_location().id == backers[r.id.index()].first);
+			REQUIRE(p.get_size() == backers[r.id.index()].second);
+		}
+	}
+
+	// already in order, so a second pass changes nothing
+	auto before = state.get_save_checksum();
+	demographics::sort_pops_by_location(state);
+	REQUIRE(before.is_equal(state.get_save_checksum()));
+}
+
+TEST_CASE("pop_type_modifiers", "[determinism]") {
+	// Test that evaluating the ideology attraction of a block once per pop type matches evaluating it pop by pop
+	std::unique_ptr<sys::state> game_state = load_testing_scenario_file();
+	auto& state = *game_state;
+	demographics::sort_pops_by_location(state);
+
+	demographics::ideology_buffer ibuf(state);
+	demographics::update_ideologies(state, 0, 32, ibuf);
+
+	for(uint32_t j = 0; j < std::min(state.world.pop_size(), uint32_t(16)); ++j) {
+		dcon::pop_id p{ dcon::pop_id::value_base_t(j) };
+		auto civilized = state.world.nation_get_is_civilized(nations::owner_of_pop(state, p));
+		for(auto i : state.world.in_ideology) {
+			if(!i.get_enabled() || (i.get_is_civilized_only() && !civilized))
+				continue;
+			auto modifier = state.world.pop_type_get_ideology(state.world.pop_get_poptype(p), i);
+			auto expected = modifier ? trigger::evaluate_multiplicative_modifier(state, modifier, trigger::to_generic(p), trigger::to_generic(p), 0) : 0.0f;
+			REQUIRE(ibuf.temp_buffers[i].get(p) == Approx(expected));
+		}
+	}
+}
+
+TEST_CASE("market_totals", "[determinism]") {
+	// Test that the vector sums over the nations match summing nation by nation, and that prices move toward clearing the market
+	std::unique_ptr<sys::state> game_state = load_testing_scenario_file();
+	auto& state = *game_state;
+
+	// a fresh scenario has no demand yet, so every nation is given some; and enough nations are added that the last vector of
+	// nations is only partly filled, so that the lanes past the end are summed too
+	while(state.world.nation_size() % ve::vector_size == 0)
+		state.world.create_nation();
+	for(auto n : state.world.in_nation) {
+		for(auto c : state.world.in_commodity) {
+			auto seed = float(n.id.index() * 7 + c.index() * 3 + 1);
+			n.set_real_demand(c, seed * 1.25f);
+			n.set_demand_satisfaction(c, float((n.id.index() + c.index()) % 5) / 4.0f);
+			n.set_domestic_market_pool(c, seed * 0.75f);
+		}
+	}
+
+	std::vector<dcon::commodity_id> commodities;
+	for(auto c : state.world.in_commodity)
+		commodities.push_back(c);
+	std::vector<economy::market_totals> totals(commodities.size());
+	economy::sum_market_totals(state, commodities.data(), uint32_t(commodities.size()), totals.data());
+
+	for(size_t i = 0; i < commodities.size(); ++i) {
+		auto c = commodities[i];
+		float real_demand = 0.0f;
+		float consumption = 0.0f;
+		float production = 0.0f;
+		for(auto n : state.world.in_nation) {
+			real_demand += n.get_real_demand(c);
+			consumption += n.get_real_demand(c) * n.get_demand_satisfaction(c);
+			production += n.get_domestic_market_pool(c);
+		}
+		REQUIRE(real_demand > 0.0f);
+		REQUIRE(totals[i].real_demand == Approx(real_demand));
+		REQUIRE(totals[i].consumption == Approx(consumption));
+		REQUIRE(totals[i].production == Approx(production));
+	}
+
+	REQUIRE(economy::adjusted_price(2.0f, 100.0f, 100.0f) == Approx(2.0f));
+	REQUIRE(economy::adjusted_price(2.0f, 100.0f, 200.0f) > 2.0f);
+	REQUIRE(economy::adjusted_price(2.0f, 200.0f, 100.0f) < 2.0f);
+	REQUIRE(economy::adjusted_price(0.001f, 1000.0f, 0.0f) == 0.001f);
+}
+
+// runs function with the concurrency:: algorithms limited to a single thread
+template<typename F>
+void with_single_thread(F const& function) {
+#ifdef PREFER_ONE_TBB
+	tbb::global_control limit(tbb::global_control::max_allowed_parallelism, 1);
+	function();
+#else
+	Concurrency::CurrentScheduler::Create(Concurrency::SchedulerPolicy(2, Concurrency::MinConcurrency, 1, Concurrency::MaxConcurrency, 1));
+	function();
+	Concurrency::CurrentScheduler::Detach();
+#endif
+}
+
+TEST_CASE("economy_thread_counts", "[determinism]") {
+	// Test that the economy gives the same result on one thread as on all of them, as the nations consume concurrently
+	std::unique_ptr<sys::state> game_state_1 = load_testing_scenario_file();
+	std::unique_ptr<sys::state> game_state_2 = load_testing_scenario_file();
+	game_state_2->game_seed = game_state_1->game_seed = 808080;
+
+	for(int i = 0; i < 7; i++) {
+		with_single_thread([&]() { economy::daily_update(*game_state_1, true); });
+		economy::daily_update(*game_state_2, true);
+		compare_game_states(*game_state_1, *game_state_2);
+		REQUIRE(game_state_1->get_save_checksum().is_equal(game_state_2->get_save_checksum()));
+	}
+}
+
+TEST_CASE("economy_effective_prices", "[determinism]") {
+	// Test that every nation's effective prices come from the pools as they stand before any nation buys from them
+	std::unique_ptr<sys::state> game_state_1 = load_testing_scenario_file();
+	std::unique_ptr<sys::state> game_state_2 = load_testing_scenario_file();
+	game_state_2->game_seed = game_state_1->game_seed = 808080;
+	for(int i = 0; i < 3; i++) {
+		checked_single_tick(*game_state_1, *game_state_2);
+	}
+	auto& updated = *game_state_1;
+	auto& expected = *game_state_2;
+
+	economy::daily_update(updated, true);
+
+	// the part of the update that moves goods between the pools before the nations consume
+	for(auto n : expected.nations_by_rank) {
+		if(!n)
+			break;
+		economy::absorb_sphere_member_production(expected, n);
+	}
+	for(auto n : expected.nations_by_rank) {
+		if(!n)
+			break;
+		economy::give_sphere_leader_production(expected, n);
+	}
+
+	int32_t above_base_price = 0;
+	for(auto n : expected.nations_by_rank) {
+		if(!n)
+			break;
+		economy::populate_effective_prices(expected, n);
+		for(auto c : expected.world.in_commodity) {
+			REQUIRE(updated.world.nation_get_effective_prices(n, c) == expected.world.nation_get_effective_prices(n, c));
+			if(expected.world.nation_get_effective_prices(n, c) > expected.world.commodity_get_current_price(c))
+				++above_base_price;
+		}
+	}
+	// some nations must have wanted more than their domestic pools held, or the pools would not have mattered
+	REQUIRE(above_base_price > 0);
+}
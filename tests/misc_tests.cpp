@@ -225,3 +225,205 @@ TEST_CASE("cyto payload tests", "[misc_tests]") {
 		REQUIRE(any_cast<void *>(vp_payload) == (void *)nullptr);
 	}
 }
+
+TEST_CASE("tick profiler tests", "[misc_tests]") {
+	auto id = tick_profile::phase_id("tick profiler test phase");
+	REQUIRE(id >= 0);
+	REQUIRE(tick_profile::phase_id("tick profiler test phase") == id);
+
+	for(uint32_t i = 100; i >= 1; --i) {
+		tick_profile::record_sample(id, i);
+	}
+	auto summaries = tick_profile::summarize();
+	auto it = std::find_if(summaries.begin(), summaries.end(), [](auto& s) { return std::string_view(s.name) == "tick profiler test phase"; });
+	REQUIRE(it != summaries.end());
+	REQUIRE(it->count == 100);
+	REQUIRE(it->p50 == 51);
+	REQUIRE(it->p99 == 100);
+	REQUIRE(it->max == 100);
+
+	tick_profile::reset();
+	summaries = tick_profile::summarize();
+	REQUIRE(std::find_if(summaries.begin(), summaries.end(), [](auto& s) { return std::string_view(s.name) == "tick profiler test phase"; }) == summaries.end());
+}
+
+TEST_CASE("trigger profiler tests", "[misc_tests]") {
+	trigger_profile::reset();
+	dcon::trigger_key cheap{ dcon::trigger_key::value_base_t(10) };
+	dcon::trigger_key expensive{ dcon::trigger_key::value_base_t(20) };
+
+	for(uint32_t i = 0; i < 8; ++i) {
+		trigger_profile::record_call(cheap);
+	}
+	trigger_profile::record_sample(cheap, 2000);
+	trigger_profile::record_call(expensive);
+	trigger_profile::record_call(expensive);
+	trigger_profile::record_sample(expensive, 3000);
+	trigger_profile::record_sample(expensive, 5000);
+
+	auto summaries = trigger_profile::summarize();
+	REQUIRE(summaries.size() == 2);
+	REQUIRE(summaries[0].key == cheap); // 8 calls of 2us outweigh 2 calls of 4us
+	REQUIRE(summaries[0].calls == 8);
+	REQUIRE(summaries[0].estimated_total_ms == Approx(0.016));
+	REQUIRE(summaries[1].key == expensive);
+	REQUIRE(summaries[1].mean_us == Approx(4.0));
+	REQUIRE(summaries[1].estimated_total_ms == Approx(0.008));
+
+	// a trigger with the same total as another is listed after it if its key comes later
+	dcon::trigger_key same{ dcon::trigger_key::value_base_t(5) };
+	trigger_profile::record_call(same);
+	trigger_profile::record_call(same);
+	trigger_profile::record_sample(same, 4000);
+	summaries = trigger_profile::summarize();
+	REQUIRE(summaries.size() == 3);
+	REQUIRE(summaries[1].key == same);
+	REQUIRE(summaries[2].key == expensive);
+
+	uint32_t sampled = 0;
+	for(uint32_t i = 0; i < trigger_profile::sample_interval * 4; ++i) {
+		if(trigger_profile::should_sample())
+			++sampled;
+	}
+	REQUIRE(sampled == 4);
+
+	trigger_profile::reset();
+	REQUIRE(trigger_profile::summarize().empty());
+}
+
+TEST_CASE("compressed section tests", "[misc_tests]") {
+	std::vector<uint8_t> data(1 << 20);
+	for(size_t i = 0; i < data.size(); ++i)
+		data[i] = uint8_t((i * 7) ^ (i >> 9));
+
+	sys::compression_parameters settings[] = {
+		sys::compression_parameters{ 0, 0, false },
+		sys::compression_parameters{ 3, 2, false },
+		sys::compression_parameters{ 19, 2, true, 0 },
+		sys::compression_parameters{ 3, 2, false, 100000 }, // chunked, with a short last chunk
+	};
+	for(auto& params : settings) {
+		std::vector<uint8_t> compressed(sys::compressed_section_bound(uint32_t(data.size()), params));
+		auto end = sys::write_compressed_section(compressed.data(), data.data(), uint32_t(data.size()), params);
+
+		uint8_t const* decompressed = nullptr;
+		uint32_t length = 0;
+		REQUIRE(sys::decompress_section(compressed.data(), decompressed, length) == end);
+		REQUIRE(sys::skip_compressed_section(compressed.data()) == end);
+		REQUIRE(length == data.size());
+		REQUIRE(std::memcmp(decompressed, data.data(), data.size()) == 0);
+	}
+}
+
+TEST_CASE("save delta tests", "[misc_tests]") {
+	std::vector<uint8_t> reference(1 << 16);
+	for(size_t i = 0; i < reference.size(); ++i)
+		reference[i] = uint8_t((i * 13) ^ (i >> 7));
+
+	std::vector<uint8_t> delta;
+	std::vector<uint8_t> rebuilt;
+
+	// identical: everything lines up with the reference and the payload is all zeros
+	REQUIRE(sys::write_save_delta(delta, reference.data(), reference.size(), reference.size(), reference.data(), reference.size(), reference.size()) == 0);
+	REQUIRE(std::all_of(delta.end() - reference.size(), delta.end(), [](uint8_t b) { return b == 0; }));
+	REQUIRE(sys::apply_save_delta(rebuilt, delta.data(), delta.size(), reference.data(), reference.size()));
+	REQUIRE(rebuilt == reference);
+
+	// a few changed bytes
+	auto changed = reference;
+	changed[5] ^= 0x10;
+	changed[40000] = 0;
+	REQUIRE(sys::write_save_delta(delta, changed.data(), changed.size(), changed.size(), reference.data(), reference.size(), reference.size()) == 0);
+	REQUIRE(sys::apply_save_delta(rebuilt, delta.data(), delta.size(), reference.data(), reference.size()));
+	REQUIRE(rebuilt == changed);
+
+	// a different length can't be matched, but still comes back intact
+	changed.resize(changed.size() + 100, uint8_t(7));
+	REQUIRE(sys::write_save_delta(delta, changed.data(), changed.size(), changed.size(), reference.data(), reference.size(), reference.size()) == changed.size());
+	REQUIRE(sys::apply_save_delta(rebuilt, delta.data(), delta.size(), reference.data(), reference.size()));
+	REQUIRE(rebuilt == changed);
+
+	// truncated deltas and missing references are rejected
+	REQUIRE(!sys::apply_save_delta(rebuilt, delta.data(), delta.size() - 1, reference.data(), reference.size()));
+	sys::write_save_delta(delta, reference.data(), reference.size(), reference.size(), reference.data(), reference.size(), reference.size());
+	REQUIRE(!sys::apply_save_delta(rebuilt, delta.data(), delta.size(), reference.data(), reference.size() / 2));
+}
+
+TEST_CASE("stored section tests", "[misc_tests]") {
+	std::vector<uint8_t> data(100000);
+	for(size_t i = 0; i < data.size(); ++i)
+		data[i] = uint8_t(i * 31);
+
+	std::vector<uint8_t> file(data.size() + sys::stored_section_alignment * 2);
+	auto start = sys::write_compressed_section(file.data() + 10, data.data(), 16, sys::compression_parameters{});
+	auto end = sys::write_stored_section(start, file.data(), data.data(), uint32_t(data.size()));
+	REQUIRE(sys::skip_compressed_section(start) == end);
+
+	// read in place, from the page boundary
+	uint8_t const* section = nullptr;
+	uint32_t length = 0;
+	REQUIRE(sys::decompress_section(start, section, length) == end);
+	REQUIRE(length == data.size());
+	REQUIRE(section + length == end);
+	REQUIRE(size_t(section - file.data()) % sys::stored_section_alignment == 0);
+	REQUIRE(std::memcmp(section, data.data(), data.size()) == 0);
+}
+
+TEST_CASE("network frame tests", "[misc_tests]") {
+	// a tick's worth of commands, batched into one frame
+	std::vector<char> stream;
+	for(uint32_t i = 0; i < 100; ++i) {
+		command::payload c;
+		memset(&c, 0, sizeof(c));
+		c.type = command::command_type::advance_tick;
+		c.data.advance_tick.speed = int32_t(i % 5);
+		stream.insert(stream.end(), reinterpret_cast<char const*>(&c), reinterpret_cast<char const*>(&c) + sizeof(c));
+	}
+	// and a stream larger than a frame
+	stream.resize(stream.size() + network::max_frame_payload * 2, 'x');
+
+	std::vector<char> wire;
+	network::append_frames(wire, stream.data(), stream.size());
+	REQUIRE(wire.size() < stream.size() / 10);
+
+	// arriving in small pieces, as it would from a socket
+	std::vector<char> received;
+	std::vector<char> decoded;
+	for(size_t offset = 0; offset < wire.size(); offset += 1000) {
+		received.insert(received.end(), wire.begin() + offset, wire.begin() + std::min(offset + 1000, wire.size()));
+		REQUIRE(network::decode_frames(received, decoded));
+	}
+	REQUIRE(received.empty());
+	REQUIRE(decoded == stream);
+
+	// anything that isn't a frame of the expected kind is rejected
+	std::vector<char> bad(16, char(0xFF));
+	REQUIRE(!network::decode_frames(bad, decoded));
+	std::vector<char> stored(16, 0);
+	REQUIRE(!network::decode_frames(stored, decoded));
+}
+
+TEST_CASE("network wire preamble tests", "[misc_tests]") {
+	std::vector<char> frame_data(64, 'x');
+	std::vector<char> wire;
+	network::append_wire_preamble(wire);
+	network::append_frames(wire, frame_data.data(), frame_data.size());
+
+	// nothing is decided until the whole preamble is there
+	std::vector<char> received(wire.begin(), wire.begin() + network::wire_preamble_size - 1);
+	REQUIRE(network::read_wire_preamble(received) == network::preamble_status::incomplete);
+	received.insert(received.end(), wire.begin() + network::wire_preamble_size - 1, wire.end());
+	REQUIRE(network::read_wire_preamble(received) == network::preamble_status::accepted);
+	std::vector<char> decoded;
+	REQUIRE(network::decode_frames(received, decoded));
+	REQUIRE(decoded == frame_data);
+
+	// a peer from another version, or something that isn't a peer at all
+	std::vector<char> other_version = wire;
+	uint32_t version = network::wire_format_version + 1;
+	memcpy(other_version.data() + sizeof(uint32_t), &version, sizeof(version));
+	REQUIRE(network::read_wire_preamble(other_version) == network::preamble_status::rejected);
+	std::vector<char> frames_only;
+	network::append_frames(frames_only, frame_data.data(), frame_data.size());
+	REQUIRE(network::read_wire_preamble(frames_only) == network::preamble_status::rejected);
+}
@@ -6,8 +6,15 @@
 #define DCON_TRAP_INVALID_STORE 1
 #endif
 
+// the tests always build in the triggers compiled from the bytecode of the "compiled triggers" test case
+#ifdef ALICE_COMPILED_TRIGGERS
+#undef ALICE_COMPILED_TRIGGERS
+#endif
+#define ALICE_COMPILED_TRIGGERS "compiled_triggers_fixture.hpp"
+
 #define ALICE_NO_ENTRY_POINT 1
 #include "main.cpp"
+#include "script_inspection.cpp"
 
 #define RANGE(x) (x), (x) + ((sizeof(x)) / sizeof((x)[0])) - 1
 #define RANGE_SZ(x) (x), ((sizeof(x)) / sizeof((x)[0])) - 1
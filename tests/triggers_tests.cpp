@@ -433,6 +433,59 @@ TEST_CASE("and folding", "[trigger_tests]") {
 	}
 }
 
+TEST_CASE("trigger optimization", "[trigger_tests]") {
+	{ // flattening, constant removal, deduplication and ordering by cost
+		std::vector<uint16_t> t;
+		t.push_back(uint16_t(trigger::generic_scope));
+		t.push_back(uint16_t(10));
+		t.push_back(uint16_t(trigger::x_neighbor_province_scope));
+		t.push_back(uint16_t(2));
+		t.push_back(uint16_t(trigger::no_payload | trigger::association_eq | trigger::blockade));
+		t.push_back(uint16_t(trigger::no_payload | trigger::association_eq | trigger::always));
+		t.push_back(uint16_t(trigger::no_payload | trigger::association_eq | trigger::blockade));
+		t.push_back(uint16_t(trigger::generic_scope));
+		t.push_back(uint16_t(2));
+		t.push_back(uint16_t(trigger::no_payload | trigger::association_eq | trigger::is_slave_nation));
+		t.push_back(uint16_t(trigger::no_payload | trigger::association_eq | trigger::blockade));
+
+		const auto new_size = parsers::optimize_trigger(t.data());
+
+		REQUIRE(7 == new_size);
+		REQUIRE(t[0] == uint16_t(trigger::generic_scope));
+		REQUIRE(t[1] == uint16_t(6));
+		REQUIRE(t[2] == uint16_t(trigger::no_payload | trigger::association_eq | trigger::blockade));
+		REQUIRE(t[3] == uint16_t(trigger::no_payload | trigger::association_eq | trigger::is_slave_nation));
+		REQUIRE(t[4] == uint16_t(trigger::x_neighbor_province_scope));
+		REQUIRE(t[5] == uint16_t(2));
+		REQUIRE(t[6] == uint16_t(trigger::no_payload | trigger::association_eq | trigger::blockade));
+	}
+	{ // a true member decides a disjunction
+		std::vector<uint16_t> t;
+		t.push_back(uint16_t(trigger::generic_scope | trigger::is_disjunctive_scope));
+		t.push_back(uint16_t(3));
+		t.push_back(uint16_t(trigger::no_payload | trigger::association_eq | trigger::blockade));
+		t.push_back(uint16_t(trigger::no_payload | trigger::association_eq | trigger::always));
+
+		const auto new_size = parsers::optimize_trigger(t.data());
+
+		REQUIRE(1 == new_size);
+		REQUIRE(t[0] == uint16_t(trigger::no_payload | trigger::association_eq | trigger::always));
+	}
+	{ // a false member decides a conjunction, but not whether there is anything in an iterated scope
+		std::vector<uint16_t> t;
+		t.push_back(uint16_t(trigger::x_neighbor_province_scope | trigger::is_existence_scope));
+		t.push_back(uint16_t(3));
+		t.push_back(uint16_t(trigger::no_payload | trigger::association_eq | trigger::blockade));
+		t.push_back(uint16_t(trigger::no_payload | trigger::association_ne | trigger::always));
+
+		const auto new_size = parsers::optimize_trigger(t.data());
+
+		REQUIRE(3 == new_size);
+		REQUIRE(t[1] == uint16_t(2));
+		REQUIRE(t[2] == uint16_t(trigger::no_payload | trigger::association_ne | trigger::always));
+	}
+}
+
 TEST_CASE("effect scope absorbsion", "[effect_tests]") {
 	{
 		std::vector<uint16_t> t;
@@ -840,3 +893,412 @@ TEST_CASE("trigger payload translation", "[trigger_tests]") {
 		REQUIRE(new_d == dcon::nation_id{42});
 	}
 }
+
+TEST_CASE("bytecode interning", "[trigger_tests]") {
+	std::unique_ptr<sys::state> state = std::make_unique<sys::state>();
+
+	std::vector<uint16_t> a{ uint16_t(trigger::no_payload | trigger::association_eq | trigger::blockade) };
+	std::vector<uint16_t> b{ uint16_t(trigger::generic_scope), uint16_t(2), uint16_t(trigger::no_payload | trigger::association_eq | trigger::blockade) };
+
+	auto ka = state->commit_trigger_data(a);
+	auto kb = state->commit_trigger_data(b);
+	REQUIRE(ka != kb);
+	REQUIRE(state->commit_trigger_data(a) == ka);
+	REQUIRE(state->commit_trigger_data(b) == kb);
+	REQUIRE(state->commit_trigger_data(std::vector<uint16_t>{}) == dcon::trigger_key{});
+	// nothing is stored twice
+	REQUIRE(state->trigger_data.size() == 1 + a.size() + b.size());
+	REQUIRE(std::equal(a.begin(), a.end(), state->trigger_data.data() + state->trigger_data_indices[ka.index() + 1]));
+	REQUIRE(std::equal(b.begin(), b.end(), state->trigger_data.data() + state->trigger_data_indices[kb.index() + 1]));
+
+	std::vector<uint16_t> e{ uint16_t(effect::is_slave_state_yes | effect::no_payload) };
+	auto ke = state->commit_effect_data(e);
+	REQUIRE(state->commit_effect_data(e) == ke);
+	REQUIRE(state->effect_data.size() == 1 + e.size());
+}
+
+TEST_CASE("memoized trigger evaluation", "[trigger_tests]") {
+	auto ws = load_testing_scenario_file();
+	uint32_t const nation_count = std::min(ws->world.nation_size(), uint32_t(32));
+
+	std::vector<bool> expected;
+	for(auto e : ws->world.in_free_national_event) {
+		if(auto t = e.get_trigger(); t) {
+			for(uint32_t i = 0; i < nation_count; ++i) {
+				auto n = trigger::to_generic(dcon::nation_id{ dcon::nation_id::value_base_t(i) });
+				expected.push_back(trigger::evaluate(*ws, t, n, n, 0));
+			}
+		}
+	}
+
+	{
+		trigger::memoization_window memo{ *ws };
+		REQUIRE(ws->trigger_memo_open);
+		for(int32_t pass = 0; pass < 2; ++pass) { // the second pass is answered from the remembered results
+			size_t index = 0;
+			for(auto e : ws->world.in_free_national_event) {
+				if(auto t = e.get_trigger(); t) {
+					ve::contiguous_tags<int32_t> ids(0);
+					auto bulk = trigger::evaluate(*ws, t, ids, ids, 0);
+					ve::apply([&](bool v, int32_t n) {
+						if(uint32_t(n) < nation_count)
+							REQUIRE(v == expected[index + n]);
+					}, bulk, ids);
+					for(uint32_t i = 0; i < nation_count; ++i) {
+						auto n = trigger::to_generic(dcon::nation_id{ dcon::nation_id::value_base_t(i) });
+						REQUIRE(trigger::evaluate(*ws, t, n, n, 0) == expected[index + i]);
+					}
+					index += nation_count;
+				}
+			}
+		}
+	}
+	REQUIRE(!ws->trigger_memo_open);
+
+	// a limit depending on the treasury, tested inside an iterating scope so that it can be memoized
+	dcon::nation_id n;
+	for(auto o : ws->world.in_nation) {
+		if(o.get_owned_province_count() != 0) {
+			n = o;
+			break;
+		}
+	}
+	REQUIRE(bool(n));
+	auto const threshold = ws->world.nation_get_stockpiles(n, economy::money) + 1000.0f;
+	auto const add_float = [](std::vector<uint16_t>& data, float v) {
+		uint16_t words[2];
+		std::memcpy(words, &v, sizeof(v));
+		data.push_back(words[0]);
+		data.push_back(words[1]);
+	};
+	ws->trigger_data_indices.push_back(int32_t(ws->trigger_data.size()));
+	dcon::trigger_key limit{ dcon::trigger_key::value_base_t(ws->trigger_data_indices.size() - 2) };
+	ws->trigger_data.push_back(uint16_t(trigger::x_owned_province_scope_nation | trigger::is_existence_scope));
+	ws->trigger_data.push_back(4);
+	ws->trigger_data.push_back(uint16_t(trigger::money_province | trigger::association_ge));
+	add_float(ws->trigger_data, threshold);
+
+	auto const g = trigger::to_generic(n);
+	{
+		trigger::memoization_window memo{ *ws };
+		REQUIRE(!trigger::evaluate(*ws, limit, g, g, 0));
+		ws->world.nation_set_stockpiles(n, economy::money, threshold + 1.0f);
+		trigger::discard_memoized_results(*ws); // as executing an effect or command does
+		REQUIRE(trigger::evaluate(*ws, limit, g, g, 0));
+		ws->world.nation_set_stockpiles(n, economy::money, threshold - 1000.0f);
+		trigger::discard_memoized_results(*ws);
+		REQUIRE(!trigger::evaluate(*ws, limit, g, g, 0));
+
+		// an effect that tests the limit, raises the treasury past it, and tests it again must see the change
+		std::vector<uint16_t> e;
+		e.push_back(effect::generic_scope);
+		e.push_back(0);
+		e.push_back(uint16_t(effect::if_scope | effect::scope_has_limit));
+		e.push_back(5);
+		e.push_back(trigger::payload(limit).value);
+		e.push_back(effect::prestige);
+		add_float(e, 1.0f);
+		e.push_back(effect::treasury);
+		add_float(e, 2000.0f);
+		e.push_back(uint16_t(effect::if_scope | effect::scope_has_limit));
+		e.push_back(5);
+		e.push_back(trigger::payload(limit).value);
+		e.push_back(effect::prestige);
+		add_float(e, 1.0f);
+		e[1] = uint16_t(e.size() - 1);
+
+		auto const prestige = ws->world.nation_get_prestige(n);
+		REQUIRE(!trigger::evaluate(*ws, limit, g, g, 0)); // remembered as false before the effect runs
+		effect::execute(*ws, e.data(), g, g, 0, 0, 0);
+		REQUIRE(ws->world.nation_get_stockpiles(n, economy::money) >= threshold);
+		REQUIRE(ws->world.nation_get_prestige(n) > prestige); // only the second limit holds
+	}
+	ws->trigger_data.resize(ws->trigger_data_indices.back());
+	ws->trigger_data_indices.pop_back();
+}
+
+TEST_CASE("compiled triggers", "[trigger_tests]") {
+	auto ws = load_testing_scenario_file();
+	trigger::enable_compiled_triggers(*ws);
+
+	auto source = trigger::compile_to_cpp(*ws);
+	auto const count = int32_t(ws->trigger_data_indices.size() - 1);
+	REQUIRE(source.find("compiled_triggers_count = " + std::to_string(count) + ";") != std::string::npos);
+	REQUIRE(source.find("COMPILED_TRIGGER_ENTRY(" + std::to_string(count - 1) + ")") != std::string::npos);
+	REQUIRE(source.find("COMPILED_TRIGGER_ENTRY(" + std::to_string(count) + ")") == std::string::npos);
+
+	// evaluating by key uses the compiled triggers when they were built in from this scenario, while evaluating the bytecode
+	// directly always goes through the interpreter
+	uint32_t const nation_count = std::min(ws->world.nation_size(), uint32_t(64));
+	auto compare_for_nations = [&](dcon::trigger_key t) {
+		if(!t)
+			return;
+		auto data = ws->trigger_data.data() + ws->trigger_data_indices[t.index() + 1];
+		for(uint32_t i = 0; i < nation_count; ++i) {
+			auto n = trigger::to_generic(dcon::nation_id{ dcon::nation_id::value_base_t(i) });
+			REQUIRE(trigger::evaluate(*ws, t, n, n, 0) == trigger::evaluate(*ws, data, n, n, 0));
+		}
+		ve::contiguous_tags<int32_t> ids(0);
+		auto by_key = ve::compress_mask(trigger::evaluate(*ws, t, ids, ids, 0));
+		auto interpreted = ve::compress_mask(trigger::evaluate(*ws, data, ids, ids, 0));
+		REQUIRE(by_key.v == interpreted.v);
+	};
+	for(auto e : ws->world.in_free_national_event) {
+		compare_for_nations(e.get_trigger());
+	}
+	for(auto d : ws->world.in_decision) {
+		compare_for_nations(d.get_potential());
+		compare_for_nations(d.get_allow());
+	}
+
+	uint32_t const province_count = std::min(uint32_t(ws->province_definitions.first_sea_province.index()), uint32_t(64));
+	for(auto e : ws->world.in_free_provincial_event) {
+		auto t = e.get_trigger();
+		if(!t)
+			continue;
+		auto data = ws->trigger_data.data() + ws->trigger_data_indices[t.index() + 1];
+		for(uint32_t i = 0; i < province_count; ++i) {
+			auto p = trigger::to_generic(dcon::province_id{ dcon::province_id::value_base_t(i) });
+			REQUIRE(trigger::evaluate(*ws, t, p, p, 0) == trigger::evaluate(*ws, data, p, p, 0));
+		}
+	}
+}
+
+TEST_CASE("compiled trigger fixture", "[trigger_tests]") {
+	auto ws = load_testing_scenario_file();
+	trigger::enable_compiled_triggers(*ws);
+	REQUIRE(!ws->compiled_triggers_active); // the tests build in triggers compiled from other bytecode than the scenario's
+
+	// the bytecode that tests/compiled_triggers_fixture.hpp was generated from
+	auto const add_float = [](std::vector<uint16_t>& data, float v) {
+		uint16_t words[2];
+		std::memcpy(words, &v, sizeof(v));
+		data.push_back(words[0]);
+		data.push_back(words[1]);
+	};
+	std::vector<uint16_t> d;
+	std::vector<int32_t> indices;
+	indices.push_back(0);
+	d.push_back(0);
+	// civilized and prestigious
+	indices.push_back(int32_t(d.size()));
+	d.push_back(trigger::generic_scope);
+	d.push_back(5);
+	d.push_back(uint16_t(trigger::civilized_nation | trigger::association_eq));
+	d.push_back(uint16_t(trigger::prestige_value | trigger::association_ge));
+	add_float(d, 5.0f);
+	// a great power, or uncivilized and populous
+	indices.push_back(int32_t(d.size()));
+	d.push_back(uint16_t(trigger::generic_scope | trigger::is_disjunctive_scope));
+	d.push_back(8);
+	d.push_back(uint16_t(trigger::is_greater_power_nation | trigger::association_eq));
+	d.push_back(trigger::generic_scope);
+	d.push_back(5);
+	d.push_back(uint16_t(trigger::civilized_nation | trigger::association_ne));
+	d.push_back(uint16_t(trigger::total_pops_nation | trigger::association_ge));
+	add_float(d, 1000000.0f);
+	// some literate province, left to the interpreter, and civilized
+	indices.push_back(int32_t(d.size()));
+	d.push_back(trigger::generic_scope);
+	d.push_back(7);
+	d.push_back(uint16_t(trigger::x_owned_province_scope_nation | trigger::is_existence_scope));
+	d.push_back(4);
+	d.push_back(uint16_t(trigger::literacy_province | trigger::association_ge));
+	add_float(d, 0.3f);
+	d.push_back(uint16_t(trigger::civilized_nation | trigger::association_eq));
+	// a great power, as a single leaf
+	indices.push_back(int32_t(d.size()));
+	d.push_back(uint16_t(trigger::is_greater_power_nation | trigger::association_eq));
+
+	ws->trigger_data = d;
+	ws->trigger_data_indices = indices;
+	trigger::enable_compiled_triggers(*ws);
+	REQUIRE(ws->compiled_triggers_active);
+
+	// the fixture is still what the compiler generates from this bytecode
+	simple_fs::file_system fs;
+	add_root(fs, NATIVE_M(PROJECT_ROOT) NATIVE_SEP NATIVE("tests"));
+	auto fixture_file = open_file(get_root(fs), NATIVE("compiled_triggers_fixture.hpp"));
+	REQUIRE(bool(fixture_file));
+	auto content = view_contents(*fixture_file);
+	std::string fixture;
+	for(uint32_t i = 0; i < content.file_size; ++i) {
+		if(content.data[i] != '\r')
+			fixture.push_back(content.data[i]);
+	}
+	REQUIRE(trigger::compile_to_cpp(*ws) == fixture);
+
+	// evaluating by key now goes through the compiled functions, evaluating the bytecode still through the interpreter
+	for(int32_t k = 0; k < int32_t(indices.size() - 1); ++k) {
+		dcon::trigger_key t{ dcon::trigger_key::value_base_t(k) };
+		auto data = ws->trigger_data.data() + ws->trigger_data_indices[k + 1];
+		for(auto n : ws->world.in_nation) {
+			auto g = trigger::to_generic(n.id);
+			REQUIRE(trigger::evaluate(*ws, t, g, g, 0) == trigger::evaluate(*ws, data, g, g, 0));
+		}
+		for(uint32_t i = 0; i < ws->world.nation_size(); i += ve::vector_size) {
+			ve::contiguous_tags<int32_t> ids(i);
+			auto compiled = ve::compress_mask(trigger::evaluate(*ws, t, ids, ids, 0));
+			auto interpreted = ve::compress_mask(trigger::evaluate(*ws, data, ids, ids, 0));
+			REQUIRE(compiled.v == interpreted.v);
+		}
+	}
+}
+
+TEST_CASE("batched value modifiers", "[trigger_tests]") {
+	auto ws = load_testing_scenario_file();
+	uint32_t const nation_count = ws->world.nation_size();
+
+	std::vector<float> bulk;
+	for(auto e : ws->world.in_free_national_event) {
+		auto mod = e.get_mtth();
+		if(!mod)
+			continue;
+		auto t = e.get_trigger();
+
+		trigger::evaluate_multiplicative_modifier(*ws, mod, t, nation_count, bulk);
+		REQUIRE(bulk.size() == nation_count);
+
+		for(uint32_t i = 0; i + ve::vector_size <= nation_count; i += ve::vector_size) {
+			ve::contiguous_tags<int32_t> ids(int32_t(i));
+			auto active = t ? trigger::evaluate(*ws, t, ids, ids, 0) : ve::mask_vector(true);
+			auto all_lanes = trigger::evaluate_multiplicative_modifier(*ws, mod, ids, ids, 0);
+			auto active_lanes = trigger::evaluate_multiplicative_modifier(*ws, mod, ids, ids, 0, active);
+
+			ve::apply([&](int32_t n, float v_all, float v_active, bool a) {
+				auto single = trigger::evaluate_multiplicative_modifier(*ws, mod, n, n, 0);
+				REQUIRE(v_all == single);
+				if(a) {
+					REQUIRE(v_active == single);
+					REQUIRE(bulk[n] == single);
+				} else {
+					REQUIRE(bulk[n] == 0.0f);
+				}
+			}, ids, all_lanes, active_lanes, active);
+		}
+	}
+}
+
+TEST_CASE("free event candidate gates", "[trigger_tests]") {
+	{
+		uint16_t const data[] = { 0, trigger::generic_scope, 7, uint16_t(trigger::year | trigger::association_ge), 1840,
+			uint16_t(trigger::has_country_flag | trigger::association_eq), 3, uint16_t(trigger::tag_tag | trigger::association_eq), 7 };
+		auto gate = event::extract_candidate_gate(data, 1, false);
+		REQUIRE(gate.type == event::candidate_type::identity_holder);
+		REQUIRE(gate.value == 7);
+		REQUIRE(gate.global_conditions[0] == 3);
+		REQUIRE(gate.global_conditions[1] == 0);
+	}
+	{
+		uint16_t const data[] = { 0, trigger::generic_scope, 5, uint16_t(trigger::has_country_flag | trigger::association_eq), 3,
+			uint16_t(trigger::tag_tag | trigger::association_ne), 7 };
+		auto gate = event::extract_candidate_gate(data, 1, false);
+		REQUIRE(gate.type == event::candidate_type::country_flag);
+		REQUIRE(gate.value == 3);
+	}
+	{
+		uint16_t const data[] = { 0, uint16_t(trigger::generic_scope | trigger::is_disjunctive_scope), 5,
+			uint16_t(trigger::year | trigger::association_ge), 1840, uint16_t(trigger::tag_tag | trigger::association_eq), 7 };
+		auto gate = event::extract_candidate_gate(data, 1, false);
+		REQUIRE(gate.type == event::candidate_type::all);
+		REQUIRE(gate.global_conditions[0] == 0);
+	}
+	{
+		uint16_t const data[] = { 0, trigger::generic_scope, 7, uint16_t(trigger::province_id | trigger::association_eq), 12,
+			trigger::owner_scope_province, 3, uint16_t(trigger::tag_tag | trigger::association_eq), 5 };
+		auto gate = event::extract_candidate_gate(data, 1, true);
+		REQUIRE(gate.type == event::candidate_type::province);
+		REQUIRE(gate.value == 12);
+		auto owner_only = event::extract_candidate_gate(data, 5, true);
+		REQUIRE(owner_only.type == event::candidate_type::provinces_of_holder);
+		REQUIRE(owner_only.value == 5);
+	}
+
+	// every nation for which the trigger of a gated event holds must be among its candidates
+	auto ws = load_testing_scenario_file();
+	for(auto e : ws->world.in_free_national_event) {
+		if(!e.get_trigger())
+			continue;
+		auto const gate = event::extract_candidate_gate(ws->trigger_data.data(), ws->trigger_data_indices[e.get_trigger().index() + 1], false);
+		if(gate.type != event::candidate_type::identity_holder && gate.type != event::candidate_type::country_flag)
+			continue;
+		for(auto n : ws->world.in_nation) {
+			if(!trigger::evaluate(*ws, e.get_trigger(), trigger::to_generic(n.id), trigger::to_generic(n.id), 0))
+				continue;
+			if(gate.type == event::candidate_type::identity_holder)
+				REQUIRE(n.get_identity_from_identity_holder().id == trigger::payload(gate.value).tag_id);
+			else
+				REQUIRE(ws->world.nation_get_flag_variables(n, trigger::payload(gate.value).natf_id));
+		}
+	}
+}
+
+TEST_CASE("free event schedule", "[trigger_tests]") {
+	auto ws = load_testing_scenario_file();
+	event::build_event_schedules(*ws);
+
+	// every event that can still fire is rolled for on exactly one day, the one update_events used to compute from its index
+	std::vector<int32_t> seen(ws->world.free_national_event_size(), 0);
+	for(int32_t d = 0; d < event::schedule_days; ++d) {
+		for(auto& s : ws->free_national_event_schedule.days[d]) {
+			dcon::free_national_event_id id{ dcon::free_national_event_id::value_base_t(s.id) };
+			REQUIRE(event::scheduled_day(s.id, ws->world.free_national_event_size()) == d);
+			REQUIRE(s.trigger == ws->world.free_national_event_get_trigger(id));
+			REQUIRE(s.mtth == ws->world.free_national_event_get_mtth(id));
+			++seen[s.id];
+		}
+	}
+	for(auto e : ws->world.in_free_national_event) {
+		REQUIRE(seen[e.id.index()] == (e.get_only_once() && e.get_has_been_triggered() ? 0 : 1));
+	}
+
+	REQUIRE(event::scheduled_day(5, 20) == event::schedule_days - 1);
+	REQUIRE(event::scheduled_day(0, 64) == 0);
+	REQUIRE(event::scheduled_day(63, 64) == 31);
+	REQUIRE(event::scheduled_day(64, 65) == 31);
+}
+
+TEST_CASE("script inspection", "[trigger_tests]") {
+	auto ws = load_testing_scenario_file();
+	script_inspection::scenario_sizes sizes;
+	sizes.provinces_per_nation = 10.0f;
+
+	{
+		uint16_t const data[] = { trigger::generic_scope, 9, uint16_t(trigger::year | trigger::association_ge), 1840,
+			trigger::x_owned_province_scope_nation, 5, uint16_t(trigger::year | trigger::association_ge), 1840,
+			uint16_t(trigger::year | trigger::association_lt), 1850 };
+		auto cost = script_inspection::estimate_trigger_cost(*ws, sizes, data);
+		REQUIRE(cost.evaluations == Approx(21.0));
+		REQUIRE(cost.iterating_scopes == 1);
+		REQUIRE(cost.deepest_nesting == 1);
+
+		auto listing = script_inspection::disassemble_trigger(*ws, data);
+		REQUIRE(listing == "and\n\tyear >= 1840\n\tx_owned_province_scope_nation\n\t\tyear >= 1840\n\t\tyear < 1850\n");
+	}
+	{
+		dcon::national_identity_id tag{ 0 };
+		uint16_t const data[] = { uint16_t(trigger::tag_tag | trigger::association_eq), trigger::payload(tag).value };
+		auto tag_name = nations::int_to_tag(ws->world.national_identity_get_identifying_int(tag));
+		REQUIRE(script_inspection::disassemble_trigger(*ws, data) == "tag_tag == " + tag_name + "\n");
+	}
+	{
+		// one quarter of the time the effect runs over every owned province
+		uint16_t const data[] = { effect::random_list_scope, 15, 100, 25, effect::x_owned_scope_nation, 7, effect::treasury, 0, 0,
+			effect::prestige, 0, 0, 75, effect::treasury, 0, 0 };
+		auto cost = script_inspection::estimate_effect_cost(*ws, sizes, data);
+		REQUIRE(cost.evaluations == Approx(5.75));
+		REQUIRE(cost.iterating_scopes == 1);
+		REQUIRE(!script_inspection::disassemble_effect(*ws, data).empty());
+	}
+
+	auto measured = script_inspection::measure_sizes(*ws);
+	REQUIRE(measured.provinces_per_nation >= 1.0f);
+	REQUIRE(measured.pops_per_province >= 1.0f);
+	auto effect_owners = script_inspection::effect_owners(*ws);
+	REQUIRE(effect_owners.size() + 1 == ws->effect_data_indices.size());
+	for(size_t i = 0; i + 1 < ws->trigger_data_indices.size(); ++i) {
+		auto data = ws->trigger_data.data() + ws->trigger_data_indices[i + 1];
+		REQUIRE(!script_inspection::disassemble_trigger(*ws, data).empty());
+		REQUIRE(script_inspection::estimate_trigger_cost(*ws, measured, data).evaluations >= 0.0);
+	}
+}